@@ -61,6 +61,11 @@
 #define configUSE_COUNTING_SEMAPHORES			1
 #define configUSE_ALTERNATIVE_API				0
 #define configUSE_QUEUE_SETS					1
+#define configUSE_QUEUE_TIMESTAMPS				1
+#define configUSE_QUEUE_SIZED_COPY				1
+#define configUSE_QUEUE_STATS					1
+#define configUSE_MULTI_PRODUCER_STREAM_BUFFERS	1
+#define configEVENT_GROUP_ISR_MAX_WAITERS		4
 #define configUSE_TASK_NOTIFICATIONS			1
 #define configSUPPORT_STATIC_ALLOCATION			1
 
@@ -69,9 +74,55 @@
 #define configTIMER_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
 #define configTIMER_QUEUE_LENGTH				20
 #define configTIMER_TASK_STACK_DEPTH			( configMINIMAL_STACK_SIZE * 2 )
+#define configUSE_TIMER_WHEEL					1
+#define configUSE_FAST_TIMERS					1
+#define configUSE_TIMER_SLACK					1
+#define configTIMER_COMMAND_BATCH_SIZE			8
 
 #define configMAX_PRIORITIES					( 7 )
 
+/* Kernel object pool configuration options. */
+#define configUSE_OBJECT_POOLS					1
+#define configTASK_POOL_LENGTH					8
+#define configSTACK_POOL_LENGTH					8
+#define configSTACK_POOL_DEPTH					configMINIMAL_STACK_SIZE
+#define configQUEUE_POOL_LENGTH					8
+#define configQUEUE_POOL_STORAGE_SIZE			16
+#define configTIMER_POOL_LENGTH					16
+#define configEVENT_GROUP_POOL_LENGTH			4
+
+/* Per task heap accounting configuration options. */
+#define configUSE_TASK_HEAP_ACCOUNTING			1
+#define configTASK_HEAP_ACCOUNTS				16
+#define configUSE_HEAP_QUOTA_HOOK				1
+
+/* Per task heap cache configuration options.  The cache is only implemented
+by heap_5.c, which the demo uses - set configUSE_HEAP_TASK_CACHE to 0 to build
+the demo with another heap, or to time the heap cache benchmark without it. */
+#define configUSE_HEAP_TASK_CACHE				1
+#define configHEAP_TASK_CACHE_DEPTH				8
+
+/* Arena configuration options. */
+#define configUSE_ARENAS						1
+
+/* Stack profiler configuration options.  main.c prints the peak stack use it
+finds.  Tasks in the Win32 port run on the stacks of Windows threads rather than
+the stacks the kernel allocates, so in this demo the figures only show the
+profiler working, not how much stack the tasks really need. */
+#define configUSE_STACK_PROFILER				1
+
+/* Deleted task reclamation configuration options. */
+#define configTASK_RECLAIM_BATCH_SIZE			4
+#define configTASK_RECYCLE_LENGTH				4
+
+/* Simulator stack checking configuration options.  When on, only a task that
+uses more than configWIN32_TASK_STACK_MULTIPLIER times the stack it was created
+with is trapped, so smaller overflows still go unnoticed.  Left off as the stack
+the demo tasks use with printf() has not been measured, so the multiplier that
+lets them run unreported is not known. */
+#define configWIN32_GUARDED_TASK_STACKS			0
+#define configWIN32_TASK_STACK_MULTIPLIER		4
+
 /* Run time stats gathering configuration options. */
 unsigned long ulGetRunTimeCounterValue( void ); /* Prototype of function that returns run time counter. */
 void vConfigureTimerForRunTimeStats( void );	/* Prototype of function that initialises the run time counter. */
@@ -79,6 +130,13 @@ void vConfigureTimerForRunTimeStats( void );	/* Prototype of function that initi
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
 
+/* Lets the heap cache benchmark in main_benchmark.c time how long the
+scheduler is kept suspended. */
+void vBenchmarkSchedulerSuspended( void );
+void vBenchmarkSchedulerResumed( void );
+#define traceTASK_SUSPEND_ALL()					vBenchmarkSchedulerSuspended()
+#define traceTASK_RESUME_ALL()					vBenchmarkSchedulerResumed()
+
 /* Co-routine related configuration options. */
 #define configUSE_CO_ROUTINES 					1
 #define configMAX_CO_ROUTINE_PRIORITIES			( 2 )
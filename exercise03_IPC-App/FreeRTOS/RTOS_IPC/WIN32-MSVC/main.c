@@ -46,6 +46,8 @@
 /* FreeRTOS kernel includes. */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "queue.h"
+#include "timers.h"
 
 /* This demo uses heap_5.c, and these constants define the sizes of the regions
 that make up the total heap.  heap_5 is only used for test and example purposes
@@ -56,17 +58,54 @@ choice.  See http://www.freertos.org/a00111.html for an explanation. */
 #define mainREGION_2_SIZE	29905
 #define mainREGION_3_SIZE	6407
 
+/* Set mainRUN_BENCHMARKS to 1 to run the kernel microbenchmarks defined in
+main_benchmark.c instead of the IPC exercise defined in main_exercise.c. */
+#define mainRUN_BENCHMARKS	0
+
+/* Set mainDUMP_QUEUE_STATS_ON_KEY_PRESS to 1 to print the occupancy and
+contention statistics of every registered queue each time a key is pressed.
+It is 0 by default as polling the keyboard with kbhit() from the idle task
+interferes with the run time behaviour. */
+#define mainDUMP_QUEUE_STATS_ON_KEY_PRESS	0
+
+/* The most stack words of each task the stack profiler checks each time the
+idle hook runs, when configUSE_STACK_PROFILER is 1.  The peak stack use of
+every task is printed from the idle hook every mainPRINT_STACK_USAGE_PERIOD_MS
+milliseconds - set it to 0 to stop the output.  Win32 port tasks run on Windows
+thread stacks, so here the figures only cover the few words the port writes to
+the stacks the kernel allocates. */
+#define mainSTACK_PROFILER_WORDS_PER_STEP	32
+#define mainPRINT_STACK_USAGE_PERIOD_MS		10000
+
+/* The memory of tasks that delete themselves is also reclaimed from a software
+timer callback every mainRECLAIM_PERIOD_MS milliseconds, at most
+mainRECLAIM_MAX_TASKS tasks at a time, so it is reclaimed even when busy tasks
+keep the idle task from running.  Set mainRECLAIM_PERIOD_MS to 0 to leave it to
+the idle task. */
+#define mainRECLAIM_PERIOD_MS				100
+#define mainRECLAIM_MAX_TASKS				4
+
 /*-----------------------------------------------------------*/
 
 extern void main_exercise( void );
+extern void main_benchmark( void );
+extern void ipcPrintSensorQueueResidence( void );
 
 static void  prvInitialiseHeap( void );
 
+/*
+ * Reclaims the memory of deleted tasks from the timer task.
+ */
+#if( mainRECLAIM_PERIOD_MS > 0 )
+	static void prvReclaimTimerCallback( TimerHandle_t xTimer );
+#endif
+
 /*
  * Prototypes for the standard FreeRTOS application hook (callback) functions
  * implemented within this file.  See http://www.freertos.org/a00016.html .
  */
 void vApplicationMallocFailedHook( void );
+void vApplicationHeapQuotaHook( size_t xWantedSize );
 void vApplicationIdleHook( void );
 void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName );
 void vApplicationTickHook( void );
@@ -91,12 +130,44 @@ int main( void )
 {
 	prvInitialiseHeap();
 
-	main_exercise();
+	#if( mainRECLAIM_PERIOD_MS > 0 )
+	{
+	TimerHandle_t xReclaimTimer;
+
+		xReclaimTimer = xTimerCreate( "Reclaim", pdMS_TO_TICKS( mainRECLAIM_PERIOD_MS ), pdTRUE, NULL, prvReclaimTimerCallback );
+		configASSERT( xReclaimTimer );
+		xTimerStart( xReclaimTimer, 0 );
+	}
+	#endif
+
+	#if( mainRUN_BENCHMARKS == 1 )
+	{
+		main_benchmark();
+	}
+	#else
+	{
+		main_exercise();
+	}
+	#endif
 
 	return 0;
 }
 /*-----------------------------------------------------------*/
 
+#if( mainRECLAIM_PERIOD_MS > 0 )
+
+	static void prvReclaimTimerCallback( TimerHandle_t xTimer )
+	{
+		( void ) xTimer;
+
+		/* The timer task has the highest priority, so this runs even when the
+		idle task is starved. */
+		( void ) uxTaskReclaimDeletedTasks( mainRECLAIM_MAX_TASKS );
+	}
+
+#endif /* mainRECLAIM_PERIOD_MS */
+/*-----------------------------------------------------------*/
+
 void vApplicationMallocFailedHook( void )
 {
 	/* vApplicationMallocFailedHook() will only be called if
@@ -115,6 +186,19 @@ void vApplicationMallocFailedHook( void )
 }
 /*-----------------------------------------------------------*/
 
+void vApplicationHeapQuotaHook( size_t xWantedSize )
+{
+	/* vApplicationHeapQuotaHook() will only be called if
+	configUSE_HEAP_QUOTA_HOOK is set to 1 in FreeRTOSConfig.h.  It is called in
+	the context of a task whose call to pvPortMalloc() failed because it would
+	have taken the task over the quota set with xTaskSetHeapQuota().  Stop here,
+	so a task that leaks memory is caught before it starves the other tasks of
+	heap. */
+	printf( "%s exceeded its heap quota allocating %u bytes\r\n", pcTaskGetName( NULL ), ( unsigned ) xWantedSize );
+	vAssertCalled( __LINE__, __FILE__ );
+}
+/*-----------------------------------------------------------*/
+
 void vApplicationIdleHook( void )
 {
 	/* vApplicationIdleHook() will only be called if configUSE_IDLE_HOOK is set
@@ -127,6 +211,47 @@ void vApplicationIdleHook( void )
 	because it is the responsibility of the idle task to clean up memory
 	allocated by the kernel to any task that has since deleted itself. */
 
+	#if( mainDUMP_QUEUE_STATS_ON_KEY_PRESS == 1 )
+	{
+	/* Approximately 60 characters are written per registered queue. */
+	static char cQueueStats[ configQUEUE_REGISTRY_SIZE * 60 ];
+
+		if( _kbhit() != pdFALSE )
+		{
+			( void ) _getch();
+			vQueueListStats( cQueueStats );
+			printf( "Queue\t\tLen\tNow\tPeak\tSendBlk/TO\tRecvBlk/TO\tBlkTicks\r\n%s", cQueueStats );
+
+			/* The sensor queues are timestamped, so also print how long their
+			items waited to be received. */
+			ipcPrintSensorQueueResidence();
+		}
+	}
+	#endif
+
+	#if( configUSE_STACK_PROFILER == 1 )
+	{
+		/* Measure a little more of each task's stack use on every pass of the
+		idle task. */
+		vTaskStackProfilerStep( mainSTACK_PROFILER_WORDS_PER_STEP );
+
+		#if( mainPRINT_STACK_USAGE_PERIOD_MS > 0 )
+		{
+		static TickType_t xLastPrintTime = 0;
+		/* Approximately 40 characters are written per task. */
+		static char cStackUsage[ 40 * 40 ];
+
+			if( ( xTaskGetTickCount() - xLastPrintTime ) >= pdMS_TO_TICKS( mainPRINT_STACK_USAGE_PERIOD_MS ) )
+			{
+				xLastPrintTime = xTaskGetTickCount();
+				vTaskListStackUsage( cStackUsage );
+				printf( "Task\t\tDepth\tPeak\tFree\r\n%s", cStackUsage );
+			}
+		}
+		#endif
+	}
+	#endif
+
 	/* Uncomment the following code to allow the trace to be stopped with any
 	key press.  The code is commented out by default as the kbhit() function
 	interferes with the run time behaviour. */
@@ -150,10 +275,14 @@ void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName )
 	( void ) pxTask;
 
 	/* Run time stack overflow checking is performed if
-	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook
-	function is called if a stack overflow is detected.  This function is
-	provided as an example only as stack overflow checking does not function
-	when running the FreeRTOS Windows port. */
+	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2, which does not
+	function when running the FreeRTOS Windows port.  Instead, when
+	configWIN32_GUARDED_TASK_STACKS is 1 in FreeRTOSConfig.h, the port sizes
+	each task's thread stack at configWIN32_TASK_STACK_MULTIPLIER times the
+	stack the task was created with, and this hook function is called from the
+	thread that overflows it.  Only a task that uses more than
+	configWIN32_TASK_STACK_MULTIPLIER times the stack it was created with is
+	trapped - an overflow by less than that is not caught. */
 	vAssertCalled( __LINE__, __FILE__ );
 }
 /*-----------------------------------------------------------*/
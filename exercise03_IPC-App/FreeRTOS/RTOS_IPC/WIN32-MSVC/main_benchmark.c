@@ -0,0 +1,863 @@
+/******************************************************************************
+ * Kernel microbenchmarks.
+ *
+ * Set mainRUN_BENCHMARKS to 1 in main.c to run these instead of the IPC
+ * exercise.  A single task runs each benchmark in turn and prints the result,
+ * then the scheduler is left running the idle task.
+ *
+ * Times are measured with the processor's time stamp counter, so they are in
+ * CPU cycles.  The Windows port does not give FreeRTOS exclusive use of the
+ * CPU, so every benchmark repeats its measurement mainBENCHMARK_RUNS times
+ * and reports the fastest run, which is the one least disturbed by Windows.
+ *
+ * NOTE: Windows will not be running the FreeRTOS threads continuously, so the
+ * absolute numbers are only meaningful when compared against each other on the
+ * same machine.
+ ******************************************************************************/
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <intrin.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "event_groups.h"
+#include "semphr.h"
+#include "object_pools.h"
+#include "arena.h"
+
+/* The number of times each benchmark is repeated, and the number of
+operations timed in each repeat. */
+#define mainBENCHMARK_RUNS			20U
+#define mainBENCHMARK_ITERATIONS	2000U
+
+/* The largest queue item used by the queue copy benchmark. */
+#define mainMAX_ITEM_SIZE			16U
+
+/* The most timers used by the timer churn benchmark, and the number of
+commands sent to the timer service task each time it is allowed to run.  The
+timer periods are long enough that none expire during the benchmark. */
+#define mainMAX_CHURN_TIMERS		256U
+#define mainCHURN_BATCH_SIZE		configTIMER_QUEUE_LENGTH
+#define mainMIN_CHURN_PERIOD		pdMS_TO_TICKS( 60000UL )
+
+/* The number of timers reset by the timer burst benchmark. */
+#define mainBURST_TIMERS			16U
+
+/* The simulated interrupt used by the event group latency benchmark, the bit
+it sets, and the number of times the latency is measured.  Interrupt numbers 0
+to 2 are used by the kernel. */
+#define mainEVENT_INTERRUPT_NUMBER	3UL
+#define mainEVENT_BIT				( ( EventBits_t ) 0x01 )
+#define mainLATENCY_SAMPLES			500U
+
+/* The most blocks the heap stress benchmark keeps allocated at once.  Each run
+times mainHEAP_STRESS_OPERATIONS calls after first making the same number of
+untimed calls to fragment the heap.  The blocks allocated at any one time never
+total more than 1 / mainHEAP_STRESS_SHARE of the free heap, so no allocation is
+expected to fail. */
+#define mainMAX_HEAP_STRESS_SLOTS	256U
+#define mainHEAP_STRESS_OPERATIONS	4000U
+#define mainHEAP_STRESS_SHARE		2U
+
+/* The number of small blocks the heap cache benchmark allocates before freeing
+them all again, and the number of times it does so in each run. */
+#define mainHEAP_CACHE_BATCH		8U
+#define mainHEAP_CACHE_BATCHES		250U
+
+/* The number of kinds of object created and deleted by the object pool
+benchmark. */
+#define mainPOOLED_OBJECT_KINDS		4U
+
+/* The number of blocks the arena benchmark allocates before releasing them all,
+and the size of the arena they are allocated from. */
+#define mainARENA_BLOCKS			32U
+#define mainARENA_SIZE				4096U
+
+/* Priority and stack size of the task that runs the benchmarks. */
+#define mainBENCHMARK_TASK_PRIORITY	( tskIDLE_PRIORITY + 1 )
+#define mainBENCHMARK_STACK_SIZE	( configMINIMAL_STACK_SIZE * 4 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs every benchmark in xBenchmarks[].
+ */
+static void prvBenchmarkTask( void *pvParameters );
+
+/*
+ * Measures the cost of sending an item to a queue and receiving it back, for
+ * item sizes that do and do not have a dedicated copy path.  Build with
+ * configUSE_QUEUE_SIZED_COPY set to 0 and to 1 to see the saving per message.
+ */
+static void prvQueueCopyBenchmark( void );
+
+/*
+ * Measures the cost of resetting software timers while a growing number of
+ * timers are active, as happens when many watchdog or timeout timers are kicked
+ * repeatedly.  Build with configUSE_TIMER_WHEEL set to 0 and to 1 to compare
+ * the sorted timer lists with the timing wheel.
+ */
+static void prvTimerChurnBenchmark( void );
+
+/*
+ * Measures the cost of sending bursts of timer commands from a task that has a
+ * higher priority than the timer service task, so the commands queue up until
+ * the sender blocks or gives way, and reports the peak depth of the timer
+ * command queue and how often the sender blocked on it.  Build with
+ * configTIMER_COMMAND_BATCH_SIZE set to 1 and to a larger value to compare
+ * processing the commands one at a time with processing them in batches.
+ */
+static void prvTimerBurstBenchmark( void );
+
+/*
+ * Measures the time from a simulated interrupt calling
+ * xEventGroupSetBitsFromISR() to a task that was blocked on the event group
+ * running.  Build with configEVENT_GROUP_ISR_MAX_WAITERS set to 0, to defer
+ * setting the bits to the timer service task, and above 0, to set them and
+ * unblock the task directly from the interrupt.
+ */
+static void prvEventGroupLatencyBenchmark( void );
+
+/*
+ * The simulated interrupt handler and the waiting task used by
+ * prvEventGroupLatencyBenchmark().
+ */
+static uint32_t prvEventGroupInterruptHandler( void );
+static void prvEventGroupWaitingTask( void *pvParameters );
+
+/*
+ * Allocates and frees blocks of random sizes in a random order, and reports the
+ * distribution of the time taken by each pvPortMalloc() and vPortFree() call.
+ * The more blocks are allocated at once, the more free blocks the heap has to
+ * manage, so the run is repeated with an increasing number of blocks.  Build
+ * with heap_4.c, heap_5.c and heap_6.c in turn to compare them - heap_4.c does
+ * not provide vPortDefineHeapRegions(), so also remove the call to
+ * prvInitialiseHeap() from main.c when building with heap_4.c.
+ */
+static void prvHeapStressBenchmark( void );
+
+/*
+ * Repeatedly allocates a batch of small blocks, as a task building messages
+ * does, then frees them, and reports the distribution of the time taken by
+ * each pvPortMalloc() and vPortFree() call, and of the time each call kept the
+ * scheduler suspended, along with how many of the blocks were taken from or
+ * returned to the heap itself.  Build with configUSE_HEAP_TASK_CACHE set to 0
+ * and to 1 to compare using the heap for every call with using the task's heap
+ * cache - the cache is only implemented by heap_5.c.
+ */
+static void prvHeapCacheBenchmark( void );
+
+/*
+ * Measures the cost of creating and deleting semaphores, mutexes, queues and
+ * event groups, then prints the occupancy of each object pool.  Build with
+ * configUSE_OBJECT_POOLS set to 0 and to 1 to compare allocating the objects
+ * from the heap with allocating them from the pools.
+ */
+static void prvObjectPoolBenchmark( void );
+
+/*
+ * Measures the cost of allocating a set of small blocks then releasing them
+ * all, as a task does with the buffers it uses for one job, first with
+ * pvPortMalloc() and vPortFree() and then with pvArenaMalloc() and a single
+ * vArenaReset().  Only runs when configUSE_ARENAS is 1.
+ */
+static void prvArenaBenchmark( void );
+
+/*
+ * Returns the size of the next block allocated by prvHeapStressBenchmark().
+ * Most are the size of small kernel objects, some the size of larger objects
+ * such as queue storage, and a few the size of task stacks.
+ */
+static size_t prvHeapStressBlockSize( void );
+
+/*
+ * Sorts the ulCount times in pulCycles and prints their distribution.
+ */
+static void prvPrintDistribution( const char *pcName, uint32_t *pulCycles, uint32_t ulCount );
+static int prvCompareCycles( const void *pvFirst, const void *pvSecond );
+
+/*
+ * The callback used by the timers in prvTimerChurnBenchmark() and
+ * prvTimerBurstBenchmark().  It is never expected to run.
+ */
+static void prvChurnTimerCallback( TimerHandle_t xTimer );
+
+/*-----------------------------------------------------------*/
+
+/* The benchmarks run by prvBenchmarkTask(), in order. */
+static void ( * const xBenchmarks[] )( void ) =
+{
+	prvQueueCopyBenchmark,
+	prvTimerChurnBenchmark,
+	prvTimerBurstBenchmark,
+	prvEventGroupLatencyBenchmark,
+	prvHeapStressBenchmark,
+	prvHeapCacheBenchmark,
+	prvObjectPoolBenchmark,
+	prvArenaBenchmark
+};
+
+/* Shared between prvEventGroupLatencyBenchmark(), the interrupt handler and the
+waiting task. */
+static EventGroupHandle_t xLatencyEventGroup = NULL;
+static volatile unsigned __int64 ullInterruptTime = 0;
+static unsigned __int64 ullFastestLatency, ullTotalLatency;
+
+/* The state of the pseudo random number generator used by
+prvHeapStressBenchmark(), which is seeded the same way every time so every heap
+implementation is given the same sequence of calls. */
+static uint32_t ulHeapStressRandom = 0;
+
+/* The time the scheduler has spent suspended since ulSuspendedCycles was last
+zeroed, measured by the traceTASK_SUSPEND_ALL() and traceTASK_RESUME_ALL()
+macros defined in FreeRTOSConfig.h. */
+static unsigned __int64 ullSuspendedTime = 0;
+static volatile uint32_t ulSuspendedCycles = 0;
+
+/*-----------------------------------------------------------*/
+
+void main_benchmark( void )
+{
+	xTaskCreate( prvBenchmarkTask, "Benchmark", mainBENCHMARK_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+
+	vTaskStartScheduler();
+
+	/* Only reached if there was insufficient heap to start the scheduler. */
+	for( ;; );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void *pvParameters )
+{
+size_t xBenchmark;
+
+	( void ) pvParameters;
+
+	for( xBenchmark = 0; xBenchmark < ( sizeof( xBenchmarks ) / sizeof( xBenchmarks[ 0 ] ) ); xBenchmark++ )
+	{
+		xBenchmarks[ xBenchmark ]();
+	}
+
+	printf( "Benchmarks complete.\r\n" );
+	vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueCopyBenchmark( void )
+{
+static const UBaseType_t uxItemSizes[] = { 1U, 2U, 3U, 4U, 8U, 12U, 16U };
+uint8_t ucItem[ mainMAX_ITEM_SIZE ] = { 0 };
+QueueHandle_t xQueue;
+unsigned __int64 ullStart, ullCycles, ullFastest;
+size_t xSize;
+uint32_t ulRun, ulIteration;
+
+	printf( "Queue send + receive, configUSE_QUEUE_SIZED_COPY = %d\r\n", configUSE_QUEUE_SIZED_COPY );
+
+	for( xSize = 0; xSize < ( sizeof( uxItemSizes ) / sizeof( uxItemSizes[ 0 ] ) ); xSize++ )
+	{
+		xQueue = xQueueCreate( 1, uxItemSizes[ xSize ] );
+		configASSERT( xQueue );
+		ullFastest = ~( ( unsigned __int64 ) 0 );
+
+		for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+		{
+			ullStart = __rdtsc();
+
+			for( ulIteration = 0; ulIteration < mainBENCHMARK_ITERATIONS; ulIteration++ )
+			{
+				( void ) xQueueSend( xQueue, ucItem, 0 );
+				( void ) xQueueReceive( xQueue, ucItem, 0 );
+			}
+
+			ullCycles = __rdtsc() - ullStart;
+
+			if( ullCycles < ullFastest )
+			{
+				ullFastest = ullCycles;
+			}
+		}
+
+		printf( "  %2u byte items: %4u cycles per message\r\n", ( unsigned ) uxItemSizes[ xSize ], ( unsigned ) ( ullFastest / mainBENCHMARK_ITERATIONS ) );
+		vQueueDelete( xQueue );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerChurnBenchmark( void )
+{
+static const UBaseType_t uxTimerCounts[] = { 16U, 64U, 256U };
+static TimerHandle_t xTimers[ mainMAX_CHURN_TIMERS ];
+unsigned __int64 ullStart, ullCycles, ullFastest;
+size_t xCount;
+UBaseType_t uxTimer, uxNextTimer = 0;
+uint32_t ulRun, ulIteration, ulCommand;
+
+	printf( "Timer reset with N active timers, configUSE_TIMER_WHEEL = %d\r\n", configUSE_TIMER_WHEEL );
+
+	for( xCount = 0; xCount < ( sizeof( uxTimerCounts ) / sizeof( uxTimerCounts[ 0 ] ) ); xCount++ )
+	{
+		/* Give the timers different periods so a reset timer does not always
+		go to the same end of the active timer list. */
+		for( uxTimer = 0; uxTimer < uxTimerCounts[ xCount ]; uxTimer++ )
+		{
+			xTimers[ uxTimer ] = xTimerCreate( "Churn", mainMIN_CHURN_PERIOD + ( ( uxTimer * 7919U ) % mainMIN_CHURN_PERIOD ), pdFALSE, NULL, prvChurnTimerCallback );
+			configASSERT( xTimers[ uxTimer ] );
+			xTimerStart( xTimers[ uxTimer ], portMAX_DELAY );
+		}
+
+		ullFastest = ~( ( unsigned __int64 ) 0 );
+
+		for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+		{
+			ullStart = __rdtsc();
+
+			for( ulIteration = 0; ulIteration < mainBENCHMARK_ITERATIONS; ulIteration += mainCHURN_BATCH_SIZE )
+			{
+				/* Queue a batch of commands before letting the higher priority
+				timer service task run, so the time measured is dominated by
+				processing the commands rather than by context switches. */
+				vTaskSuspendAll();
+				{
+					for( ulCommand = 0; ulCommand < mainCHURN_BATCH_SIZE; ulCommand++ )
+					{
+						( void ) xTimerReset( xTimers[ uxNextTimer ], 0 );
+						uxNextTimer = ( uxNextTimer + 1U ) % uxTimerCounts[ xCount ];
+					}
+				}
+				( void ) xTaskResumeAll();
+			}
+
+			ullCycles = __rdtsc() - ullStart;
+
+			if( ullCycles < ullFastest )
+			{
+				ullFastest = ullCycles;
+			}
+		}
+
+		printf( "  %3u timers: %5u cycles per reset\r\n", ( unsigned ) uxTimerCounts[ xCount ], ( unsigned ) ( ullFastest / mainBENCHMARK_ITERATIONS ) );
+
+		for( uxTimer = 0; uxTimer < uxTimerCounts[ xCount ]; uxTimer++ )
+		{
+			xTimerDelete( xTimers[ uxTimer ], portMAX_DELAY );
+		}
+
+		uxNextTimer = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvChurnTimerCallback( TimerHandle_t xTimer )
+{
+	( void ) xTimer;
+	configASSERT( pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerBurstBenchmark( void )
+{
+static const UBaseType_t uxBurstSizes[] = { configTIMER_QUEUE_LENGTH / 2U, configTIMER_QUEUE_LENGTH, configTIMER_QUEUE_LENGTH * 4U };
+TimerHandle_t xTimers[ mainBURST_TIMERS ];
+TaskHandle_t xTimerTask = xTimerGetTimerDaemonTaskHandle();
+const UBaseType_t uxTimerTaskPriority = uxTaskPriorityGet( xTimerTask );
+unsigned __int64 ullStart, ullCycles, ullFastest;
+size_t xBurst;
+UBaseType_t uxTimer;
+uint32_t ulRun, ulIteration, ulCommand;
+
+#if( configUSE_QUEUE_STATS == 1 )
+	QueueStats_t xStats;
+#endif
+
+	printf( "Timer command bursts, configTIMER_COMMAND_BATCH_SIZE = %d\r\n", configTIMER_COMMAND_BATCH_SIZE );
+
+	for( uxTimer = 0; uxTimer < mainBURST_TIMERS; uxTimer++ )
+	{
+		xTimers[ uxTimer ] = xTimerCreate( "Burst", mainMIN_CHURN_PERIOD + uxTimer, pdFALSE, NULL, prvChurnTimerCallback );
+		configASSERT( xTimers[ uxTimer ] );
+		xTimerStart( xTimers[ uxTimer ], portMAX_DELAY );
+	}
+
+	/* Run above the timer service task while sending each burst, then drop
+	below it so it can process whatever is still queued before the burst is
+	counted as complete. */
+	vTaskPrioritySet( xTimerTask, configMAX_PRIORITIES - 2 );
+
+	for( xBurst = 0; xBurst < ( sizeof( uxBurstSizes ) / sizeof( uxBurstSizes[ 0 ] ) ); xBurst++ )
+	{
+		ullFastest = ~( ( unsigned __int64 ) 0 );
+
+		#if( configUSE_QUEUE_STATS == 1 )
+		{
+			vTimerResetCommandQueueStats();
+		}
+		#endif
+
+		for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+		{
+			ullStart = __rdtsc();
+
+			for( ulIteration = 0; ulIteration < mainBENCHMARK_ITERATIONS; ulIteration += uxBurstSizes[ xBurst ] )
+			{
+				vTaskPrioritySet( NULL, configMAX_PRIORITIES - 1 );
+
+				for( ulCommand = 0; ulCommand < uxBurstSizes[ xBurst ]; ulCommand++ )
+				{
+					( void ) xTimerReset( xTimers[ ulCommand % mainBURST_TIMERS ], portMAX_DELAY );
+				}
+
+				vTaskPrioritySet( NULL, mainBENCHMARK_TASK_PRIORITY );
+			}
+
+			ullCycles = __rdtsc() - ullStart;
+
+			if( ullCycles < ullFastest )
+			{
+				ullFastest = ullCycles;
+			}
+		}
+
+		#if( configUSE_QUEUE_STATS == 1 )
+		{
+			/* The depth the timer command queue reached shows whether the
+			bursts were absorbed by the queue or blocked the sender. */
+			vTimerGetCommandQueueStats( &xStats );
+			printf( "  bursts of %2u: %5u cycles per command, peak queue depth %2u, sender blocked %u times\r\n", ( unsigned ) uxBurstSizes[ xBurst ], ( unsigned ) ( ullFastest / mainBENCHMARK_ITERATIONS ), ( unsigned ) xStats.uxPeakMessagesWaiting, ( unsigned ) xStats.ulSendsBlocked );
+		}
+		#else
+		{
+			printf( "  bursts of %2u: %5u cycles per command\r\n", ( unsigned ) uxBurstSizes[ xBurst ], ( unsigned ) ( ullFastest / mainBENCHMARK_ITERATIONS ) );
+		}
+		#endif
+	}
+
+	vTaskPrioritySet( xTimerTask, uxTimerTaskPriority );
+
+	for( uxTimer = 0; uxTimer < mainBURST_TIMERS; uxTimer++ )
+	{
+		xTimerDelete( xTimers[ uxTimer ], portMAX_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventGroupLatencyBenchmark( void )
+{
+TaskHandle_t xWaitingTask;
+uint32_t ulSample;
+
+	printf( "Event group set from ISR to task, configEVENT_GROUP_ISR_MAX_WAITERS = %d\r\n", configEVENT_GROUP_ISR_MAX_WAITERS );
+
+	xLatencyEventGroup = xEventGroupCreate();
+	configASSERT( xLatencyEventGroup );
+	ullFastestLatency = ~( ( unsigned __int64 ) 0 );
+	ullTotalLatency = 0;
+
+	/* The waiting task runs above this task, but below the timer service
+	task, so when the bits are set through the timer service task the latency
+	includes it running first. */
+	vPortSetInterruptHandler( mainEVENT_INTERRUPT_NUMBER, prvEventGroupInterruptHandler );
+	xTaskCreate( prvEventGroupWaitingTask, "Waiter", configMINIMAL_STACK_SIZE, ( void * ) xTaskGetCurrentTaskHandle(), configMAX_PRIORITIES - 2, &xWaitingTask );
+	configASSERT( xWaitingTask );
+
+	for( ulSample = 0; ulSample < mainLATENCY_SAMPLES; ulSample++ )
+	{
+		/* Wait for the waiting task to have measured the latency and blocked
+		on the event group again before raising the next interrupt. */
+		vPortGenerateSimulatedInterrupt( mainEVENT_INTERRUPT_NUMBER );
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	}
+
+	printf( "  fastest %u cycles, average %u cycles\r\n", ( unsigned ) ullFastestLatency, ( unsigned ) ( ullTotalLatency / mainLATENCY_SAMPLES ) );
+
+	vTaskDelete( xWaitingTask );
+	vEventGroupDelete( xLatencyEventGroup );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvEventGroupInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	ullInterruptTime = __rdtsc();
+	( void ) xEventGroupSetBitsFromISR( xLatencyEventGroup, mainEVENT_BIT, &xHigherPriorityTaskWoken );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventGroupWaitingTask( void *pvParameters )
+{
+TaskHandle_t xBenchmarkTask = ( TaskHandle_t ) pvParameters;
+unsigned __int64 ullLatency;
+
+	for( ;; )
+	{
+		( void ) xEventGroupWaitBits( xLatencyEventGroup, mainEVENT_BIT, pdTRUE, pdFALSE, portMAX_DELAY );
+		ullLatency = __rdtsc() - ullInterruptTime;
+
+		if( ullLatency < ullFastestLatency )
+		{
+			ullFastestLatency = ullLatency;
+		}
+
+		ullTotalLatency += ullLatency;
+		xTaskNotifyGive( xBenchmarkTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapStressBenchmark( void )
+{
+static const UBaseType_t uxSlotCounts[] = { 16U, 64U, mainMAX_HEAP_STRESS_SLOTS };
+static void *pvBlocks[ mainMAX_HEAP_STRESS_SLOTS ];
+static size_t xBlockSizes[ mainMAX_HEAP_STRESS_SLOTS ];
+static uint32_t ulMallocCycles[ mainHEAP_STRESS_OPERATIONS ], ulFreeCycles[ mainHEAP_STRESS_OPERATIONS ];
+uint32_t ulOperation, ulMallocs, ulFrees, ulCycles, ulSlot;
+size_t xCount, xAllocatedBytes = 0, xBudget;
+unsigned __int64 ullStart;
+HeapStats_t xHeapStats;
+
+	printf( "Heap stress, pvPortMalloc() and vPortFree() with %u bytes free\r\n", ( unsigned ) xPortGetFreeHeapSize() );
+	xBudget = xPortGetFreeHeapSize() / mainHEAP_STRESS_SHARE;
+
+	for( xCount = 0; xCount < ( sizeof( uxSlotCounts ) / sizeof( uxSlotCounts[ 0 ] ) ); xCount++ )
+	{
+		ulHeapStressRandom = 0x12345678UL;
+		ulMallocs = 0;
+		ulFrees = 0;
+
+		for( ulOperation = 0; ulOperation < ( mainHEAP_STRESS_OPERATIONS * 2U ); ulOperation++ )
+		{
+			ulHeapStressRandom = ( ulHeapStressRandom * 1103515245UL ) + 12345UL;
+			ulSlot = ( ulHeapStressRandom >> 16 ) % uxSlotCounts[ xCount ];
+
+			if( pvBlocks[ ulSlot ] == NULL )
+			{
+				xBlockSizes[ ulSlot ] = prvHeapStressBlockSize();
+
+				if( ( xAllocatedBytes + xBlockSizes[ ulSlot ] ) <= xBudget )
+				{
+					ullStart = __rdtsc();
+					pvBlocks[ ulSlot ] = pvPortMalloc( xBlockSizes[ ulSlot ] );
+					ulCycles = ( uint32_t ) ( __rdtsc() - ullStart );
+
+					if( pvBlocks[ ulSlot ] != NULL )
+					{
+						xAllocatedBytes += xBlockSizes[ ulSlot ];
+					}
+
+					/* Only the second half of the calls are timed, once the
+					heap is fragmented. */
+					if( ulOperation >= mainHEAP_STRESS_OPERATIONS )
+					{
+						ulMallocCycles[ ulMallocs ] = ulCycles;
+						ulMallocs++;
+					}
+				}
+			}
+			else
+			{
+				ullStart = __rdtsc();
+				vPortFree( pvBlocks[ ulSlot ] );
+				ulCycles = ( uint32_t ) ( __rdtsc() - ullStart );
+				pvBlocks[ ulSlot ] = NULL;
+				xAllocatedBytes -= xBlockSizes[ ulSlot ];
+
+				if( ulOperation >= mainHEAP_STRESS_OPERATIONS )
+				{
+					ulFreeCycles[ ulFrees ] = ulCycles;
+					ulFrees++;
+				}
+			}
+		}
+
+		/* Show how fragmented the churn has left the heap before the blocks
+		still allocated are freed. */
+		vPortGetHeapStats( &xHeapStats );
+
+		for( ulSlot = 0; ulSlot < uxSlotCounts[ xCount ]; ulSlot++ )
+		{
+			if( pvBlocks[ ulSlot ] != NULL )
+			{
+				vPortFree( pvBlocks[ ulSlot ] );
+				pvBlocks[ ulSlot ] = NULL;
+				xAllocatedBytes -= xBlockSizes[ ulSlot ];
+			}
+		}
+
+		printf( "  up to %3u blocks allocated, %u bytes free in %u blocks, largest %u:\r\n", ( unsigned ) uxSlotCounts[ xCount ], ( unsigned ) xHeapStats.xAvailableHeapSpaceInBytes, ( unsigned ) xHeapStats.xNumberOfFreeBlocks, ( unsigned ) xHeapStats.xSizeOfLargestFreeBlockInBytes );
+		prvPrintDistribution( "pvPortMalloc()", ulMallocCycles, ulMallocs );
+		prvPrintDistribution( "vPortFree()", ulFreeCycles, ulFrees );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapCacheBenchmark( void )
+{
+static void *pvBlocks[ mainHEAP_CACHE_BATCH ];
+static uint32_t ulMallocCycles[ mainHEAP_CACHE_BATCH * mainHEAP_CACHE_BATCHES ], ulFreeCycles[ mainHEAP_CACHE_BATCH * mainHEAP_CACHE_BATCHES ];
+static uint32_t ulMallocSuspended[ mainHEAP_CACHE_BATCH * mainHEAP_CACHE_BATCHES ], ulFreeSuspended[ mainHEAP_CACHE_BATCH * mainHEAP_CACHE_BATCHES ];
+uint32_t ulBatch, ulBlock, ulCalls = 0;
+unsigned __int64 ullStart;
+HeapStats_t xStatsBefore, xStatsAfter;
+
+	/* Warm the cache, if there is one, so only the steady state is timed. */
+	for( ulBlock = 0; ulBlock < mainHEAP_CACHE_BATCH; ulBlock++ )
+	{
+		pvBlocks[ ulBlock ] = pvPortMalloc( ( size_t ) ( 16U + ( ulBlock * 12U ) ) );
+	}
+
+	for( ulBlock = 0; ulBlock < mainHEAP_CACHE_BATCH; ulBlock++ )
+	{
+		vPortFree( pvBlocks[ ulBlock ] );
+	}
+
+	vPortGetHeapStats( &xStatsBefore );
+
+	for( ulBatch = 0; ulBatch < mainHEAP_CACHE_BATCHES; ulBatch++ )
+	{
+		for( ulBlock = 0; ulBlock < mainHEAP_CACHE_BATCH; ulBlock++ )
+		{
+			ulSuspendedCycles = 0;
+			ullStart = __rdtsc();
+			pvBlocks[ ulBlock ] = pvPortMalloc( ( size_t ) ( 16U + ( ulBlock * 12U ) ) );
+			ulMallocCycles[ ulCalls + ulBlock ] = ( uint32_t ) ( __rdtsc() - ullStart );
+			ulMallocSuspended[ ulCalls + ulBlock ] = ulSuspendedCycles;
+			configASSERT( pvBlocks[ ulBlock ] );
+		}
+
+		for( ulBlock = 0; ulBlock < mainHEAP_CACHE_BATCH; ulBlock++ )
+		{
+			ulSuspendedCycles = 0;
+			ullStart = __rdtsc();
+			vPortFree( pvBlocks[ ulBlock ] );
+			ulFreeCycles[ ulCalls + ulBlock ] = ( uint32_t ) ( __rdtsc() - ullStart );
+			ulFreeSuspended[ ulCalls + ulBlock ] = ulSuspendedCycles;
+		}
+
+		ulCalls += mainHEAP_CACHE_BATCH;
+	}
+
+	vPortGetHeapStats( &xStatsAfter );
+
+	printf( "Heap cache, %u small blocks allocated then freed %u times, %u taken from and %u returned to the heap:\r\n",
+			( unsigned ) mainHEAP_CACHE_BATCH,
+			( unsigned ) mainHEAP_CACHE_BATCHES,
+			( unsigned ) ( xStatsAfter.xNumberOfSuccessfulAllocations - xStatsBefore.xNumberOfSuccessfulAllocations ),
+			( unsigned ) ( xStatsAfter.xNumberOfSuccessfulFrees - xStatsBefore.xNumberOfSuccessfulFrees ) );
+	prvPrintDistribution( "pvPortMalloc()", ulMallocCycles, ulCalls );
+	prvPrintDistribution( "vPortFree()", ulFreeCycles, ulCalls );
+
+	printf( "  of which the scheduler was suspended for:\r\n" );
+	prvPrintDistribution( "pvPortMalloc()", ulMallocSuspended, ulCalls );
+	prvPrintDistribution( "vPortFree()", ulFreeSuspended, ulCalls );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkSchedulerSuspended( void )
+{
+	ullSuspendedTime = __rdtsc();
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkSchedulerResumed( void )
+{
+	ulSuspendedCycles += ( uint32_t ) ( __rdtsc() - ullSuspendedTime );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvHeapStressBlockSize( void )
+{
+uint32_t ulRandom;
+size_t xSize;
+
+	ulHeapStressRandom = ( ulHeapStressRandom * 1103515245UL ) + 12345UL;
+	ulRandom = ulHeapStressRandom >> 8;
+
+	if( ( ulRandom % 100U ) < 60U )
+	{
+		xSize = ( size_t ) ( 8U + ( ( ulRandom >> 8 ) % 120U ) );
+	}
+	else if( ( ulRandom % 100U ) < 95U )
+	{
+		xSize = ( size_t ) ( 128U + ( ( ulRandom >> 8 ) % 384U ) );
+	}
+	else
+	{
+		xSize = ( size_t ) ( 512U + ( ( ulRandom >> 8 ) % 1536U ) );
+	}
+
+	return xSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintDistribution( const char *pcName, uint32_t *pulCycles, uint32_t ulCount )
+{
+	configASSERT( ulCount > 0 );
+	qsort( pulCycles, ulCount, sizeof( uint32_t ), prvCompareCycles );
+
+	/* Windows can interrupt any call, so the worst case says more about
+	Windows than about the heap - the 99th percentile is a better guide to
+	the worst case of the heap itself. */
+	printf( "    %-14s %4u calls, cycles: min %5u, median %5u, 90%% %5u, 99%% %5u, max %7u\r\n",
+			pcName,
+			( unsigned ) ulCount,
+			( unsigned ) pulCycles[ 0 ],
+			( unsigned ) pulCycles[ ulCount / 2U ],
+			( unsigned ) pulCycles[ ( ulCount * 90U ) / 100U ],
+			( unsigned ) pulCycles[ ( ulCount * 99U ) / 100U ],
+			( unsigned ) pulCycles[ ulCount - 1U ] );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareCycles( const void *pvFirst, const void *pvSecond )
+{
+uint32_t ulFirst = *( const uint32_t * ) pvFirst, ulSecond = *( const uint32_t * ) pvSecond;
+
+	return ( ulFirst > ulSecond ) - ( ulFirst < ulSecond );
+}
+/*-----------------------------------------------------------*/
+
+static void prvObjectPoolBenchmark( void )
+{
+static const char * const pcObjectNames[ mainPOOLED_OBJECT_KINDS ] = { "binary semaphore", "mutex", "queue of 4 words", "event group" };
+SemaphoreHandle_t xSemaphore;
+QueueHandle_t xQueue;
+EventGroupHandle_t xEventGroup;
+unsigned __int64 ullStart, ullCycles, ullFastest;
+size_t xObject;
+uint32_t ulRun, ulIteration;
+
+	printf( "Object create + delete, configUSE_OBJECT_POOLS = %d\r\n", configUSE_OBJECT_POOLS );
+
+	for( xObject = 0; xObject < mainPOOLED_OBJECT_KINDS; xObject++ )
+	{
+		ullFastest = ~( ( unsigned __int64 ) 0 );
+
+		for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+		{
+			ullStart = __rdtsc();
+
+			for( ulIteration = 0; ulIteration < mainBENCHMARK_ITERATIONS; ulIteration++ )
+			{
+				switch( xObject )
+				{
+					case 0:
+						xSemaphore = xSemaphoreCreateBinary();
+						configASSERT( xSemaphore );
+						vSemaphoreDelete( xSemaphore );
+						break;
+
+					case 1:
+						xSemaphore = xSemaphoreCreateMutex();
+						configASSERT( xSemaphore );
+						vSemaphoreDelete( xSemaphore );
+						break;
+
+					case 2:
+						xQueue = xQueueCreate( 4, sizeof( uint32_t ) );
+						configASSERT( xQueue );
+						vQueueDelete( xQueue );
+						break;
+
+					default:
+						xEventGroup = xEventGroupCreate();
+						configASSERT( xEventGroup );
+						vEventGroupDelete( xEventGroup );
+						break;
+				}
+			}
+
+			ullCycles = __rdtsc() - ullStart;
+
+			if( ullCycles < ullFastest )
+			{
+				ullFastest = ullCycles;
+			}
+		}
+
+		printf( "  %-16s %4u cycles per create + delete\r\n", pcObjectNames[ xObject ], ( unsigned ) ( ullFastest / mainBENCHMARK_ITERATIONS ) );
+	}
+
+	#if( configUSE_OBJECT_POOLS == 1 )
+	{
+	static const char * const pcPoolNames[ poolNUMBER_OF_POOLS ] = { "task", "stack", "queue", "timer", "event group" };
+	ObjectPoolStatus_t xStatus;
+	UBaseType_t uxPool;
+
+		for( uxPool = 0; uxPool < poolNUMBER_OF_POOLS; uxPool++ )
+		{
+			vObjectPoolGetInfo( ( eObjectPool ) uxPool, &xStatus );
+			printf( "  %-11s pool: %2u of %2u blocks of %4u bytes in use, peak %2u, %u allocations, %u from the heap\r\n", pcPoolNames[ uxPool ], ( unsigned ) xStatus.uxBlocksInUse, ( unsigned ) xStatus.uxBlocks, ( unsigned ) xStatus.xBlockSize, ( unsigned ) xStatus.uxPeakBlocksInUse, ( unsigned ) xStatus.ulAllocations, ( unsigned ) xStatus.ulFallbacks );
+		}
+	}
+	#endif /* configUSE_OBJECT_POOLS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvArenaBenchmark( void )
+{
+#if( configUSE_ARENAS == 1 )
+static void *pvBlocks[ mainARENA_BLOCKS ];
+ArenaHandle_t xArena;
+unsigned __int64 ullStart, ullCycles, ullFastestHeap, ullFastestArena;
+uint32_t ulRun, ulBlock;
+
+	xArena = xArenaCreate( mainARENA_SIZE );
+	configASSERT( xArena );
+	ullFastestHeap = ~( ( unsigned __int64 ) 0 );
+	ullFastestArena = ~( ( unsigned __int64 ) 0 );
+
+	for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+	{
+		ullStart = __rdtsc();
+
+		for( ulBlock = 0; ulBlock < mainARENA_BLOCKS; ulBlock++ )
+		{
+			pvBlocks[ ulBlock ] = pvPortMalloc( ( size_t ) ( 8U + ( ( ulBlock * 37U ) % 120U ) ) );
+			configASSERT( pvBlocks[ ulBlock ] );
+		}
+
+		for( ulBlock = 0; ulBlock < mainARENA_BLOCKS; ulBlock++ )
+		{
+			vPortFree( pvBlocks[ ulBlock ] );
+		}
+
+		ullCycles = __rdtsc() - ullStart;
+
+		if( ullCycles < ullFastestHeap )
+		{
+			ullFastestHeap = ullCycles;
+		}
+
+		ullStart = __rdtsc();
+
+		for( ulBlock = 0; ulBlock < mainARENA_BLOCKS; ulBlock++ )
+		{
+			pvBlocks[ ulBlock ] = pvArenaMalloc( xArena, ( size_t ) ( 8U + ( ( ulBlock * 37U ) % 120U ) ) );
+			configASSERT( pvBlocks[ ulBlock ] );
+		}
+
+		vArenaReset( xArena );
+		ullCycles = __rdtsc() - ullStart;
+
+		if( ullCycles < ullFastestArena )
+		{
+			ullFastestArena = ullCycles;
+		}
+	}
+
+	printf( "Allocate %u small blocks then release them all\r\n", ( unsigned ) mainARENA_BLOCKS );
+	printf( "  heap:  %6u cycles\r\n", ( unsigned ) ullFastestHeap );
+	printf( "  arena: %6u cycles, %u of %u bytes used at most\r\n", ( unsigned ) ullFastestArena, ( unsigned ) ( mainARENA_SIZE - xArenaGetMinimumEverFreeSize( xArena ) ), ( unsigned ) mainARENA_SIZE );
+
+	vArenaDelete( xArena );
+#endif /* configUSE_ARENAS */
+}
+/*-----------------------------------------------------------*/
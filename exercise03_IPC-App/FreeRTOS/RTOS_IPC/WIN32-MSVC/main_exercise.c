@@ -17,6 +17,7 @@
 #include "task.h"
 #include "timers.h"
 #include "semphr.h"
+#include "static_objects.h"
 
 /*Macros*/
 #define IPC_MAX_TASKS_CONTROLLER	2
@@ -78,9 +79,7 @@ typedef enum
 
 typedef struct
 {
-	e_ipcTaskPriority priority;
 	unsigned long outputFrequency;
-	void (*funcPtr)(void);
 	TaskHandle_t taskHandle;
 	QueueHandle_t queueHandle;
 }s_ipcTasks;
@@ -102,77 +101,47 @@ static s_ipcTasks ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_MAX];	//Improvemen
 static s_ipcTasks ipcSensorTasks[IPC_TASK_TYPE_SENSOR_MAX];
 static QueueSetHandle_t xQueueSet2;
 
+/*
+	Tasks and queues created at start up.  The tables are expanded by static_objects.h into statically
+	allocated TCBs, stacks and queue storage, so start up takes no memory from the heap and the memory
+	used is known at link time.
+	Task entries: X( name, function, task name, stack depth, parameter, priority, handle )
+	Queue entries: X( name, kind, length, item size, registry name, handle )
+*/
+#define IPC_STATIC_TASKS( X )																																		\
+	X( ControllerMain,	ipcControllerTaskMain,		"ControllerTasks",	configMINIMAL_STACK_SIZE, NULL, IPC_TASK_PRIORITY_3, ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_MAIN].taskHandle )	\
+	X( ControllerSec,	ipcControllerTaskSecondary,	"ControllerTasks",	configMINIMAL_STACK_SIZE, NULL, IPC_TASK_PRIORITY_3, ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_SEC].taskHandle )	\
+	X( Sensor1,			ipcSensorTask1,				"Sensor Tasks",		configMINIMAL_STACK_SIZE, NULL, IPC_TASK_PRIORITY_2, ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].taskHandle )			\
+	X( Sensor2A,		ipcSensorTask2a,			"Sensor Tasks",		configMINIMAL_STACK_SIZE, NULL, IPC_TASK_PRIORITY_2, ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].taskHandle )			\
+	X( Sensor2B,		ipcSensorTask2b,			"Sensor Tasks",		configMINIMAL_STACK_SIZE, NULL, IPC_TASK_PRIORITY_2, ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].taskHandle )
+
+#define IPC_STATIC_QUEUES( X )																								\
+	X( Sensor1Q,	TIMESTAMPED,	QUEUE_SENSORS_LENGTH,		QUEUE_SENSORS_ITEM_SIZE,	"Sensor1Q",		ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].queueHandle )	\
+	X( Sensor2AQ,	TIMESTAMPED,	QUEUE_SENSORS_LENGTH,		QUEUE_SENSORS_ITEM_SIZE,	"Sensor2AQ",	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].queueHandle )	\
+	X( Sensor2BQ,	TIMESTAMPED,	QUEUE_SENSORS_LENGTH,		QUEUE_SENSORS_ITEM_SIZE,	"Sensor2BQ",	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].queueHandle )	\
+	X( SensorSet2,	SET,			2*QUEUE_SENSORS_LENGTH,		0,							"SensorSet2",	xQueueSet2 )
+
+staticDECLARE_TASKS( IPC_STATIC_TASKS )
+staticDECLARE_QUEUES( IPC_STATIC_QUEUES )
+
 /*Additional Functions*/
 void getSensorData(e_ipcControllerTaskType controllerType,QueueSetMemberHandle_t* xActivatedMember2);
+void ipcPrintSensorQueueResidence(void);
 
 void main_exercise( void )
 {
-	/*Controller tasks*/
-	ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_MAIN].funcPtr = &ipcControllerTaskMain;
-	ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_MAIN].priority = IPC_TASK_PRIORITY_3;  // todo: decide the final priority, keep 2 for now
-
-
-	ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_SEC].funcPtr = &ipcControllerTaskSecondary;
-	ipcControllerTasks[IPC_TASK_TYPE_CONTROLLER_SEC].priority = IPC_TASK_PRIORITY_3;  // todo: decide the final priority, keep 2 for now
-
-
 	/*Sensor Tasks*/
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].funcPtr = &ipcSensorTask1;
 	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].outputFrequency = IPC_SENSOR_FREQ_MS_SENSOR_1;
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].priority = IPC_TASK_PRIORITY_2;				// todo: decide the final priority, keep 3 for now
-
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].funcPtr = &ipcSensorTask2a;
 	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].outputFrequency = IPC_SENSOR_FREQ_MS_SENSOR_2A;
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].priority = IPC_TASK_PRIORITY_2;				// todo: decide the final priority, keep 3 for now
-
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].funcPtr = &ipcSensorTask2b;
 	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].outputFrequency = IPC_SENSOR_FREQ_MS_SENSOR_2B;
-	ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].priority = IPC_TASK_PRIORITY_2;				// todo: decide the final priority, keep 3 for now
-
-
-	/*Create Controller tasks*/
-	uint8_t taskCount = 0;
-	uint8_t taskCountMax = (IPC_TASK_TYPE_CONTROLLER_MAX);
-
-	for (taskCount = 0; taskCount < taskCountMax; taskCount++)
-	{
-		/*
-		 * Create the task instances.
-		 */
-		xTaskCreate(ipcControllerTasks[taskCount].funcPtr,				/* The function that implements the task. */
-			"ControllerTasks", 											/* The text name assigned to the task - for debug only as it is not used by the kernel. */
-			configMINIMAL_STACK_SIZE, 									/* The size of the stack to allocate to the task. */
-			NULL, 														/* The parameter passed to the task - not used in this simple case. */
-			ipcControllerTasks[taskCount].priority,						/* The priority assigned to the task. */
-			&ipcControllerTasks[taskCount].taskHandle);						
-
-	}
 
-	/*Create Sensor tasks*/
-	taskCount = 0;
-	taskCountMax = (IPC_TASK_TYPE_SENSOR_MAX);
-
-	for (taskCount = 0; taskCount < taskCountMax; taskCount++)
-	{
-		/*
-		 * Create the task instances.
-		 */
-		xTaskCreate(ipcSensorTasks[taskCount].funcPtr,					/* The function that implements the task. */
-			"Sensor Tasks", 											/* The text name assigned to the task - for debug only as it is not used by the kernel. */
-			configMINIMAL_STACK_SIZE, 									/* The size of the stack to allocate to the task. */
-			NULL, 														/* The parameter passed to the task - not used in this simple case. */
-			ipcSensorTasks[taskCount].priority,							/* The priority assigned to the task. */
-			&ipcSensorTasks[taskCount].taskHandle);
-
-		ipcSensorTasks[taskCount].queueHandle = xQueueCreate(QUEUE_SENSORS_LENGTH, QUEUE_SENSORS_ITEM_SIZE);
-
-		/*check if queue was created*/
-		configASSERT(ipcSensorTasks[taskCount].queueHandle);
-
-	}
+	/*Create the sensor queues and the queue set, then the Controller and Sensor tasks, in the memory declared from the tables above*/
+	staticCREATE_QUEUES(IPC_STATIC_QUEUES);
+	staticCREATE_TASKS(IPC_STATIC_TASKS);
+	printf("Static task and queue memory: %u bytes\n", (unsigned)(staticTASKS_SIZE(IPC_STATIC_TASKS) + staticQUEUES_SIZE(IPC_STATIC_QUEUES)));
 
 	
-	/*Create queue sets on which the Controller tasks will keep a check*/
+	/*Add the sensor queues to the queue set on which the Controller tasks will keep a check*/
 
 	//Sensor 2A and 2B data is added to a set
 	/*
@@ -181,7 +150,6 @@ void main_exercise( void )
 		Controller 1 to start the sensing of the data in queue. Since Sensor 1 is at high frequency compared 
 		to either of Sensor 2, whenever data from Sensor 2 is available, Sensor 1 data will always be the latest data.
 	*/
-	xQueueSet2 = xQueueCreateSet(2*QUEUE_SENSORS_LENGTH);
 	xQueueAddToSet(ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].queueHandle, xQueueSet2);
 	xQueueAddToSet(ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].queueHandle, xQueueSet2);
 
@@ -332,6 +300,7 @@ void getSensorData(e_ipcControllerTaskType controllerType,QueueSetMemberHandle_t
 	auto uint16_t dataFromQueueSensor1 = 0;
 	auto uint16_t dataFromQueueSensor2A = 0;
 	auto uint16_t dataFromQueueSensor2B = 0;
+	uint32_t ageOfData = 0;
 	char controllerValueForPrint[20];
 	if (controllerType == IPC_TASK_TYPE_CONTROLLER_MAIN)
 	{
@@ -349,18 +318,19 @@ void getSensorData(e_ipcControllerTaskType controllerType,QueueSetMemberHandle_t
 	printf("%s received data at %ld; ", controllerValueForPrint, xTaskGetTickCount() / portTICK_PERIOD_MS);
 
 	/*Lets first get the data from Sensor 1*/
-	xQueueReceive(ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].queueHandle, &dataFromQueueSensor1, 5);
-	printf("Sensor 1: %d;\t", dataFromQueueSensor1);
+	/*The sensor queues are timestamped, so the time each value waited in its queue is printed with it*/
+	xQueueReceiveWithAge(ipcSensorTasks[IPC_TASK_TYPE_SENSOR_1].queueHandle, &dataFromQueueSensor1, &ageOfData, 5);
+	printf("Sensor 1: %d (age %lu);\t", dataFromQueueSensor1, (unsigned long)ageOfData);
 
 	if (xActivatedMember2 == ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2A].queueHandle)
 	{
-		if (xQueueReceive(xActivatedMember2, &dataFromQueueSensor2A, 5) == pdPASS) { printf("Sensor 2A: %d;\n", dataFromQueueSensor2A); }
+		if (xQueueReceiveWithAge(xActivatedMember2, &dataFromQueueSensor2A, &ageOfData, 5) == pdPASS) { printf("Sensor 2A: %d (age %lu);\n", dataFromQueueSensor2A, (unsigned long)ageOfData); }
 		else { printf("Unable to get data from queue 2A"); }
 
 	}
 	else if (xActivatedMember2 == ipcSensorTasks[IPC_TASK_TYPE_SENSOR_2B].queueHandle)
 	{
-		if (xQueueReceive(xActivatedMember2, &dataFromQueueSensor2B, 5) == pdPASS) { printf("Sensor 2B: %d;\n", dataFromQueueSensor2B); }
+		if (xQueueReceiveWithAge(xActivatedMember2, &dataFromQueueSensor2B, &ageOfData, 5) == pdPASS) { printf("Sensor 2B: %d (age %lu);\n", dataFromQueueSensor2B, (unsigned long)ageOfData); }
 		else { printf("Unable to get data from queue 2B"); }
 
 	}
@@ -371,6 +341,26 @@ void getSensorData(e_ipcControllerTaskType controllerType,QueueSetMemberHandle_t
 
 }
 
+/*Print how long items have waited in each sensor queue, from the residence statistics of the timestamped queues*/
+void ipcPrintSensorQueueResidence(void)
+{
+	QueueResidenceStats_t residenceStats;
+	uint32_t averageAge;
+	int sensor;
+
+	printf("Queue\t\tItems\tMinAge\tAvgAge\tMaxAge\r\n");
+	for (sensor = 0; sensor < IPC_TASK_TYPE_SENSOR_MAX; sensor++)
+	{
+		/*The queues are only created when the exercise is run*/
+		if ((ipcSensorTasks[sensor].queueHandle != NULL) && (xQueueGetResidenceStats(ipcSensorTasks[sensor].queueHandle, &residenceStats) == pdPASS))
+		{
+			averageAge = (residenceStats.ulItems > 0) ? (uint32_t)(residenceStats.ullTotalAge / residenceStats.ulItems) : 0;
+			printf("%s\t%lu\t%lu\t%lu\t%lu\r\n", pcQueueGetName(ipcSensorTasks[sensor].queueHandle), (unsigned long)residenceStats.ulItems,
+				(unsigned long)residenceStats.ulMinAge, (unsigned long)averageAge, (unsigned long)residenceStats.ulMaxAge);
+		}
+	}
+}
+
 void ipcControllerTaskSecondary(void* taskParameters)
 {
 	TickType_t xNextWakeTime;
@@ -0,0 +1,320 @@
+/*
+ * Arenas - bump pointer allocation with bulk release.
+ * See arena.h for a description of the behaviour.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "arena.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+to use arenas.  This #if is closed at the very bottom of this file. */
+#if( configUSE_ARENAS == 1 )
+
+#if( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error INCLUDE_xTaskGetCurrentTaskHandle or configUSE_MUTEXES must be set to 1 to use arenas, as arenas are attached to the calling task using xTaskGetCurrentTaskHandle()
+#endif
+
+/* Rounds a size up to a multiple of the alignment pvPortMalloc() guarantees,
+so every block handed out by an arena is aligned. */
+#define arenaALIGNED_SIZE( xSize )	( ( ( size_t ) ( xSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The state of an arena, held at the start of the arena's memory. */
+typedef struct ArenaDefinition
+{
+	uint8_t *pucStart;					/* The first byte the arena hands out. */
+	uint8_t *pucNextFree;				/* The start of the next block to be handed out. */
+	uint8_t *pucEnd;					/* One past the last byte the arena hands out. */
+	size_t xMinimumEverFreeBytes;
+	TaskHandle_t xOwnerTask;			/* The task the arena is attached to, if any. */
+	uint8_t ucStaticallyAllocated;		/* Set to pdTRUE if the arena was created in memory provided by the application, so must not be freed. */
+} Arena_t;
+
+/* The space taken at the start of an arena's memory by its state. */
+#define arenaHEADER_SIZE	arenaALIGNED_SIZE( sizeof( Arena_t ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Initialises the state of an arena at pucArenaStart, which must be aligned,
+ * and returns it.  The arena hands out the memory from the end of its state
+ * to pucArenaEnd, which must also be aligned.
+ */
+static Arena_t *prvInitialiseNewArena( uint8_t *pucArenaStart, uint8_t *pucArenaEnd, uint8_t ucStaticallyAllocated ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	ArenaHandle_t xArenaCreate( size_t xArenaSizeInBytes )
+	{
+	uint8_t *pucArenaStorage;
+	Arena_t *pxArena = NULL;
+	size_t xTotalSize;
+
+		/* Check the size of the arena plus its state does not overflow. */
+		if( xArenaSizeInBytes <= ( ( ~( size_t ) 0 ) - arenaHEADER_SIZE - ( size_t ) portBYTE_ALIGNMENT ) )
+		{
+			xTotalSize = arenaHEADER_SIZE + arenaALIGNED_SIZE( xArenaSizeInBytes );
+
+			/* pvPortMalloc() returns memory aligned to portBYTE_ALIGNMENT, so
+			the state and the memory handed out are both aligned. */
+			pucArenaStorage = ( uint8_t * ) pvPortMalloc( xTotalSize ); /*lint !e9079 malloc() only returns void*. */
+
+			if( pucArenaStorage != NULL )
+			{
+				pxArena = prvInitialiseNewArena( pucArenaStorage, pucArenaStorage + xTotalSize, ( uint8_t ) pdFALSE );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxArena;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+ArenaHandle_t xArenaCreateStatic( uint8_t *pucArenaBuffer, size_t xBufferSizeInBytes )
+{
+uint8_t *pucArenaStart, *pucArenaEnd;
+Arena_t *pxArena = NULL;
+
+	configASSERT( pucArenaBuffer );
+
+	/* Ensure the arena starts and ends on correctly aligned boundaries. */
+	pucArenaStart = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pucArenaBuffer + ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) );
+	pucArenaEnd = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pucArenaBuffer + ( portPOINTER_SIZE_TYPE ) xBufferSizeInBytes ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) );
+
+	if( ( pucArenaEnd > pucArenaStart ) && ( ( size_t ) ( pucArenaEnd - pucArenaStart ) >= arenaHEADER_SIZE ) )
+	{
+		pxArena = prvInitialiseNewArena( pucArenaStart, pucArenaEnd, ( uint8_t ) pdTRUE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxArena;
+}
+/*-----------------------------------------------------------*/
+
+static Arena_t *prvInitialiseNewArena( uint8_t *pucArenaStart, uint8_t *pucArenaEnd, uint8_t ucStaticallyAllocated )
+{
+Arena_t *pxArena = ( Arena_t * ) pucArenaStart; /*lint !e9087 !e9079 The start of the arena is aligned. */
+
+	pxArena->pucStart = pucArenaStart + arenaHEADER_SIZE;
+	pxArena->pucNextFree = pxArena->pucStart;
+	pxArena->pucEnd = pucArenaEnd;
+	pxArena->xMinimumEverFreeBytes = ( size_t ) ( pucArenaEnd - pxArena->pucStart );
+	pxArena->xOwnerTask = NULL;
+	pxArena->ucStaticallyAllocated = ucStaticallyAllocated;
+
+	return pxArena;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaDelete( ArenaHandle_t xArena )
+{
+Arena_t *pxArena = xArena;
+
+	configASSERT( pxArena );
+
+	taskENTER_CRITICAL();
+	{
+		if( pxArena->xOwnerTask != NULL )
+		{
+			( void ) pvTaskSetArenaPointer( pxArena->xOwnerTask, NULL );
+			pxArena->xOwnerTask = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	{
+		if( pxArena->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			/* The state is at the start of the block that was allocated. */
+			vPortFree( pxArena );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+void *pvArenaMalloc( ArenaHandle_t xArena, size_t xWantedSize )
+{
+Arena_t *pxArena = xArena;
+void *pvReturn = NULL;
+size_t xFreeBytes;
+
+	if( pxArena == NULL )
+	{
+		pxArena = ( Arena_t * ) pvTaskGetArenaPointer( NULL ); /*lint !e9079 The task's arena pointer only ever holds an arena. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxArena != NULL )
+	{
+		taskENTER_CRITICAL();
+		{
+			xFreeBytes = ( size_t ) ( pxArena->pucEnd - pxArena->pucNextFree );
+
+			/* The end of the arena is aligned, so if xWantedSize fits then so
+			does xWantedSize rounded up to the alignment, and the rounding
+			cannot overflow. */
+			if( ( xWantedSize > ( size_t ) 0 ) && ( xWantedSize <= xFreeBytes ) )
+			{
+				pvReturn = ( void * ) pxArena->pucNextFree;
+				pxArena->pucNextFree += arenaALIGNED_SIZE( xWantedSize );
+				xFreeBytes -= arenaALIGNED_SIZE( xWantedSize );
+
+				if( xFreeBytes < pxArena->xMinimumEverFreeBytes )
+				{
+					pxArena->xMinimumEverFreeBytes = xFreeBytes;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaReset( ArenaHandle_t xArena )
+{
+Arena_t *pxArena = xArena;
+
+	if( pxArena == NULL )
+	{
+		pxArena = ( Arena_t * ) pvTaskGetArenaPointer( NULL ); /*lint !e9079 The task's arena pointer only ever holds an arena. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	configASSERT( pxArena );
+
+	taskENTER_CRITICAL();
+	{
+		pxArena->pucNextFree = pxArena->pucStart;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+size_t xArenaGetFreeSize( ArenaHandle_t xArena )
+{
+const Arena_t *pxArena = xArena;
+
+	configASSERT( pxArena );
+
+	return ( size_t ) ( pxArena->pucEnd - pxArena->pucNextFree );
+}
+/*-----------------------------------------------------------*/
+
+size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena )
+{
+const Arena_t *pxArena = xArena;
+
+	configASSERT( pxArena );
+
+	return pxArena->xMinimumEverFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaAttachToTask( ArenaHandle_t xArena, TaskHandle_t xTask )
+{
+Arena_t *pxArena = xArena, *pxPreviousArena;
+
+	if( xTask == NULL )
+	{
+		xTask = xTaskGetCurrentTaskHandle();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	taskENTER_CRITICAL();
+	{
+		/* An arena can only be attached to one task at a time. */
+		configASSERT( ( pxArena == NULL ) || ( pxArena->xOwnerTask == NULL ) || ( pxArena->xOwnerTask == xTask ) );
+
+		pxPreviousArena = ( Arena_t * ) pvTaskSetArenaPointer( xTask, ( void * ) pxArena ); /*lint !e9079 The task's arena pointer only ever holds an arena. */
+
+		if( pxPreviousArena != NULL )
+		{
+			pxPreviousArena->xOwnerTask = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxArena != NULL )
+		{
+			pxArena->xOwnerTask = xTask;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+ArenaHandle_t xArenaGetTaskArena( TaskHandle_t xTask )
+{
+	return ( ArenaHandle_t ) pvTaskGetArenaPointer( xTask ); /*lint !e9079 The task's arena pointer only ever holds an arena. */
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to use arenas.  If you want to include arenas then ensure configUSE_ARENAS is
+set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_ARENAS == 1 */
+
@@ -38,6 +38,7 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "event_groups.h"
+#include "object_pools.h"
 
 /* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -69,6 +70,10 @@ typedef struct EventGroupDef_t
 		UBaseType_t uxEventGroupNumber;
 	#endif
 
+	#if( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+		UBaseType_t uxDeferredFromISR;	/*< The number of set and clear operations interrupts have pended to the timer task that the timer task has not yet performed. */
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
 	#endif
@@ -86,6 +91,45 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Test the bits set in uxCurrentEventBits to see if they meet the wait
+ * condition held in the event list item value of a task that is blocked on the
+ * event group.  If they do, and the task asked for the bits it waits for to be
+ * cleared on exit, those bits are added to *puxBitsToClear.
+ */
+static BaseType_t prvTestWaitingTask( const EventBits_t uxCurrentEventBits, const TickType_t xEventListItemValue, EventBits_t * const puxBitsToClear ) PRIVILEGED_FUNCTION;
+
+/*
+ * Set bits from an interrupt and unblock the tasks whose wait conditions are
+ * met, without deferring to the timer service task.  This is only done if no
+ * more than configEVENT_GROUP_ISR_MAX_WAITERS tasks are blocked on the event
+ * group, so the time spent in the interrupt is bounded, and if the scheduler
+ * is not suspended, as a task could then be part way through accessing the
+ * event group.  Returns pdFAIL, without changing the event group, if the bits
+ * could not be set directly.
+ *
+ * prvClearBitsFromISR() does the same for clearing bits, which never unblocks
+ * a task.  Neither acts while an earlier set or clear from an interrupt is
+ * still waiting for the timer service task, so the event group is always
+ * updated in the order the interrupts made the calls.
+ */
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+	static BaseType_t prvSetBitsFromISR( EventGroup_t * const pxEventBits, const EventBits_t uxBitsToSet, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+	static BaseType_t prvClearBitsFromISR( EventGroup_t * const pxEventBits, const EventBits_t uxBitsToClear ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Pend xFunction to the timer service task, counting it as deferred until
+	 * the timer service task has performed it.
+	 */
+	static BaseType_t prvDeferFromISR( EventGroup_t * const pxEventBits, PendedFunction_t xFunction, const EventBits_t uxBits, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called by the timer service task once it has performed a set or clear
+	 * operation pended by prvDeferFromISR().
+	 */
+	static void prvDeferredFromISRComplete( EventGroup_t * const pxEventBits ) PRIVILEGED_FUNCTION;
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -115,6 +159,12 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+			{
+				pxEventBits->uxDeferredFromISR = 0;
+			}
+			#endif
+
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note that
@@ -159,13 +209,19 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		sizeof( TickType_t ), the TickType_t variables will be accessed in two
 		or more reads operations, and the alignment requirements is only that
 		of each individual read. */
-		pxEventBits = ( EventGroup_t * ) pvPortMalloc( sizeof( EventGroup_t ) ); /*lint !e9087 !e9079 see comment above. */
+		pxEventBits = ( EventGroup_t * ) poolMALLOC( eEventGroupPool, sizeof( EventGroup_t ) ); /*lint !e9087 !e9079 see comment above. */
 
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
 			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+			#if( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+			{
+				pxEventBits->uxDeferredFromISR = 0;
+			}
+			#endif
+
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
 				/* Both static and dynamic allocation can be used, so note this
@@ -485,14 +541,32 @@ EventBits_t uxReturn;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear )
 	{
 		BaseType_t xReturn;
 
 		traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
-		xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+		#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+		{
+			xReturn = prvClearBitsFromISR( xEventGroup, uxBitsToClear );
+
+			if( xReturn == pdFAIL )
+			{
+				xReturn = prvDeferFromISR( xEventGroup, vEventGroupClearBitsCallback, uxBitsToClear, NULL );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+		}
+		#endif
 
 		return xReturn;
 	}
@@ -521,9 +595,8 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
 ListItem_t *pxListItem, *pxNext;
 ListItem_t const *pxListEnd;
 List_t const * pxList;
-EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+EventBits_t uxBitsToClear = 0;
 EventGroup_t *pxEventBits = xEventGroup;
-BaseType_t xMatchFound = pdFALSE;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
@@ -545,47 +618,9 @@ BaseType_t xMatchFound = pdFALSE;
 		while( pxListItem != pxListEnd )
 		{
 			pxNext = listGET_NEXT( pxListItem );
-			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-			xMatchFound = pdFALSE;
-
-			/* Split the bits waited for from the control bits. */
-			uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-			uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-			if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-			{
-				/* Just looking for single bit being set. */
-				if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-				{
-					xMatchFound = pdTRUE;
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-			}
-			else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-			{
-				/* All bits are set. */
-				xMatchFound = pdTRUE;
-			}
-			else
-			{
-				/* Need all bits to be set, but not all the bits were set. */
-			}
 
-			if( xMatchFound != pdFALSE )
+			if( prvTestWaitingTask( pxEventBits->uxEventBits, listGET_LIST_ITEM_VALUE( pxListItem ), &uxBitsToClear ) != pdFALSE )
 			{
-				/* The bits match.  Should the bits be cleared on exit? */
-				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
-				{
-					uxBitsToClear |= uxBitsWaitedFor;
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-
 				/* Store the actual event flag value in the task's event list
 				item before removing the task from the event list.  The
 				eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
@@ -593,6 +628,10 @@ BaseType_t xMatchFound = pdFALSE;
 				than because it timed out. */
 				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
 			/* Move onto the next list item.  Note pxListItem->pxNext is not
 			used here as the list item may have been removed from the event list
@@ -631,7 +670,7 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 		{
 			/* The event group can only have been allocated dynamically - free
 			it again. */
-			vPortFree( pxEventBits );
+			poolFREE( eEventGroupPool, pxEventBits );
 		}
 		#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 		{
@@ -639,7 +678,7 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 			dynamically, so check before attempting to free the memory. */
 			if( pxEventBits->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
 			{
-				vPortFree( pxEventBits );
+				poolFREE( eEventGroupPool, pxEventBits );
 			}
 			else
 			{
@@ -657,6 +696,12 @@ an interrupt. */
 void vEventGroupSetBitsCallback( void *pvEventGroup, const uint32_t ulBitsToSet )
 {
 	( void ) xEventGroupSetBits( pvEventGroup, ( EventBits_t ) ulBitsToSet ); /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+
+	#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+	{
+		prvDeferredFromISRComplete( pvEventGroup ); /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -665,6 +710,12 @@ an interrupt. */
 void vEventGroupClearBitsCallback( void *pvEventGroup, const uint32_t ulBitsToClear )
 {
 	( void ) xEventGroupClearBits( pvEventGroup, ( EventBits_t ) ulBitsToClear ); /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+
+	#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+	{
+		prvDeferredFromISRComplete( pvEventGroup ); /*lint !e9079 Can't avoid cast to void* as a generic timer callback prototype. Callback casts back to original type so safe. */
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -703,14 +754,234 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+static BaseType_t prvTestWaitingTask( const EventBits_t uxCurrentEventBits, const TickType_t xEventListItemValue, EventBits_t * const puxBitsToClear )
+{
+BaseType_t xMatchFound;
+EventBits_t uxBitsWaitedFor, uxControlBits;
+
+	/* Split the bits waited for from the control bits. */
+	uxControlBits = ( EventBits_t ) xEventListItemValue & eventEVENT_BITS_CONTROL_BYTES;
+	uxBitsWaitedFor = ( EventBits_t ) xEventListItemValue & ~eventEVENT_BITS_CONTROL_BYTES;
+
+	if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+	{
+		xMatchFound = prvTestWaitCondition( uxCurrentEventBits, uxBitsWaitedFor, pdFALSE );
+	}
+	else
+	{
+		xMatchFound = prvTestWaitCondition( uxCurrentEventBits, uxBitsWaitedFor, pdTRUE );
+	}
+
+	/* The bits match.  Should the bits be cleared on exit? */
+	if( ( xMatchFound != pdFALSE ) && ( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 ) )
+	{
+		*puxBitsToClear |= uxBitsWaitedFor;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xMatchFound;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+	static BaseType_t prvSetBitsFromISR( EventGroup_t * const pxEventBits, const EventBits_t uxBitsToSet, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	ListItem_t *pxListItem, *pxNext;
+	ListItem_t const * const pxListEnd = listGET_END_MARKER( &( pxEventBits->xTasksWaitingForBits ) ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	EventBits_t uxBitsToClear = 0;
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xReturn = pdFAIL;
+
+		configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		/* Tasks only access the event group from critical sections, which
+		this interrupt cannot have interrupted, or with the scheduler
+		suspended, so the event group is safe to update directly unless the
+		scheduler is suspended.  The mask also stops a higher priority
+		interrupt updating the event group at the same time.  Operations
+		already deferred to the timer task must be performed first. */
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) &&
+				( pxEventBits->uxDeferredFromISR == ( UBaseType_t ) 0 ) &&
+				( listCURRENT_LIST_LENGTH( &( pxEventBits->xTasksWaitingForBits ) ) <= ( UBaseType_t ) configEVENT_GROUP_ISR_MAX_WAITERS ) )
+			{
+				pxEventBits->uxEventBits |= uxBitsToSet;
+
+				for( pxListItem = listGET_HEAD_ENTRY( &( pxEventBits->xTasksWaitingForBits ) ); pxListItem != pxListEnd; pxListItem = pxNext )
+				{
+					pxNext = listGET_NEXT( pxListItem );
+
+					if( prvTestWaitingTask( pxEventBits->uxEventBits, listGET_LIST_ITEM_VALUE( pxListItem ), &uxBitsToClear ) != pdFALSE )
+					{
+						if( xTaskRemoveFromUnorderedEventListFromISR( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+						{
+							if( pxHigherPriorityTaskWoken != NULL )
+							{
+								*pxHigherPriorityTaskWoken = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				pxEventBits->uxEventBits &= ~uxBitsToClear;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+	static BaseType_t prvClearBitsFromISR( EventGroup_t * const pxEventBits, const EventBits_t uxBitsToClear )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xReturn = pdFAIL;
+
+		configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		/* The event group can be updated directly under the same conditions
+		as in prvSetBitsFromISR().  Clearing bits cannot unblock a task, so
+		the number of waiting tasks does not matter. */
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) && ( pxEventBits->uxDeferredFromISR == ( UBaseType_t ) 0 ) )
+			{
+				pxEventBits->uxEventBits &= ~uxBitsToClear;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+	static BaseType_t prvDeferFromISR( EventGroup_t * const pxEventBits, PendedFunction_t xFunction, const EventBits_t uxBits, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	BaseType_t xReturn;
+
+		/* Count the operation before it is pended, so no interrupt can update
+		the event group directly ahead of it. */
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			( pxEventBits->uxDeferredFromISR )++;
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		xReturn = xTimerPendFunctionCallFromISR( xFunction, ( void * ) pxEventBits, ( uint32_t ) uxBits, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+		if( xReturn == pdFAIL )
+		{
+			/* The timer command queue was full, so the operation is lost and
+			will never be performed. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				( pxEventBits->uxDeferredFromISR )--;
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+
+	static void prvDeferredFromISRComplete( EventGroup_t * const pxEventBits )
+	{
+		/* Only counted once the operation has been performed, so an interrupt
+		cannot update the event group directly until every operation deferred
+		before it has been performed. */
+		taskENTER_CRITICAL();
+		{
+			configASSERT( pxEventBits->uxDeferredFromISR > ( UBaseType_t ) 0 );
+			( pxEventBits->uxDeferredFromISR )--;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configEVENT_GROUP_ISR_MAX_WAITERS */
+/*-----------------------------------------------------------*/
+
+#if ( ( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 ) ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	BaseType_t xReturn;
 
 		traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
-		xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+		#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+		{
+			xReturn = prvSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken );
+		}
+		#else
+		{
+			xReturn = pdFAIL;
+		}
+		#endif
+
+		if( xReturn == pdFAIL )
+		{
+			/* Too many tasks are waiting to unblock them all from the
+			interrupt, the scheduler is suspended, or an earlier operation is
+			still waiting for the timer service task, so have the timer service
+			task set the bits instead. */
+			#if ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+			{
+				xReturn = prvDeferFromISR( xEventGroup, vEventGroupSetBitsCallback, uxBitsToSet, pxHigherPriorityTaskWoken );
+			}
+			#else
+			{
+				xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+			}
+			#endif
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
 		return xReturn;
 	}
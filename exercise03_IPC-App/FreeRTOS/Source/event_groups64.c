@@ -0,0 +1,497 @@
+/*
+ * 64-bit event groups with waiting tasks indexed by the bits they wait for.
+ * See event_groups64.h for a description of the behaviour.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups64.h"
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to build event_groups64.c
+#endif
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* The number of bits in an event group, and so the number of entries in the
+index of waiting tasks. */
+#define eventBITS_64			( ( UBaseType_t ) 64U )
+
+/*-----------------------------------------------------------*/
+
+/* State held for each task blocked on an event group.  The structure is a
+local variable of the blocked task's call to xEventGroup64WaitBits(). */
+typedef struct EventGroup64Waiter
+{
+	struct EventGroup64Waiter *pxNext;			/* The next task indexed under the same bit, or NULL. */
+	struct EventGroup64Waiter **ppxPrevious;	/* The pointer that points to this structure, so it can be removed from the index without searching. */
+	EventBits64_t uxBitsToWaitFor;
+	EventBits64_t uxBitsOnUnblock;				/* The value of the event group when the task's wait condition was met. */
+	List_t xTaskWaiting;						/* Holds the event list item of the blocked task, so the task can be unblocked without searching the tasks blocked on the group. */
+	UBaseType_t uxIndexBit;						/* The bit under which the task is indexed. */
+	BaseType_t xWaitForAllBits;
+	BaseType_t xClearOnExit;
+	volatile BaseType_t xConditionMet;			/* Set to pdTRUE when the task is removed from the index because its wait condition was met. */
+} EventGroup64Waiter_t;
+
+/* State held for each event group.  The waiting tasks indexed under each bit
+form a doubly linked list, headed by the entry in pxWaiters[] for that bit.
+uxIndexMasks[] holds, for each bit, the bits whose setting could meet the wait
+condition of a task indexed under it.  The mask only grows while tasks are
+indexed under the bit, so can include bits that no longer meet any waiting
+task's condition, and is cleared when the last task is removed. */
+typedef struct EventGroup64Definition
+{
+	EventBits64_t uxEventBits;
+	EventBits64_t uxIndexedBits;						/* Bits under which at least one task is indexed. */
+	EventBits64_t uxIndexMasks[ eventBITS_64 ];
+	EventGroup64Waiter_t *pxWaiters[ eventBITS_64 ];
+} EventGroup64_t;
+
+/*
+ * Returns pdTRUE if uxCurrentEventBits meets the wait condition of the task
+ * described by pxWaiter, otherwise pdFALSE.
+ */
+static BaseType_t prvTestWaitCondition64( const EventBits64_t uxCurrentEventBits, const EventGroup64Waiter_t * const pxWaiter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds a waiting task to the index, under the lowest bit it waits for if it
+ * waits for any bit, or under the lowest bit it waits for that is still clear
+ * if it waits for all its bits.  Must be called with the scheduler suspended.
+ */
+static void prvIndexWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a waiting task from the index.  Must be called with the scheduler
+ * suspended.
+ */
+static void prvRemoveWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a waiting task from the index, records the value it is to return and
+ * unblocks it.  Must be called with the scheduler suspended.
+ */
+static void prvUnblockWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter, const EventBits64_t uxBitsOnUnblock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of the lowest bit set in uxBits, which must not be 0.
+ */
+static UBaseType_t prvLowestSetBit( EventBits64_t uxBits ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+EventGroup64Handle_t xEventGroup64Create( void )
+{
+EventGroup64_t *pxEventBits;
+
+	pxEventBits = ( EventGroup64_t * ) pvPortMalloc( sizeof( EventGroup64_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+	if( pxEventBits != NULL )
+	{
+		/* Clears the bits and empties the index. */
+		( void ) memset( ( void * ) pxEventBits, 0x00, sizeof( EventGroup64_t ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxEventBits;
+}
+/*-----------------------------------------------------------*/
+
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup )
+{
+EventGroup64_t * const pxEventBits = xEventGroup;
+UBaseType_t uxBit;
+
+	configASSERT( pxEventBits );
+
+	vTaskSuspendAll();
+	{
+		/* Unblock every waiting task, returning 0 as the event group is being
+		deleted and cannot therefore have any bits set. */
+		while( pxEventBits->uxIndexedBits != ( EventBits64_t ) 0 )
+		{
+			uxBit = prvLowestSetBit( pxEventBits->uxIndexedBits );
+			prvUnblockWaiter( pxEventBits, pxEventBits->pxWaiters[ uxBit ], ( EventBits64_t ) 0 );
+		}
+
+		vPortFree( pxEventBits );
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait )
+{
+EventGroup64_t * const pxEventBits = xEventGroup;
+EventGroup64Waiter_t xWaiter;
+EventBits64_t uxReturn;
+BaseType_t xAlreadyYielded;
+
+	configASSERT( pxEventBits );
+	configASSERT( uxBitsToWaitFor != ( EventBits64_t ) 0 );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	xWaiter.uxBitsToWaitFor = uxBitsToWaitFor;
+	xWaiter.xWaitForAllBits = xWaitForAllBits;
+	xWaiter.xClearOnExit = xClearOnExit;
+	xWaiter.xConditionMet = pdFALSE;
+
+	vTaskSuspendAll();
+	{
+		uxReturn = pxEventBits->uxEventBits;
+
+		if( prvTestWaitCondition64( uxReturn, &xWaiter ) != pdFALSE )
+		{
+			/* The wait condition has already been met so there is no need to
+			block. */
+			xTicksToWait = ( TickType_t ) 0;
+
+			if( xClearOnExit != pdFALSE )
+			{
+				pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( xTicksToWait != ( TickType_t ) 0 )
+		{
+			/* Index the task so xEventGroup64SetBits() can find it, then block
+			on the waiter's own event list, as event_groups.c blocks on the
+			group's list.  Only xEventGroup64SetBits() or the block time
+			expiring can unblock the task. */
+			vListInitialise( &( xWaiter.xTaskWaiting ) );
+			prvIndexWaiter( pxEventBits, &xWaiter );
+			vTaskPlaceOnUnorderedEventList( &( xWaiter.xTaskWaiting ), ( TickType_t ) 0, xTicksToWait );
+		}
+		else
+		{
+			/* The wait condition has not been met, but no block time was
+			specified, so just return the current value. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	xAlreadyYielded = xTaskResumeAll();
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		if( xAlreadyYielded == pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		vTaskSuspendAll();
+		{
+			/* The task has been unblocked.  Restore the event list item value
+			the kernel uses for other blocking calls. */
+			( void ) uxTaskResetEventItemValue();
+
+			if( xWaiter.xConditionMet != pdFALSE )
+			{
+				/* The task was unblocked by xEventGroup64SetBits(), which
+				already removed it from the index and cleared its bits if
+				xClearOnExit was set. */
+				uxReturn = xWaiter.uxBitsOnUnblock;
+			}
+			else
+			{
+				/* The block time expired, or the delay was aborted.  The task
+				is still indexed, but the bits may have been updated between
+				this task leaving the Blocked state and running again. */
+				prvRemoveWaiter( pxEventBits, &xWaiter );
+				uxReturn = pxEventBits->uxEventBits;
+
+				if( ( prvTestWaitCondition64( uxReturn, &xWaiter ) != pdFALSE ) && ( xClearOnExit != pdFALSE ) )
+				{
+					pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet )
+{
+EventGroup64_t * const pxEventBits = xEventGroup;
+EventGroup64Waiter_t *pxWaiter, *pxNext;
+EventBits64_t uxNewBits, uxIndexedBits, uxBitsToClear = 0;
+UBaseType_t uxBit;
+EventBits64_t uxReturn;
+
+	configASSERT( pxEventBits );
+
+	vTaskSuspendAll();
+	{
+		/* Bits that were already set cannot meet the condition of a task
+		that is still waiting, so only the tasks that the newly set bits could
+		unblock need to be tested. */
+		uxNewBits = uxBitsToSet & ~( pxEventBits->uxEventBits );
+		pxEventBits->uxEventBits |= uxBitsToSet;
+
+		for( uxBit = 0, uxIndexedBits = pxEventBits->uxIndexedBits; uxIndexedBits != ( EventBits64_t ) 0; uxBit++, uxIndexedBits >>= 1 )
+		{
+			if( ( ( uxIndexedBits & ( EventBits64_t ) 1 ) != ( EventBits64_t ) 0 ) && ( ( pxEventBits->uxIndexMasks[ uxBit ] & uxNewBits ) != ( EventBits64_t ) 0 ) )
+			{
+				for( pxWaiter = pxEventBits->pxWaiters[ uxBit ]; pxWaiter != NULL; pxWaiter = pxNext )
+				{
+					/* The task may be unblocked or moved to another bit, so note
+					the next task first. */
+					pxNext = pxWaiter->pxNext;
+
+					if( prvTestWaitCondition64( pxEventBits->uxEventBits, pxWaiter ) != pdFALSE )
+					{
+						if( pxWaiter->xClearOnExit != pdFALSE )
+						{
+							uxBitsToClear |= pxWaiter->uxBitsToWaitFor;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						prvUnblockWaiter( pxEventBits, pxWaiter, pxEventBits->uxEventBits );
+					}
+					else if( ( pxEventBits->uxEventBits & ( ( EventBits64_t ) 1 << pxWaiter->uxIndexBit ) ) != ( EventBits64_t ) 0 )
+					{
+						/* The task waits for all its bits and the bit it was
+						indexed under is now set, but others are still clear.
+						Index it under one of those instead.  That bit is
+						clear, so is not this one, and the task is not visited
+						again by this loop. */
+						prvRemoveWaiter( pxEventBits, pxWaiter );
+						prvIndexWaiter( pxEventBits, pxWaiter );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* Clear any bits that matched tasks that set xClearOnExit. */
+		pxEventBits->uxEventBits &= ~uxBitsToClear;
+		uxReturn = pxEventBits->uxEventBits;
+	}
+	( void ) xTaskResumeAll();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear )
+{
+EventGroup64_t * const pxEventBits = xEventGroup;
+EventBits64_t uxReturn;
+
+	configASSERT( pxEventBits );
+
+	/* Clearing bits cannot meet any task's wait condition, and a task that
+	waits for all its bits is always indexed under a clear bit, so the index
+	does not need to be updated. */
+	taskENTER_CRITICAL();
+	{
+		uxReturn = pxEventBits->uxEventBits;
+		pxEventBits->uxEventBits &= ~uxBitsToClear;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup )
+{
+EventGroup64_t const * const pxEventBits = xEventGroup;
+EventBits64_t uxReturn;
+
+	configASSERT( pxEventBits );
+
+	/* A 64-bit value might not be read in one access. */
+	taskENTER_CRITICAL();
+	{
+		uxReturn = pxEventBits->uxEventBits;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTestWaitCondition64( const EventBits64_t uxCurrentEventBits, const EventGroup64Waiter_t * const pxWaiter )
+{
+BaseType_t xWaitConditionMet = pdFALSE;
+
+	if( pxWaiter->xWaitForAllBits == pdFALSE )
+	{
+		if( ( uxCurrentEventBits & pxWaiter->uxBitsToWaitFor ) != ( EventBits64_t ) 0 )
+		{
+			xWaitConditionMet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		if( ( uxCurrentEventBits & pxWaiter->uxBitsToWaitFor ) == pxWaiter->uxBitsToWaitFor )
+		{
+			xWaitConditionMet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xWaitConditionMet;
+}
+/*-----------------------------------------------------------*/
+
+static void prvIndexWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter )
+{
+UBaseType_t uxBit;
+EventBits64_t uxIndexMask;
+
+	if( pxWaiter->xWaitForAllBits == pdFALSE )
+	{
+		/* Setting any of the bits meets the condition. */
+		uxBit = prvLowestSetBit( pxWaiter->uxBitsToWaitFor );
+		uxIndexMask = pxWaiter->uxBitsToWaitFor;
+	}
+	else
+	{
+		/* The condition cannot be met until every clear bit has been set,
+		so any one of them is enough to index the task under.  The caller has
+		checked the condition is not met, so there is a clear bit. */
+		uxBit = prvLowestSetBit( pxWaiter->uxBitsToWaitFor & ~( pxEventBits->uxEventBits ) );
+		uxIndexMask = ( EventBits64_t ) 1 << uxBit;
+	}
+
+	pxWaiter->uxIndexBit = uxBit;
+	pxWaiter->pxNext = pxEventBits->pxWaiters[ uxBit ];
+	pxWaiter->ppxPrevious = &( pxEventBits->pxWaiters[ uxBit ] );
+
+	if( pxWaiter->pxNext != NULL )
+	{
+		pxWaiter->pxNext->ppxPrevious = &( pxWaiter->pxNext );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxEventBits->pxWaiters[ uxBit ] = pxWaiter;
+	pxEventBits->uxIndexMasks[ uxBit ] |= uxIndexMask;
+	pxEventBits->uxIndexedBits |= ( EventBits64_t ) 1 << uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter )
+{
+const UBaseType_t uxBit = pxWaiter->uxIndexBit;
+
+	*( pxWaiter->ppxPrevious ) = pxWaiter->pxNext;
+
+	if( pxWaiter->pxNext != NULL )
+	{
+		pxWaiter->pxNext->ppxPrevious = pxWaiter->ppxPrevious;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxEventBits->pxWaiters[ uxBit ] == NULL )
+	{
+		pxEventBits->uxIndexMasks[ uxBit ] = ( EventBits64_t ) 0;
+		pxEventBits->uxIndexedBits &= ~( ( EventBits64_t ) 1 << uxBit );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockWaiter( EventGroup64_t * const pxEventBits, EventGroup64Waiter_t * const pxWaiter, const EventBits64_t uxBitsOnUnblock )
+{
+	prvRemoveWaiter( pxEventBits, pxWaiter );
+	pxWaiter->uxBitsOnUnblock = uxBitsOnUnblock;
+	pxWaiter->xConditionMet = pdTRUE;
+
+	/* If the block time expired after the task was indexed then the kernel has
+	already removed the task from the list and made it ready, but the task has
+	not yet run to remove itself from the index.  It returns the value recorded
+	above when it does. */
+	if( listLIST_IS_EMPTY( &( pxWaiter->xTaskWaiting ) ) == pdFALSE )
+	{
+		vTaskRemoveFromUnorderedEventList( listGET_HEAD_ENTRY( &( pxWaiter->xTaskWaiting ) ), ( TickType_t ) 0 );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvLowestSetBit( EventBits64_t uxBits )
+{
+UBaseType_t uxBit = 0;
+
+	configASSERT( uxBits != ( EventBits64_t ) 0 );
+
+	while( ( uxBits & ( EventBits64_t ) 0xffU ) == ( EventBits64_t ) 0 )
+	{
+		uxBits >>= 8;
+		uxBit += ( UBaseType_t ) 8U;
+	}
+
+	while( ( uxBits & ( EventBits64_t ) 1 ) == ( EventBits64_t ) 0 )
+	{
+		uxBits >>= 1;
+		uxBit++;
+	}
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
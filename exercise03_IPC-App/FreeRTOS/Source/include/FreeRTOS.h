@@ -516,6 +516,18 @@ extern "C" {
 	#define traceTASK_RESUME( pxTaskToResume )
 #endif
 
+#ifndef traceTASK_SUSPEND_ALL
+	/* Called when vTaskSuspendAll() suspends the scheduler, but not when the
+	scheduler was already suspended. */
+	#define traceTASK_SUSPEND_ALL()
+#endif
+
+#ifndef traceTASK_RESUME_ALL
+	/* Called when xTaskResumeAll() resumes the scheduler, before the tasks
+	readied while the scheduler was suspended are moved to the ready lists. */
+	#define traceTASK_RESUME_ALL()
+#endif
+
 #ifndef traceTASK_RESUME_FROM_ISR
 	#define traceTASK_RESUME_FROM_ISR( pxTaskToResume )
 #endif
@@ -754,6 +766,140 @@ extern "C" {
 	#define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_QUEUE_TIMESTAMPS
+	#define configUSE_QUEUE_TIMESTAMPS 0
+#endif
+
+#ifndef configQUEUE_RESIDENCE_HISTOGRAM_BUCKETS
+	#define configQUEUE_RESIDENCE_HISTOGRAM_BUCKETS 16
+#endif
+
+#ifndef configUSE_QUEUE_SIZED_COPY
+	#define configUSE_QUEUE_SIZED_COPY 0
+#endif
+
+#ifndef configUSE_QUEUE_STATS
+	#define configUSE_QUEUE_STATS 0
+#endif
+
+#ifndef configUSE_MULTI_PRODUCER_STREAM_BUFFERS
+	#define configUSE_MULTI_PRODUCER_STREAM_BUFFERS 0
+#endif
+
+#ifndef configSTREAM_BUFFER_MAX_CONCURRENT_WRITES
+	#define configSTREAM_BUFFER_MAX_CONCURRENT_WRITES 8
+#endif
+
+#if( configSTREAM_BUFFER_MAX_CONCURRENT_WRITES < 1 )
+	#error configSTREAM_BUFFER_MAX_CONCURRENT_WRITES must be at least 1
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configUSE_FAST_TIMERS
+	#define configUSE_FAST_TIMERS 0
+#endif
+
+#ifndef configUSE_TIMER_SLACK
+	#define configUSE_TIMER_SLACK 0
+#endif
+
+#ifndef configTIMER_COMMAND_BATCH_SIZE
+	#define configTIMER_COMMAND_BATCH_SIZE 1
+#endif
+
+#ifndef configEVENT_GROUP_ISR_MAX_WAITERS
+	#define configEVENT_GROUP_ISR_MAX_WAITERS 0
+#endif
+
+#if( ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 ) && ( ( configUSE_TIMERS == 0 ) || ( INCLUDE_xTimerPendFunctionCall == 0 ) ) )
+	/* Event group operations an interrupt cannot perform directly are
+	deferred to the timer service task. */
+	#error configEVENT_GROUP_ISR_MAX_WAITERS can only be above 0 if configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall are both set to 1.
+#endif
+
+#ifndef configUSE_OBJECT_POOLS
+	#define configUSE_OBJECT_POOLS 0
+#endif
+
+#ifndef configTASK_POOL_LENGTH
+	#define configTASK_POOL_LENGTH 0
+#endif
+
+#ifndef configSTACK_POOL_LENGTH
+	#define configSTACK_POOL_LENGTH 0
+#endif
+
+#ifndef configSTACK_POOL_DEPTH
+	#define configSTACK_POOL_DEPTH configMINIMAL_STACK_SIZE
+#endif
+
+#ifndef configQUEUE_POOL_LENGTH
+	#define configQUEUE_POOL_LENGTH 0
+#endif
+
+#ifndef configQUEUE_POOL_STORAGE_SIZE
+	#define configQUEUE_POOL_STORAGE_SIZE 0
+#endif
+
+#ifndef configTIMER_POOL_LENGTH
+	#define configTIMER_POOL_LENGTH 0
+#endif
+
+#ifndef configEVENT_GROUP_POOL_LENGTH
+	#define configEVENT_GROUP_POOL_LENGTH 0
+#endif
+
+#ifndef configUSE_HEAP_CALLER_LEDGER
+	#define configUSE_HEAP_CALLER_LEDGER 0
+#endif
+
+#ifndef configHEAP_CALLER_LEDGER_LENGTH
+	#define configHEAP_CALLER_LEDGER_LENGTH 16
+#endif
+
+#ifndef configUSE_TASK_HEAP_ACCOUNTING
+	#define configUSE_TASK_HEAP_ACCOUNTING 0
+#endif
+
+#ifndef configTASK_HEAP_ACCOUNTS
+	#define configTASK_HEAP_ACCOUNTS 16
+#endif
+
+#ifndef configUSE_HEAP_QUOTA_HOOK
+	#define configUSE_HEAP_QUOTA_HOOK 0
+#endif
+
+#ifndef configUSE_HEAP_TASK_CACHE
+	#define configUSE_HEAP_TASK_CACHE 0
+#endif
+
+#ifndef configHEAP_TASK_CACHE_DEPTH
+	#define configHEAP_TASK_CACHE_DEPTH 8
+#endif
+
+#ifndef configUSE_ARENAS
+	#define configUSE_ARENAS 0
+#endif
+
+#ifndef configUSE_STACK_PROFILER
+	#define configUSE_STACK_PROFILER 0
+#endif
+
+#ifndef configTASK_RECLAIM_BATCH_SIZE
+	#define configTASK_RECLAIM_BATCH_SIZE 1
+#endif
+
+#if( configTASK_RECLAIM_BATCH_SIZE < 1 )
+	#error configTASK_RECLAIM_BATCH_SIZE must be at least 1
+#endif
+
+#ifndef configTASK_RECYCLE_LENGTH
+	#define configTASK_RECYCLE_LENGTH 0
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 	#define portTASK_USES_FLOATING_POINT()
 #endif
@@ -1044,6 +1190,21 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int				iDummy22;
 	#endif
+	#if ( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		UBaseType_t		uxDummy23;
+	#endif
+	#if ( configUSE_HEAP_TASK_CACHE == 1 )
+		HeapTaskCache_t	xDummy24;
+	#endif
+	#if ( configUSE_ARENAS == 1 )
+		void			*pvDummy25;
+	#endif
+	#if ( ( configUSE_STACK_PROFILER == 1 ) || ( configTASK_RECYCLE_LENGTH > 0 ) )
+		UBaseType_t		uxDummy26;
+	#endif
+	#if ( configUSE_STACK_PROFILER == 1 )
+		UBaseType_t		uxDummy27[ 2 ];
+	#endif
 } StaticTask_t;
 
 /*
@@ -1074,12 +1235,18 @@ typedef struct xSTATIC_QUEUE
 	UBaseType_t uxDummy4[ 3 ];
 	uint8_t ucDummy5[ 2 ];
 
+	#if ( configUSE_QUEUE_SIZED_COPY == 1 )
+		uint8_t ucDummy11;
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucDummy6;
 	#endif
 
 	#if ( configUSE_QUEUE_SETS == 1 )
-		void *pvDummy7;
+		void *pvDummy7[ 2 ];
+		UBaseType_t uxDummy7;
+		uint8_t ucDummy7;
 	#endif
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -1087,6 +1254,16 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+		void *pvDummy10[ 2 ];
+	#endif
+
+	#if ( configUSE_QUEUE_STATS == 1 )
+		UBaseType_t uxDummy12;
+		uint32_t ulDummy12[ 4 ];
+		TickType_t xDummy12;
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1113,6 +1290,10 @@ typedef struct xSTATIC_EVENT_GROUP
 		UBaseType_t uxDummy3;
 	#endif
 
+	#if( configEVENT_GROUP_ISR_MAX_WAITERS > 0 )
+		UBaseType_t uxDummy5;
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 			uint8_t ucDummy4;
 	#endif
@@ -1145,6 +1326,15 @@ typedef struct xSTATIC_TIMER
 		UBaseType_t		uxDummy7;
 	#endif
 
+	#if( configUSE_TIMER_SLACK == 1 )
+		TickType_t		xDummy11;
+	#endif
+
+	#if( configUSE_FAST_TIMERS == 1 )
+		uint32_t		ulDummy9;
+		uint8_t			ucDummy10;
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t 		ucDummy8;
 	#endif
@@ -1167,12 +1357,19 @@ typedef struct xSTATIC_TIMER
 */
 typedef struct xSTATIC_STREAM_BUFFER
 {
-	size_t uxDummy1[ 4 ];
+	size_t uxDummy1[ 5 ];
 	void * pvDummy2[ 3 ];
 	uint8_t ucDummy3;
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+		size_t uxDummy5;
+		UBaseType_t uxDummy6[ 2 ];
+		size_t uxDummy8[ configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ];
+		uint8_t ucDummy9[ configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ];
+		StaticList_t xDummy7;
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
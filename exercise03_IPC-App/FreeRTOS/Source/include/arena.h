@@ -0,0 +1,220 @@
+/*
+ * Arenas - bump pointer allocation with bulk release.
+ *
+ * An arena is a single region of memory that is handed out from the front, a
+ * block at a time, by moving a pointer forward.  Blocks cannot be freed one by
+ * one.  Instead the whole arena is emptied in one go by vArenaReset(), or
+ * deleted by vArenaDelete(), and both take the same time no matter how many
+ * blocks were allocated.  An arena therefore suits memory that is used for a
+ * known span of time - the buffers a task uses for one job, or for its whole
+ * life - and saves searching and fragmenting the heap for each block.
+ *
+ * An arena can be attached to a task with vArenaAttachToTask().  The arena is
+ * then deleted along with the task, so a task that ends by deleting itself
+ * does not have to free the memory it allocated first, and pvArenaMalloc() can
+ * be passed NULL to allocate from the calling task's own arena.
+ *
+ * Allocating from or resetting an arena uses a short critical section, so an
+ * arena can be shared between tasks, but arenas are intended to be used by one
+ * task at a time.  Arenas are only available when configUSE_ARENAS is 1.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include arena.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which arenas are referenced.  For example, a call to xArenaCreate()
+ * returns an ArenaHandle_t variable that can then be used as a parameter to
+ * pvArenaMalloc(), vArenaReset(), etc.
+ */
+struct ArenaDefinition;
+typedef struct ArenaDefinition * ArenaHandle_t;
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaHandle_t xArenaCreate( size_t xArenaSizeInBytes );
+</pre>
+ *
+ * Creates a new arena using dynamically allocated memory.  The arena and the
+ * memory it hands out are allocated from the heap in a single block.
+ *
+ * @param xArenaSizeInBytes The number of bytes the arena can hand out.  Every
+ * block is rounded up to a multiple of portBYTE_ALIGNMENT bytes.
+ *
+ * @return If the arena is created successfully then a handle to the created
+ * arena is returned.  If there was not enough heap memory to create the arena
+ * then NULL is returned.
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	ArenaHandle_t xArenaCreate( size_t xArenaSizeInBytes ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaHandle_t xArenaCreateStatic( uint8_t *pucArenaBuffer, size_t xBufferSizeInBytes );
+</pre>
+ *
+ * Creates a new arena in memory provided by the application.  The arena's
+ * own state is held at the start of the buffer, so the arena can hand out a
+ * little less than xBufferSizeInBytes bytes.
+ *
+ * @param pucArenaBuffer The memory the arena is created in.  It must persist
+ * until the arena is deleted.
+ *
+ * @param xBufferSizeInBytes The size of pucArenaBuffer, in bytes.
+ *
+ * @return A handle to the created arena, or NULL if the buffer is too small to
+ * hold the arena's state.
+ */
+ArenaHandle_t xArenaCreateStatic( uint8_t *pucArenaBuffer, size_t xBufferSizeInBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void vArenaDelete( ArenaHandle_t xArena );
+</pre>
+ *
+ * Deletes an arena, and with it every block allocated from it.  The memory of
+ * an arena created with xArenaCreate() is returned to the heap.  If the arena
+ * is attached to a task then it is detached first.
+ *
+ * @param xArena The handle of the arena to be deleted.
+ */
+void vArenaDelete( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void *pvArenaMalloc( ArenaHandle_t xArena, size_t xWantedSize );
+</pre>
+ *
+ * Allocates a block from an arena by moving the arena's free pointer forward.
+ * The block is aligned to portBYTE_ALIGNMENT and remains valid until the arena
+ * is reset or deleted.
+ *
+ * @param xArena The handle of the arena to allocate from, or NULL to allocate
+ * from the arena attached to the calling task.
+ *
+ * @param xWantedSize The number of bytes needed.
+ *
+ * @return A pointer to the block, or NULL if xWantedSize is 0, the arena does
+ * not have xWantedSize bytes left, or xArena is NULL and the calling task has
+ * no arena attached.
+ */
+void *pvArenaMalloc( ArenaHandle_t xArena, size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void vArenaReset( ArenaHandle_t xArena );
+</pre>
+ *
+ * Releases every block allocated from an arena at once, so the whole arena
+ * can be allocated again.  None of the blocks may be used after the arena is
+ * reset.
+ *
+ * @param xArena The handle of the arena to reset, or NULL to reset the arena
+ * attached to the calling task.
+ */
+void vArenaReset( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+size_t xArenaGetFreeSize( ArenaHandle_t xArena );
+</pre>
+ *
+ * @param xArena The handle of the arena to query.
+ *
+ * @return The number of bytes that can still be allocated from the arena.
+ */
+size_t xArenaGetFreeSize( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena );
+</pre>
+ *
+ * @param xArena The handle of the arena to query.
+ *
+ * @return The fewest bytes that have been left in the arena since it was
+ * created, which shows how large the arena needs to be.  Not affected by
+ * vArenaReset().
+ */
+size_t xArenaGetMinimumEverFreeSize( ArenaHandle_t xArena ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+void vArenaAttachToTask( ArenaHandle_t xArena, TaskHandle_t xTask );
+</pre>
+ *
+ * Attaches an arena to a task, so the arena is deleted when the task is
+ * deleted and pvArenaMalloc() and vArenaReset() can find it when passed NULL.
+ * A task can have one arena attached at a time.  Any arena already attached to
+ * the task is detached, but not deleted.
+ *
+ * Example usage:
+   <pre>
+ void vATask( void *pvParameters )
+ {
+ ArenaHandle_t xArena;
+ char *pcMessage;
+
+     xArena = xArenaCreate( 512 );
+     vArenaAttachToTask( xArena, NULL );
+
+     pcMessage = ( char * ) pvArenaMalloc( NULL, 64 );
+
+     // ... Use the blocks, then end the task.  The arena, and everything
+     // allocated from it, is released when the task is deleted.
+     vTaskDelete( NULL );
+ }
+   </pre>
+ *
+ * @param xArena The handle of the arena to attach, or NULL to detach the
+ * task's arena without deleting it.
+ *
+ * @param xTask The handle of the task to attach the arena to.  Passing NULL
+ * attaches the arena to the calling task.
+ */
+void vArenaAttachToTask( ArenaHandle_t xArena, TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * arena.h
+ *
+<pre>
+ArenaHandle_t xArenaGetTaskArena( TaskHandle_t xTask );
+</pre>
+ *
+ * @param xTask The handle of the task to query.  Passing NULL queries the
+ * calling task.
+ *
+ * @return The arena attached to the task, or NULL if it has none.
+ */
+ArenaHandle_t xArenaGetTaskArena( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( ARENA_H ) */
@@ -369,6 +369,12 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup, const EventBit
  * timer task to have the clear operation performed in the context of the timer
  * task.
  *
+ * If configEVENT_GROUP_ISR_MAX_WAITERS is set above 0 in FreeRTOSConfig.h then
+ * the bits are instead cleared directly from the interrupt, under the same
+ * conditions as xEventGroupSetBitsFromISR() sets them directly.  Either way the
+ * sets and clears made from interrupts are applied in the order they were
+ * made.
+ *
  * @param xEventGroup The event group in which the bits are to be cleared.
  *
  * @param uxBitsToClear A bitwise value that indicates the bit or bits to clear.
@@ -404,7 +410,7 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup, const EventBit
  * \defgroup xEventGroupClearBitsFromISR xEventGroupClearBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 ) )
 	BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupClearBitsFromISR( xEventGroup, uxBitsToClear ) xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL )
@@ -500,6 +506,16 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configEVENT_GROUP_ISR_MAX_WAITERS is set above 0 in FreeRTOSConfig.h then
+ * the bits are instead set, and the tasks they unblock are readied, directly
+ * from the interrupt provided no more than configEVENT_GROUP_ISR_MAX_WAITERS
+ * tasks are blocked on the event group and the scheduler is not suspended.
+ * That bounds the time spent in the interrupt, and avoids the delay of waking
+ * the timer task first.  Otherwise the message is sent to the timer task as
+ * before.  A set or clear made from an interrupt is also sent to the timer task
+ * while an earlier one is still waiting there, so they are always applied in
+ * the order they were made.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -507,18 +523,18 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * and bit 0 set uxBitsToSet to 0x09.
  *
  * @param pxHigherPriorityTaskWoken As mentioned above, calling this function
- * will result in a message being sent to the timer daemon task.  If the
- * priority of the timer daemon task is higher than the priority of the
- * currently running task (the task the interrupt interrupted) then
- * *pxHigherPriorityTaskWoken will be set to pdTRUE by
+ * can result in a message being sent to the timer daemon task.  If the
+ * priority of the timer daemon task, or of a task unblocked directly, is higher
+ * than the priority of the currently running task (the task the interrupt
+ * interrupted) then *pxHigherPriorityTaskWoken will be set to pdTRUE by
  * xEventGroupSetBitsFromISR(), indicating that a context switch should be
  * requested before the interrupt exits.  For that reason
  * *pxHigherPriorityTaskWoken must be initialised to pdFALSE.  See the
  * example code below.
  *
- * @return If the request to execute the function was posted successfully then
- * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
- * if the timer service queue was full.
+ * @return If the bits were set directly, or the request to execute the
+ * function was posted successfully, then pdPASS is returned, otherwise pdFALSE
+ * is returned.  pdFALSE will be returned if the timer service queue was full.
  *
  * Example usage:
    <pre>
@@ -556,7 +572,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configEVENT_GROUP_ISR_MAX_WAITERS > 0 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
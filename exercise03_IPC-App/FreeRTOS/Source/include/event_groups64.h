@@ -0,0 +1,171 @@
+/*
+ * 64-bit event groups.
+ *
+ * The event groups in event_groups.h hold as many bits as a TickType_t, less
+ * the top byte, which the kernel uses to store control information in the
+ * event list item of a waiting task.  With 32-bit ticks that leaves 24 bits.
+ * The event groups in this file hold 64 bits, all of which can be used by the
+ * application.
+ *
+ * Setting bits in an event_groups.h event group tests the wait condition of
+ * every task that is blocked on the group.  Here, each waiting task is instead
+ * indexed by a bit whose setting could satisfy it:  a task waiting for any of a
+ * set of bits is indexed by the lowest of those bits, and a task waiting for
+ * all of a set of bits is indexed by one of those bits that is still clear.
+ * Each index entry also records every bit that could satisfy a task indexed
+ * there.  Setting bits therefore only tests the tasks indexed under entries
+ * that the newly set bits could satisfy, so the time taken to set a bit does
+ * not grow with the number of tasks waiting for other bits.
+ *
+ * A task that blocks on an event group is held in an event list, as it is by
+ * event_groups.h, so the task's notification value remains free for the
+ * application to use.  The index makes each event group approximately 800
+ * bytes larger than an event_groups.h event group.
+ *
+ * Bits cannot be set or cleared from an interrupt.
+ */
+
+#ifndef EVENT_GROUPS_64_H
+#define EVENT_GROUPS_64_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include event_groups64.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * The type that holds the bits of a 64-bit event group.
+ */
+typedef uint64_t EventBits64_t;
+
+/**
+ * Type by which 64-bit event groups are referenced.  For example, a call to
+ * xEventGroup64Create() returns an EventGroup64Handle_t variable that can then
+ * be used as a parameter to other 64-bit event group functions.
+ */
+struct EventGroup64Definition;
+typedef struct EventGroup64Definition * EventGroup64Handle_t;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventGroup64Handle_t xEventGroup64Create( void );
+</pre>
+ *
+ * Creates a new 64-bit event group using dynamically allocated memory.  All
+ * the bits of the new event group are clear.
+ *
+ * @return If the event group is created successfully then a handle to the
+ * created event group is returned.  If there was not enough heap memory to
+ * create the event group then NULL is returned.
+ */
+EventGroup64Handle_t xEventGroup64Create( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup );
+</pre>
+ *
+ * Deletes an event group that was previously created using
+ * xEventGroup64Create().  Tasks that are blocked on the event group are
+ * unblocked, and obtain 0 as the event group's value.
+ *
+ * @param xEventGroup The handle of the event group to be deleted.
+ */
+void vEventGroup64Delete( EventGroup64Handle_t xEventGroup ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait );
+</pre>
+ *
+ * Reads bits within a 64-bit event group, optionally entering the Blocked
+ * state (with a timeout) to wait for a bit or group of bits to become set.
+ * Behaves in the same way as xEventGroupWaitBits().
+ *
+ * @param xEventGroup The event group in which the bits are being tested.
+ *
+ * @param uxBitsToWaitFor A bitwise value that indicates the bit or bits to test
+ * inside the event group.  Must not be 0.
+ *
+ * @param xClearOnExit If xClearOnExit is set to pdTRUE then the bits set in
+ * uxBitsToWaitFor are cleared in the event group before the function returns,
+ * provided the wait condition was met.
+ *
+ * @param xWaitForAllBits If xWaitForAllBits is set to pdTRUE then the function
+ * returns when all the bits in uxBitsToWaitFor are set or the block time
+ * expires.  If xWaitForAllBits is set to pdFALSE then the function returns
+ * when any of the bits in uxBitsToWaitFor are set or the block time expires.
+ *
+ * @param xTicksToWait The maximum amount of time (specified in 'ticks') to wait
+ * for the wait condition to be met.
+ *
+ * @return The value of the event group at the time either the bits being
+ * waited for became set, or the block time expired.  Test the return value to
+ * know which bits were set.
+ */
+EventBits64_t xEventGroup64WaitBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToWaitFor, const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet );
+</pre>
+ *
+ * Sets bits within a 64-bit event group, and unblocks the tasks whose wait
+ * conditions are met as a result.  Only the tasks indexed under bits that are
+ * newly set are tested.  Must not be called from an interrupt.
+ *
+ * @param xEventGroup The event group in which the bits are to be set.
+ *
+ * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
+ *
+ * @return The value of the event group after the bits were set and any bits
+ * cleared by the unblocked tasks' xClearOnExit parameters were cleared.
+ */
+EventBits64_t xEventGroup64SetBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToSet ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear );
+</pre>
+ *
+ * Clears bits within a 64-bit event group.  Must not be called from an
+ * interrupt.
+ *
+ * @param xEventGroup The event group in which the bits are to be cleared.
+ *
+ * @param uxBitsToClear A bitwise value that indicates the bit or bits to clear.
+ *
+ * @return The value of the event group before the bits were cleared.
+ */
+EventBits64_t xEventGroup64ClearBits( EventGroup64Handle_t xEventGroup, const EventBits64_t uxBitsToClear ) PRIVILEGED_FUNCTION;
+
+/**
+ * event_groups64.h
+ *
+<pre>
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup );
+</pre>
+ *
+ * Returns the current value of the bits in a 64-bit event group.  Must not be
+ * called from an interrupt.
+ */
+EventBits64_t xEventGroup64GetBits( EventGroup64Handle_t xEventGroup ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( EVENT_GROUPS_64_H ) */
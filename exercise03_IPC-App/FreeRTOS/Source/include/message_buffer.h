@@ -77,6 +77,13 @@ extern "C" {
  */
 typedef void * MessageBufferHandle_t;
 
+/**
+ * Used with xMessageBufferReserve() and xMessageBufferPeekSpans() to describe
+ * where a message is held in a message buffer's storage area.  See
+ * StreamBufferSpans_t.
+ */
+typedef StreamBufferSpans_t MessageBufferSpans_t;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -203,6 +210,30 @@ MessageBufferHandle_t xMessageBuffer;
  */
 #define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, pdTRUE, pucMessageBufferStorageArea, pxStaticMessageBuffer )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+MessageBufferHandle_t xMessageBufferCreateMultiProducer( size_t xBufferSizeBytes );
+MessageBufferHandle_t xMessageBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                               uint8_t *pucMessageBufferStorageArea,
+                                                               StaticMessageBuffer_t *pxStaticMessageBuffer );
+</pre>
+ *
+ * Versions of xMessageBufferCreate() and xMessageBufferCreateStatic() that
+ * create a message buffer any number of tasks and interrupts can write to at
+ * the same time without a mutex.  There must still be only one reader.  See
+ * xStreamBufferEnableMultiProducer() in stream_buffer.h.
+ *
+ * configUSE_MULTI_PRODUCER_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h
+ * for these macros to be available.
+ *
+ * \defgroup xMessageBufferCreateMultiProducer xMessageBufferCreateMultiProducer
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCreateMultiProducer( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferEnableMultiProducer( xMessageBufferCreate( xBufferSizeBytes ) )
+#define xMessageBufferCreateMultiProducerStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferEnableMultiProducer( xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) )
+
 /**
  * message_buffer.h
  *
@@ -791,6 +822,98 @@ BaseType_t xMessageBufferReceiveCompletedFromISR( MessageBufferHandle_t xStreamB
  */
 #define xMessageBufferReceiveCompletedFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) xStreamBufferReceiveCompletedFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferReserve( MessageBufferHandle_t xMessageBuffer, size_t xDataLengthBytes, MessageBufferSpans_t * const pxSpans, TickType_t xTicksToWait );
+size_t xMessageBufferReserveFromISR( MessageBufferHandle_t xMessageBuffer, size_t xDataLengthBytes, MessageBufferSpans_t * const pxSpans );
+size_t xMessageBufferCommit( MessageBufferHandle_t xMessageBuffer, size_t xBytesWritten );
+size_t xMessageBufferCommitFromISR( MessageBufferHandle_t xMessageBuffer, size_t xBytesWritten, BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Writes a message in place.  xMessageBufferReserve() obtains space for a
+ * message of up to xDataLengthBytes bytes as one or two spans of the message
+ * buffer's storage area, or returns 0 if there is not space for the whole
+ * message.  Once the writer has filled in the message xMessageBufferCommit()
+ * sends its first xBytesWritten bytes as a single message.  See
+ * xStreamBufferReserve() and xStreamBufferCommit() for details.
+ *
+ * \defgroup xMessageBufferReserve xMessageBufferReserve
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferReserve( xMessageBuffer, xDataLengthBytes, pxSpans, xTicksToWait ) xStreamBufferReserve( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxSpans, xTicksToWait )
+#define xMessageBufferReserveFromISR( xMessageBuffer, xDataLengthBytes, pxSpans ) xStreamBufferReserveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxSpans )
+#define xMessageBufferCommit( xMessageBuffer, xBytesWritten ) xStreamBufferCommit( ( StreamBufferHandle_t ) xMessageBuffer, xBytesWritten )
+#define xMessageBufferCommitFromISR( xMessageBuffer, xBytesWritten, pxHigherPriorityTaskWoken ) xStreamBufferCommitFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xBytesWritten, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferPeekSpans( MessageBufferHandle_t xMessageBuffer, MessageBufferSpans_t * const pxSpans, TickType_t xTicksToWait );
+size_t xMessageBufferPeekSpansFromISR( MessageBufferHandle_t xMessageBuffer, MessageBufferSpans_t * const pxSpans );
+size_t xMessageBufferConsume( MessageBufferHandle_t xMessageBuffer );
+size_t xMessageBufferConsumeFromISR( MessageBufferHandle_t xMessageBuffer, BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Reads a message in place.  xMessageBufferPeekSpans() returns the length of
+ * the next message and describes where it is held in the message buffer's
+ * storage area, without removing it.  Once the reader has finished with the
+ * message xMessageBufferConsume() removes it.  See xStreamBufferPeekSpans() and
+ * xStreamBufferConsume() for details.
+ *
+ * \defgroup xMessageBufferPeekSpans xMessageBufferPeekSpans
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferPeekSpans( xMessageBuffer, pxSpans, xTicksToWait ) xStreamBufferPeekSpans( ( StreamBufferHandle_t ) xMessageBuffer, pxSpans, xTicksToWait )
+#define xMessageBufferPeekSpansFromISR( xMessageBuffer, pxSpans ) xStreamBufferPeekSpansFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxSpans )
+#define xMessageBufferConsume( xMessageBuffer ) xStreamBufferConsume( ( StreamBufferHandle_t ) xMessageBuffer, 0 )
+#define xMessageBufferConsumeFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) xStreamBufferConsumeFromISR( ( StreamBufferHandle_t ) xMessageBuffer, 0, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferSendVectored( MessageBufferHandle_t xMessageBuffer, const StreamBufferTxSegment_t * const pxSegments, UBaseType_t uxSegments, TickType_t xTicksToWait );
+size_t xMessageBufferSendVectoredFromISR( MessageBufferHandle_t xMessageBuffer, const StreamBufferTxSegment_t * const pxSegments, UBaseType_t uxSegments, BaseType_t * const pxHigherPriorityTaskWoken );
+size_t xMessageBufferReceiveVectored( MessageBufferHandle_t xMessageBuffer, const StreamBufferRxSegment_t * const pxSegments, UBaseType_t uxSegments, TickType_t xTicksToWait );
+size_t xMessageBufferReceiveVectoredFromISR( MessageBufferHandle_t xMessageBuffer, const StreamBufferRxSegment_t * const pxSegments, UBaseType_t uxSegments, BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sends a message gathered from several segments, or receives a message
+ * scattered across several segments, without staging it in a temporary buffer.
+ * A message sent from uxSegments segments is received as a single message,
+ * and can be received with either xMessageBufferReceive() or
+ * xMessageBufferReceiveVectored().  See xStreamBufferSendVectored() and
+ * xStreamBufferReceiveVectored() for details.
+ *
+ * \defgroup xMessageBufferSendVectored xMessageBufferSendVectored
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendVectored( xMessageBuffer, pxSegments, uxSegments, xTicksToWait ) xStreamBufferSendVectored( ( StreamBufferHandle_t ) xMessageBuffer, pxSegments, uxSegments, xTicksToWait )
+#define xMessageBufferSendVectoredFromISR( xMessageBuffer, pxSegments, uxSegments, pxHigherPriorityTaskWoken ) xStreamBufferSendVectoredFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxSegments, uxSegments, pxHigherPriorityTaskWoken )
+#define xMessageBufferReceiveVectored( xMessageBuffer, pxSegments, uxSegments, xTicksToWait ) xStreamBufferReceiveVectored( ( StreamBufferHandle_t ) xMessageBuffer, pxSegments, uxSegments, xTicksToWait )
+#define xMessageBufferReceiveVectoredFromISR( xMessageBuffer, pxSegments, uxSegments, pxHigherPriorityTaskWoken ) xStreamBufferReceiveVectoredFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxSegments, uxSegments, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+UBaseType_t uxMessageBufferDrain( MessageBufferHandle_t xMessageBuffer, StreamBufferDrainCallback_t pxCallback, void *pvContext, TickType_t xTicksToWait );
+UBaseType_t uxMessageBufferDrainFromISR( MessageBufferHandle_t xMessageBuffer, StreamBufferDrainCallback_t pxCallback, void *pvContext, BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Passes every message currently in the message buffer to pxCallback, in
+ * place, then removes them all and notifies a waiting sender once.  Returns
+ * the number of messages received.  See uxStreamBufferDrain() for details.
+ *
+ * \defgroup uxMessageBufferDrain uxMessageBufferDrain
+ * \ingroup MessageBufferManagement
+ */
+#define uxMessageBufferDrain( xMessageBuffer, pxCallback, pvContext, xTicksToWait ) uxStreamBufferDrain( ( StreamBufferHandle_t ) xMessageBuffer, pxCallback, pvContext, xTicksToWait )
+#define uxMessageBufferDrainFromISR( xMessageBuffer, pxCallback, pvContext, pxHigherPriorityTaskWoken ) uxStreamBufferDrainFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxCallback, pvContext, pxHigherPriorityTaskWoken )
+
 #if defined( __cplusplus )
 } /* extern "C" */
 #endif
@@ -0,0 +1,145 @@
+/*
+ * Object pools - fixed size blocks for kernel objects.
+ *
+ * Tasks, queues, semaphores, software timers and event groups that are created
+ * dynamically each need one or two blocks of memory of a size that is the same
+ * for every object of that type:  a task needs a TCB and a stack, a queue or
+ * semaphore needs a queue structure followed by its storage area, and so on.
+ * When configUSE_OBJECT_POOLS is 1 each of those types has a pool of
+ * preallocated blocks of the right size, carved from a single statically
+ * allocated region the first time an object is created.  Creating an object
+ * takes a block from the front of its pool's free list, and deleting the object
+ * puts the block back, so neither searches the heap, and objects that are
+ * created and deleted repeatedly do not fragment it.
+ *
+ * The number of blocks in each pool is set by:
+ *
+ * configTASK_POOL_LENGTH         TCBs.
+ * configSTACK_POOL_LENGTH        Task stacks of up to configSTACK_POOL_DEPTH
+ *                                words.
+ * configQUEUE_POOL_LENGTH        Queues, queue sets, semaphores and mutexes that
+ *                                need no more than configQUEUE_POOL_STORAGE_SIZE
+ *                                bytes of storage.  Semaphores and mutexes need
+ *                                none.
+ * configTIMER_POOL_LENGTH        Software timers.
+ * configEVENT_GROUP_POOL_LENGTH  Event groups.
+ *
+ * An object that is too big for its pool's blocks, or that is created when its
+ * pool is empty, is allocated from the heap with pvPortMalloc() as normal, so a
+ * pool that is too small costs speed rather than failing.  Setting a length to
+ * 0 removes the pool altogether.
+ *
+ * Objects that are created statically are not affected, and queues created with
+ * xQueueCreateTimestamped() are always allocated from the heap.
+ */
+
+#ifndef OBJECT_POOLS_H
+#define OBJECT_POOLS_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include object_pools.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * The kernel object pools.
+ */
+typedef enum
+{
+	eTaskPool = 0,		/* TCBs. */
+	eStackPool,			/* Task stacks. */
+	eQueuePool,			/* Queues, queue sets, semaphores and mutexes, with their storage areas. */
+	eTimerPool,			/* Software timers. */
+	eEventGroupPool		/* Event groups. */
+} eObjectPool;
+
+#define poolNUMBER_OF_POOLS		( ( UBaseType_t ) 5 )
+
+/**
+ * Used with vObjectPoolGetInfo() to obtain the occupancy of an object pool.
+ */
+typedef struct xOBJECT_POOL_STATUS
+{
+	size_t xBlockSize;				/* The size of each block in the pool, in bytes. */
+	UBaseType_t uxBlocks;			/* The number of blocks in the pool. */
+	UBaseType_t uxBlocksInUse;		/* The number of blocks currently holding an object. */
+	UBaseType_t uxPeakBlocksInUse;	/* The most blocks that have held objects at any one time. */
+	uint32_t ulAllocations;			/* The number of objects that were given a block from the pool. */
+	uint32_t ulFallbacks;			/* The number of objects that were allocated from the heap instead, because they were too big for the pool's blocks or the pool was empty. */
+} ObjectPoolStatus_t;
+
+/*
+ * Used by the kernel to allocate and free the memory for objects.  If
+ * configUSE_OBJECT_POOLS is not 1 then they are the same as pvPortMalloc() and
+ * vPortFree().
+ */
+#if( configUSE_OBJECT_POOLS == 1 )
+	#define poolMALLOC( ePool, xWantedSize )	pvObjectPoolMalloc( ( ePool ), ( xWantedSize ) )
+	#define poolFREE( ePool, pv )				vObjectPoolFree( ( ePool ), ( pv ) )
+#else
+	#define poolMALLOC( ePool, xWantedSize )	pvPortMalloc( xWantedSize )
+	#define poolFREE( ePool, pv )				vPortFree( pv )
+#endif
+
+/**
+ * object_pools.h
+ *
+<pre>
+void *pvObjectPoolMalloc( eObjectPool ePool, size_t xWantedSize );
+</pre>
+ *
+ * Takes a block from an object pool, or allocates xWantedSize bytes from the
+ * heap if xWantedSize is larger than the pool's blocks or the pool is empty.
+ * Called by the kernel when it creates an object - not normally called
+ * directly.
+ *
+ * @param ePool The pool to take the block from.
+ *
+ * @param xWantedSize The number of bytes needed.
+ *
+ * @return A pointer to the memory, or NULL if the pool could not be used and
+ * there was not enough heap memory either.
+ */
+void *pvObjectPoolMalloc( eObjectPool ePool, size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * object_pools.h
+ *
+<pre>
+void vObjectPoolFree( eObjectPool ePool, void *pv );
+</pre>
+ *
+ * Returns memory obtained from pvObjectPoolMalloc() to the pool it came from,
+ * or to the heap if it was allocated from the heap.  Called by the kernel when
+ * it deletes an object - not normally called directly.
+ *
+ * @param ePool The pool the memory was requested from.
+ *
+ * @param pv The memory to free.  Can be NULL.
+ */
+void vObjectPoolFree( eObjectPool ePool, void *pv ) PRIVILEGED_FUNCTION;
+
+/**
+ * object_pools.h
+ *
+<pre>
+void vObjectPoolGetInfo( eObjectPool ePool, ObjectPoolStatus_t *pxPoolStatus );
+</pre>
+ *
+ * Populates an ObjectPoolStatus_t structure with the size and occupancy of an
+ * object pool.
+ *
+ * @param ePool The pool to query.
+ *
+ * @param pxPoolStatus The structure to populate.
+ */
+void vObjectPoolGetInfo( eObjectPool ePool, ObjectPoolStatus_t *pxPoolStatus ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( OBJECT_POOLS_H ) */
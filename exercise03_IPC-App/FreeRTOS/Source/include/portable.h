@@ -84,6 +84,10 @@ must be set in the compiler's include path. */
 	#define portNUM_CONFIGURABLE_REGIONS 1
 #endif
 
+#ifndef portHAS_STACK_OVERFLOW_CHECKING
+	#define portHAS_STACK_OVERFLOW_CHECKING 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -98,6 +102,10 @@ extern "C" {
  */
 #if( portUSING_MPU_WRAPPERS == 1 )
 	StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters, BaseType_t xRunPrivileged ) PRIVILEGED_FUNCTION;
+#elif( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+	/* Ports that check for stack overflow themselves are also passed the end
+	of the stack, so they know how large the stack is. */
+	StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters ) PRIVILEGED_FUNCTION;
 #else
 	StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters ) PRIVILEGED_FUNCTION;
 #endif
@@ -132,6 +140,84 @@ void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+/* The number of size classes in the free block histogram of HeapStats_t.
+Class 0 counts free blocks smaller than 32 bytes, class n counts free blocks of
+at least ( 16 << n ) bytes but smaller than ( 32 << n ) bytes, and the last class
+also counts all the free blocks that are larger than that. */
+#ifndef configHEAP_STATS_SIZE_CLASSES
+	#define configHEAP_STATS_SIZE_CLASSES 12
+#endif
+
+/* Used by vPortGetHeapStats() to describe the state of the heap.  Block sizes
+include the block header and any alignment padding, so are the number of bytes
+a request actually takes from the heap. */
+typedef struct xHeapStats
+{
+	size_t xAvailableHeapSpaceInBytes;			/* The total heap size currently available - this is the sum of all the free blocks, not the largest block that can be allocated. */
+	size_t xSizeOfLargestFreeBlockInBytes;		/* The maximum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xSizeOfSmallestFreeBlockInBytes;		/* The minimum size, in bytes, of all the free blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xNumberOfFreeBlocks;					/* The number of free memory blocks within the heap at the time vPortGetHeapStats() is called. */
+	size_t xMinimumEverFreeBytesRemaining;		/* The minimum amount of total free memory (sum of all free blocks) there has been in the heap since the system booted. */
+	size_t xNumberOfSuccessfulAllocations;		/* The number of calls to pvPortMalloc() that have returned a valid memory block. */
+	size_t xNumberOfSuccessfulFrees;			/* The number of calls to vPortFree() that have successfully freed a block of memory. */
+	uint64_t ullBytesAllocated;					/* The total number of bytes taken from the heap by all the successful allocations. */
+	uint64_t ullBytesFreed;						/* The total number of bytes returned to the heap by all the successful frees. */
+	size_t xFreeBlocksBySize[ configHEAP_STATS_SIZE_CLASSES ];	/* The number of free blocks in each size class - see configHEAP_STATS_SIZE_CLASSES. */
+} HeapStats_t;
+
+/* Used by uxPortGetHeapLedger() to report the memory allocated from one call
+site when configUSE_HEAP_CALLER_LEDGER is 1. */
+typedef struct xHeapLedgerEntry
+{
+	void *pvCaller;						/* The return address of the calls to pvPortMalloc() recorded in this entry, or NULL for the entry that records the callers that did not fit in the ledger. */
+	size_t xNumberOfAllocations;		/* The number of successful allocations made from the call site. */
+	size_t xBlocksInUse;				/* The number of those blocks that have not been freed. */
+	size_t xBytesInUse;					/* The number of bytes taken from the heap by the blocks that have not been freed. */
+	size_t xPeakBytesInUse;				/* The highest value xBytesInUse has had. */
+} HeapLedgerEntry_t;
+
+/*
+ * Populates a HeapStats_t structure with the size of the largest and smallest
+ * free blocks, the number of free blocks and their distribution by size, and
+ * the number of allocations and frees made so far.  The free blocks are
+ * counted with the scheduler suspended, so the time taken grows with the
+ * number of free blocks.  Implemented by heap_4.c, heap_5.c and heap_6.c.
+ * heap_6.c only uses a free block for requests up to roughly 1/16 smaller than
+ * the block, so the largest request that is certain to succeed is a little
+ * smaller than the largest free block.
+ */
+void vPortGetHeapStats( HeapStats_t *pxHeapStats ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies up to uxLedgerLength entries of the per call site allocation ledger
+ * into pxLedger and returns the number of entries copied.  Only available
+ * when configUSE_HEAP_CALLER_LEDGER is 1 - see FreeRTOS.h.
+ */
+UBaseType_t uxPortGetHeapLedger( HeapLedgerEntry_t *pxLedger, UBaseType_t uxLedgerLength ) PRIVILEGED_FUNCTION;
+
+/* The number of size classes in each task's heap cache when
+configUSE_HEAP_TASK_CACHE is 1.  Class n holds blocks of at least ( 16 << n )
+bytes but smaller than ( 32 << n ) bytes, including the block header. */
+#ifndef configHEAP_TASK_CACHE_CLASSES
+	#define configHEAP_TASK_CACHE_CLASSES 5
+#endif
+
+/* The small blocks a task has freed and kept for its own later requests when
+configUSE_HEAP_TASK_CACHE is 1.  Held in the task's TCB, and only accessed by
+the task itself until the task is deleted. */
+typedef struct xHeapTaskCache
+{
+	void *pvBlocks[ configHEAP_TASK_CACHE_CLASSES ];			/* The head of each class's singly linked list of blocks. */
+	uint8_t ucBlockCounts[ configHEAP_TASK_CACHE_CLASSES ];	/* The number of blocks in each class's list. */
+} HeapTaskCache_t;
+
+/*
+ * Returns the blocks held in a task's heap cache to the heap.  Called by the
+ * kernel when the task is deleted.  Only available when
+ * configUSE_HEAP_TASK_CACHE is 1, which is only supported by heap_5.c.
+ */
+void vPortFreeTaskHeapCache( HeapTaskCache_t *pxCache ) PRIVILEGED_FUNCTION;
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
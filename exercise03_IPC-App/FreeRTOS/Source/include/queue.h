@@ -61,6 +61,45 @@ typedef struct QueueDefinition * QueueSetHandle_t;
  */
 typedef struct QueueDefinition * QueueSetMemberHandle_t;
 
+/**
+ * Used with xQueueGetResidenceStats() to obtain the time items spent in a queue
+ * that was created using xQueueCreateTimestamped().  Times are measured with
+ * the run time stats counter if configGENERATE_RUN_TIME_STATS is 1, otherwise
+ * in ticks.  The average residence time is ullTotalAge divided by ulItems.
+ *
+ * ulHistogram[ 0 ] counts items received with an age of 0, and
+ * ulHistogram[ n ] counts items with an age from 2^(n-1) up to (2^n)-1.  The
+ * last bucket also counts every older item.
+ */
+typedef struct xQUEUE_RESIDENCE_STATS
+{
+	uint32_t ulItems;		/* The number of items received from the queue. */
+	uint32_t ulMinAge;		/* The shortest time an item spent in the queue. */
+	uint32_t ulMaxAge;		/* The longest time an item spent in the queue. */
+	uint64_t ullTotalAge;	/* The sum of the time every received item spent in the queue. */
+	uint32_t ulHistogram[ configQUEUE_RESIDENCE_HISTOGRAM_BUCKETS ];
+} QueueResidenceStats_t;
+
+/**
+ * Used with vQueueGetStats() and uxQueueGetRegistryStats() to obtain the
+ * occupancy and contention statistics of a queue, semaphore or mutex.  The
+ * counters accumulate from the time the queue is created, or from the last call
+ * to vQueueResetStats().
+ */
+typedef struct xQUEUE_STATS
+{
+	QueueHandle_t xHandle;				/* The handle of the queue to which the statistics relate. */
+	const char *pcQueueName;			/* The name of the queue in the queue registry, or NULL if it is not registered. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	UBaseType_t uxLength;				/* The number of items the queue can hold. */
+	UBaseType_t uxMessagesWaiting;		/* The number of items in the queue when the statistics were obtained. */
+	UBaseType_t uxPeakMessagesWaiting;	/* The largest number of items the queue has held. */
+	uint32_t ulSendsBlocked;			/* The number of times a sending task entered the Blocked state because the queue was full. */
+	uint32_t ulSendsTimedOut;			/* The number of sends that failed because the queue was still full when the block time expired. */
+	uint32_t ulReceivesBlocked;			/* The number of times a receiving task entered the Blocked state because the queue was empty. */
+	uint32_t ulReceivesTimedOut;		/* The number of receives that failed because the queue was still empty when the block time expired. */
+	TickType_t xBlockedTicks;			/* The total time, in ticks, that tasks spent in the Blocked state waiting on the queue. */
+} QueueStats_t;
+
 /* For internal use only. */
 #define	queueSEND_TO_BACK		( ( BaseType_t ) 0 )
 #define	queueSEND_TO_FRONT		( ( BaseType_t ) 1 )
@@ -867,6 +906,35 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue, void * const pvBuffer ) PRIV
  */
 BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueReceiveWithAge(
+								 QueueHandle_t xQueue,
+								 void *pvBuffer,
+								 uint32_t *pulAge,
+								 TickType_t xTicksToWait
+							);</pre>
+ *
+ * Behaves exactly as xQueueReceive(), but if the queue was created using
+ * xQueueCreateTimestamped() then also returns how long the received item spent
+ * in the queue.  The age is in run time stats counter units if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise in ticks.  *pulAge is set to 0
+ * if the queue does not record timestamps.
+ *
+ * configUSE_QUEUE_TIMESTAMPS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param pulAge Set to the age of the received item, if an item is received.
+ * Can be NULL if the age is not required.
+ *
+ * \defgroup xQueueReceiveWithAge xQueueReceiveWithAge
+ * \ingroup QueueManagement
+ */
+#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+	BaseType_t xQueueReceiveWithAge( QueueHandle_t xQueue, void * const pvBuffer, uint32_t * const pulAge, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * queue. h
  * <pre>UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue );</pre>
@@ -1487,6 +1555,52 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
 	const char *pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
+/*
+ * Populates *pxQueueStats with the occupancy and contention statistics of a
+ * queue, semaphore or mutex.  vQueueResetStats() clears the counters and sets
+ * the peak occupancy to the current occupancy, for example at the start of a
+ * measurement period.
+ *
+ * configUSE_QUEUE_STATS must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ */
+#if( configUSE_QUEUE_STATS == 1 )
+	void vQueueGetStats( QueueHandle_t xQueue, QueueStats_t *pxQueueStats ) PRIVILEGED_FUNCTION;
+	void vQueueResetStats( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Populates a QueueStats_t structure for each queue in the queue registry.
+ * Returns the number of structures populated, which is at most uxArraySize.
+ * configQUEUE_REGISTRY_SIZE is the largest number of structures that can be
+ * needed.
+ *
+ * configUSE_QUEUE_STATS must be set to 1, and configQUEUE_REGISTRY_SIZE must be
+ * greater than 0, for this function to be available.
+ */
+#if( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
+	UBaseType_t uxQueueGetRegistryStats( QueueStats_t * const pxQueueStatsArray, const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Writes the statistics of every queue in the queue registry to pcWriteBuffer
+ * as a human readable table, one queue per line, giving the name, length,
+ * current and peak number of items, blocked and timed out sends, blocked and
+ * timed out receives, and the total ticks spent blocked.
+ *
+ * Like vTaskList(), this function is a debug aid that depends on sprintf().
+ * Production code should call uxQueueGetRegistryStats() directly.  The buffer
+ * is assumed to be large enough; approximately 60 bytes per registered queue
+ * is sufficient.
+ *
+ * configUSE_QUEUE_STATS must be set to 1, configQUEUE_REGISTRY_SIZE must be
+ * greater than 0 and configUSE_STATS_FORMATTING_FUNCTIONS must be greater than 0
+ * for this function to be available.
+ */
+#if( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+	void vQueueListStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
 /*
  * Generic version of the function used to creaet a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -1496,6 +1610,43 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
 	QueueHandle_t xQueueGenericCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * Creates a queue, using dynamic memory allocation, that records the time at
+ * which each item was sent to it.  Receiving from the queue then updates the
+ * residence statistics returned by xQueueGetResidenceStats(), and
+ * xQueueReceiveWithAge() can be used to obtain the age of each received item.
+ * An additional four bytes of RAM are used per item in the queue.
+ *
+ * Timestamped queues hold data, so cannot be used as semaphores.
+ *
+ * configUSE_QUEUE_TIMESTAMPS must be set to 1 in FreeRTOSConfig.h for the
+ * functions below to be available.
+ */
+#if( ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+	QueueHandle_t xQueueCreateTimestamped( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * The same as xQueueCreateTimestamped(), but using memory provided by the
+ * application.  pucQueueStorage must hold uxQueueLength items of uxItemSize
+ * bytes, pulEnqueueTimes must hold uxQueueLength timestamps, and
+ * pxResidenceStats holds the queue's residence statistics.
+ */
+#if( ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	QueueHandle_t xQueueCreateTimestampedStatic( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, uint32_t *pulEnqueueTimes, QueueResidenceStats_t *pxResidenceStats, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Copies the residence statistics of a queue created using
+ * xQueueCreateTimestamped() into *pxStats.  Returns pdFAIL if the queue does
+ * not record timestamps.  vQueueResetResidenceStats() clears the statistics,
+ * for example at the start of a measurement period.
+ */
+#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+	BaseType_t xQueueGetResidenceStats( QueueHandle_t xQueue, QueueResidenceStats_t *pxStats ) PRIVILEGED_FUNCTION;
+	void vQueueResetResidenceStats( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Generic version of the function used to creaet a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -1526,17 +1677,21 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  * Note 2:  Blocking on a queue set that contains a mutex will not cause the
  * mutex holder to inherit the priority of the blocked task.
  *
- * Note 3:  An additional 4 bytes of RAM is required for each space in a every
- * queue added to a queue set.  Therefore counting semaphores that have a high
- * maximum count value should not be added to a queue set.
+ * Note 3:  A queue set does not store copies of the events posted to it.  Each
+ * member only records how many of its events are pending, and members with
+ * pending events are linked into a ready list held by the set.  Posting to a
+ * member and selecting from the set are therefore both constant time, and the
+ * set needs no storage area however long its members are.  When several
+ * members are ready xQueueSelectFromSet() returns them in round robin order.
  *
  * Note 4:  A receive (in the case of a queue) or take (in the case of a
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
- * @param uxEventQueueLength Queue sets store events that occur on
+ * @param uxEventQueueLength Queue sets count events that occur on
  * the queues and semaphores contained in the set.  uxEventQueueLength specifies
- * the maximum number of events that can be queued at once.  To be absolutely
+ * the maximum number of events that can be outstanding at once.  It does not
+ * affect the amount of RAM used by the set.  To be absolutely
  * certain that events are not lost uxEventQueueLength should be set to the
  * total sum of the length of the queues added to the set, where binary
  * semaphores and mutexes have a length of 1, and counting semaphores have a
@@ -1555,6 +1710,15 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  */
 QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength ) PRIVILEGED_FUNCTION;
 
+/*
+ * The same as xQueueCreateSet(), but the set's state is held in the
+ * StaticQueue_t pointed to by pxStaticQueueSet instead of being allocated from
+ * the heap.  A queue set has no storage area, so nothing else is needed.
+ */
+#if( ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	QueueSetHandle_t xQueueCreateSetStatic( const UBaseType_t uxEventQueueLength, StaticQueue_t *pxStaticQueueSet ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Adds a queue or semaphore to a queue set that was previously created by a
  * call to xQueueCreateSet().
@@ -0,0 +1,148 @@
+/*
+ * Static object tables - tasks and queues allocated at compile time.
+ *
+ * An application that creates a fixed set of tasks and queues at start up can
+ * list them in a table instead of creating each one with xTaskCreate() or
+ * xQueueCreate().  The macros in this file expand the table into the
+ * StaticTask_t, stack, StaticQueue_t and storage area variables each object
+ * needs, and into the xTaskCreateStatic() and xQueueCreateStatic() calls that
+ * create the objects in them.  Creating the objects then takes no memory from
+ * the heap, and the memory they use appears in the linker map.
+ *
+ * A table is a macro that takes the name of another macro, X, and applies X to
+ * each entry.  Tasks are listed as:
+ *
+ * X( xName, pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, xHandle )
+ *
+ * and queues as:
+ *
+ * X( xName, xKind, uxLength, uxItemSize, pcRegistryName, xHandle )
+ *
+ * xName is an identifier that is unique within the file, and is used to name
+ * the variables generated for the entry.  xHandle is an lvalue the handle of
+ * the created object is written to.  xKind is one of:
+ *
+ * BASIC        A queue created with xQueueCreateStatic().
+ * TIMESTAMPED  A queue created with xQueueCreateTimestampedStatic().
+ * SET          A queue set created with xQueueCreateSetStatic().  uxItemSize is
+ *              not used and should be 0.
+ *
+ * If configQUEUE_REGISTRY_SIZE is greater than 0 then each queue is added to
+ * the queue registry under pcRegistryName.
+ *
+ * For example:
+ *
+ * #define mainTASKS( X )																\
+ *     X( Producer, vProducerTask, "Producer", configMINIMAL_STACK_SIZE, NULL, 2, xProducer )	\
+ *     X( Consumer, vConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, NULL, 1, xConsumer )
+ *
+ * #define mainQUEUES( X )											\
+ *     X( Data, BASIC, 10, sizeof( uint32_t ), "DataQ", xDataQueue )
+ *
+ * staticDECLARE_TASKS( mainTASKS )		// At file scope.
+ * staticDECLARE_QUEUES( mainQUEUES )	// At file scope.
+ *
+ * void main( void )
+ * {
+ *     staticCREATE_QUEUES( mainQUEUES );
+ *     staticCREATE_TASKS( mainTASKS );
+ *     vTaskStartScheduler();
+ * }
+ *
+ * staticTASKS_SIZE() and staticQUEUES_SIZE() give the number of bytes a table
+ * uses, as a compile time constant.
+ */
+
+#ifndef STATIC_OBJECTS_H
+#define STATIC_OBJECTS_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include static_objects.h"
+#endif
+
+#if( configSUPPORT_STATIC_ALLOCATION != 1 )
+	#error configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h to use static_objects.h
+#endif
+
+/*
+ * Expand a whole table.  The DECLARE macros are used at file scope, the CREATE
+ * macros inside a function before the scheduler is started.  Queues should be
+ * created before the tasks that use them.
+ */
+#define staticDECLARE_TASKS( TABLE )	TABLE( staticDECLARE_TASK )
+#define staticCREATE_TASKS( TABLE )		do { TABLE( staticCREATE_TASK ) } while( 0 )
+#define staticTASKS_SIZE( TABLE )		( ( size_t ) 0 TABLE( staticTASK_SIZE ) )
+
+#define staticDECLARE_QUEUES( TABLE )	TABLE( staticDECLARE_QUEUE )
+#define staticCREATE_QUEUES( TABLE )	do { TABLE( staticCREATE_QUEUE ) } while( 0 )
+#define staticQUEUES_SIZE( TABLE )		( ( size_t ) 0 TABLE( staticQUEUE_SIZE ) )
+
+/*
+ * Expand one task table entry.
+ */
+#define staticDECLARE_TASK( xName, pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, xHandle )	\
+	static StaticTask_t xName##TCB;																			\
+	static StackType_t xName##Stack[ usStackDepth ];
+
+#define staticCREATE_TASK( xName, pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, xHandle )	\
+	( xHandle ) = xTaskCreateStatic( ( pxTaskCode ), ( pcName ), ( usStackDepth ), ( pvParameters ), ( uxPriority ), xName##Stack, &( xName##TCB ) );	\
+	configASSERT( xHandle );
+
+#define staticTASK_SIZE( xName, pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, xHandle )	\
+	+ sizeof( StaticTask_t ) + ( ( size_t ) ( usStackDepth ) * sizeof( StackType_t ) )
+
+/*
+ * Expand one queue table entry, by passing it on to the macro for its kind.
+ */
+#define staticDECLARE_QUEUE( xName, xKind, uxLength, uxItemSize, pcRegistryName, xHandle )	\
+	staticDECLARE_##xKind( xName, uxLength, uxItemSize )
+
+#define staticCREATE_QUEUE( xName, xKind, uxLength, uxItemSize, pcRegistryName, xHandle )	\
+	( xHandle ) = staticCREATE_##xKind( xName, uxLength, uxItemSize );						\
+	configASSERT( xHandle );																\
+	staticREGISTER_QUEUE( ( xHandle ), ( pcRegistryName ) );
+
+#define staticQUEUE_SIZE( xName, xKind, uxLength, uxItemSize, pcRegistryName, xHandle )	\
+	+ staticSIZE_##xKind( uxLength, uxItemSize )
+
+/* BASIC queues. */
+#define staticDECLARE_BASIC( xName, uxLength, uxItemSize )	\
+	static StaticQueue_t xName##Queue;						\
+	static uint8_t xName##Storage[ ( uxLength ) * ( uxItemSize ) ];
+
+#define staticCREATE_BASIC( xName, uxLength, uxItemSize )	\
+	xQueueCreateStatic( ( uxLength ), ( uxItemSize ), xName##Storage, &( xName##Queue ) )
+
+#define staticSIZE_BASIC( uxLength, uxItemSize )	\
+	( sizeof( StaticQueue_t ) + ( ( size_t ) ( uxLength ) * ( size_t ) ( uxItemSize ) ) )
+
+/* TIMESTAMPED queues. */
+#define staticDECLARE_TIMESTAMPED( xName, uxLength, uxItemSize )	\
+	static StaticQueue_t xName##Queue;								\
+	static uint8_t xName##Storage[ ( uxLength ) * ( uxItemSize ) ];	\
+	static uint32_t xName##EnqueueTimes[ uxLength ];				\
+	static QueueResidenceStats_t xName##ResidenceStats;
+
+#define staticCREATE_TIMESTAMPED( xName, uxLength, uxItemSize )	\
+	xQueueCreateTimestampedStatic( ( uxLength ), ( uxItemSize ), xName##Storage, xName##EnqueueTimes, &( xName##ResidenceStats ), &( xName##Queue ) )
+
+#define staticSIZE_TIMESTAMPED( uxLength, uxItemSize )	\
+	( staticSIZE_BASIC( ( uxLength ), ( uxItemSize ) ) + ( ( size_t ) ( uxLength ) * sizeof( uint32_t ) ) + sizeof( QueueResidenceStats_t ) )
+
+/* Queue SETs. */
+#define staticDECLARE_SET( xName, uxLength, uxItemSize )	\
+	static StaticQueue_t xName##Queue;
+
+#define staticCREATE_SET( xName, uxLength, uxItemSize )	\
+	xQueueCreateSetStatic( ( uxLength ), &( xName##Queue ) )
+
+#define staticSIZE_SET( uxLength, uxItemSize )	\
+	sizeof( StaticQueue_t )
+
+#if( configQUEUE_REGISTRY_SIZE > 0 )
+	#define staticREGISTER_QUEUE( xQueue, pcRegistryName )	vQueueAddToRegistry( ( QueueHandle_t ) ( xQueue ), ( pcRegistryName ) )
+#else
+	#define staticREGISTER_QUEUE( xQueue, pcRegistryName )	( ( void ) ( pcRegistryName ) )
+#endif
+
+#endif	/* !defined( STATIC_OBJECTS_H ) */
@@ -44,7 +44,10 @@
  * block time to 0.  Likewise, if there are to be multiple different readers
  * then the application writer must place each call to a reading API function
  * (such as xStreamBufferRead()) inside a critical section section and set the
- * receive block time to 0.
+ * receive block time to 0.  Alternatively, a buffer that is to have multiple
+ * writers can be created with xStreamBufferCreateMultiProducer() or
+ * xMessageBufferCreateMultiProducer(), in which case the writers do not need to
+ * be serialised.
  *
  */
 
@@ -64,6 +67,46 @@ extern "C" {
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/**
+ * Used with xStreamBufferReserve() and xStreamBufferPeekSpans() to describe a
+ * region of a stream buffer's storage area that can be written or read in
+ * place.  A region that wraps past the end of the storage area is described as
+ * two spans, the second of which starts at the beginning of the storage area.
+ * Otherwise pucSecond is NULL and xSecondLength is 0.
+ */
+typedef struct xSTREAM_BUFFER_SPANS
+{
+	uint8_t *pucFirst;		/* The start of the first span, or NULL if the region is empty. */
+	size_t xFirstLength;	/* The number of bytes in the first span. */
+	uint8_t *pucSecond;		/* The start of the second span, or NULL if the region does not wrap. */
+	size_t xSecondLength;	/* The number of bytes in the second span. */
+} StreamBufferSpans_t;
+
+/**
+ * Used with xStreamBufferSendVectored() and xStreamBufferReceiveVectored() to
+ * describe one of the pieces of memory a message or stream is gathered from
+ * or scattered to.  A segment with an xLength of 0 is skipped.
+ */
+typedef struct xSTREAM_BUFFER_TX_SEGMENT
+{
+	const void *pvData;		/* The data to send. */
+	size_t xLength;			/* The number of bytes to send from pvData. */
+} StreamBufferTxSegment_t;
+
+typedef struct xSTREAM_BUFFER_RX_SEGMENT
+{
+	void *pvData;			/* Where to place received data. */
+	size_t xLength;			/* The maximum number of bytes to place at pvData. */
+} StreamBufferRxSegment_t;
+
+/**
+ * Defines the prototype to which functions passed to uxStreamBufferDrain() must
+ * conform.  pxSpans describes where the xLength bytes of one message are held
+ * in the buffer's storage area.  The data is only valid until the callback
+ * returns.
+ */
+typedef void (* StreamBufferDrainCallback_t)( const StreamBufferSpans_t *pxSpans, size_t xLength, void *pvContext );
+
 
 /**
  * message_buffer.h
@@ -213,6 +256,80 @@ const size_t xTriggerLevel = 1;
  */
 #define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, pxStaticStreamBuffer )
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+StreamBufferHandle_t xStreamBufferEnableMultiProducer( StreamBufferHandle_t xStreamBuffer );
+</pre>
+ *
+ * Allows a stream buffer or message buffer to be written by any number of tasks
+ * and interrupts at the same time, without the writers having to be serialised
+ * by a mutex or critical section.  There must still be only one reader.  Must
+ * be called after the buffer is created and before it is first used.  The
+ * xStreamBufferCreateMultiProducer(), xStreamBufferCreateMultiProducerStatic(),
+ * xMessageBufferCreateMultiProducer() and xMessageBufferCreateMultiProducerStatic()
+ * macros create a buffer and call this function in one step.
+ *
+ * Each call to xStreamBufferSend() or xStreamBufferSendFromISR() on a
+ * multi-producer buffer claims the space it needs in a short critical section,
+ * copies its data with interrupts enabled, and then publishes the data to the
+ * reader.  Data is published in the order its space was claimed, as soon as it
+ * and all the data claimed before it have been written, so the reader sees
+ * messages in order and never sees a message that is only partly written.
+ *
+ * A writer that is preempted, blocked, suspended or deleted part way through a
+ * write therefore holds up the data claimed after it.  In particular, a low
+ * priority task preempted while copying its data hides the data written by
+ * higher priority tasks and interrupts after it until it runs again, which is a
+ * form of priority inversion.  Keep the writes short, raise the priority of
+ * writers that share a buffer with time critical writers, and never abandon a
+ * write.
+ *
+ * At most configSTREAM_BUFFER_MAX_CONCURRENT_WRITES writes (8 by default) can
+ * be part way through at once.  Further writers wait for space as if the
+ * buffer were full, or fail if called from an interrupt.
+ *
+ * Any number of tasks can be blocked waiting for space at once.  They are all
+ * unblocked when data is read, and check again whether there is enough space
+ * for them, the highest priority task first.
+ *
+ * xStreamBufferReserve() and xStreamBufferCommit() cannot be used with a
+ * multi-producer buffer.
+ *
+ * configUSE_MULTI_PRODUCER_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h
+ * for xStreamBufferEnableMultiProducer() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer or message buffer.  NULL
+ * is allowed, in which case nothing is done.
+ *
+ * @return xStreamBuffer.
+ *
+ * Example use:
+<pre>
+// All the tasks in the system write log lines to xLogBuffer, and a single
+// logging task reads them out.  No mutex is needed around the writes.
+MessageBufferHandle_t xLogBuffer;
+
+void vLogInit( void )
+{
+    xLogBuffer = xMessageBufferCreateMultiProducer( 1024 );
+    configASSERT( xLogBuffer );
+}
+
+void vLog( const char *pcLine )
+{
+    ( void ) xMessageBufferSend( xLogBuffer, pcLine, strlen( pcLine ), 0 );
+}
+</pre>
+ * \defgroup xStreamBufferEnableMultiProducer xStreamBufferEnableMultiProducer
+ * \ingroup StreamBufferManagement
+ */
+StreamBufferHandle_t xStreamBufferEnableMultiProducer( StreamBufferHandle_t xStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#define xStreamBufferCreateMultiProducer( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferEnableMultiProducer( xStreamBufferCreate( xBufferSizeBytes, xTriggerLevelBytes ) )
+#define xStreamBufferCreateMultiProducerStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferEnableMultiProducer( xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) )
+
 /**
  * stream_buffer.h
  *
@@ -829,6 +946,377 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
  */
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xDataLengthBytes,
+                             StreamBufferSpans_t * const pxSpans,
+                             TickType_t xTicksToWait );
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xDataLengthBytes,
+                                    StreamBufferSpans_t * const pxSpans );
+</pre>
+ *
+ * Reserves space in a stream buffer so the writer can generate data directly in
+ * the buffer's storage area, rather than generating it elsewhere and having
+ * xStreamBufferSend() copy it in.  The reserved space is described by *pxSpans
+ * and the data written there is sent by calling xStreamBufferCommit().  The
+ * reader does not see any of the reserved space until it is committed, and
+ * reserving again before committing returns the same space.
+ *
+ * The same single writer rule applies as to xStreamBufferSend().  Reserving
+ * and committing must not be mixed with calls to xStreamBufferSend() between a
+ * reserve and its commit.
+ *
+ * When used with a stream buffer as many bytes as possible, up to
+ * xDataLengthBytes, are reserved.  When used with a message buffer either the
+ * whole message is reserved or nothing is.
+ *
+ * xStreamBufferReserveFromISR() is the version that can be called from an
+ * interrupt service routine.  It never blocks.
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which to reserve
+ * space.
+ *
+ * @param xDataLengthBytes The number of bytes to reserve.
+ *
+ * @param pxSpans Set to the one or two spans of the storage area that make up
+ * the reserved space.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for xDataLengthBytes of space to become available, in
+ * the same way as for xStreamBufferSend().
+ *
+ * @return The number of bytes reserved.
+ *
+ * \defgroup xStreamBufferReserve xStreamBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+							 size_t xDataLengthBytes,
+							 StreamBufferSpans_t * const pxSpans,
+							 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes,
+									StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten );
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                   size_t xBytesWritten,
+                                   BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sends the first xBytesWritten bytes of the space previously obtained from
+ * xStreamBufferReserve(), which the writer must already have filled in.  Any
+ * remaining reserved space is released.  A task blocked waiting for data is
+ * unblocked through sbSEND_COMPLETED(), exactly as if the data had been sent
+ * with xStreamBufferSend().
+ *
+ * xBytesWritten must not be more than the number of bytes returned by the
+ * last call to xStreamBufferReserve().  If it is, configASSERT() is called,
+ * and if asserts are disabled only the reserved bytes are sent.  Each
+ * reservation can be committed once.  When used with a message buffer the
+ * committed bytes form a single message.  Committing 0 bytes sends nothing.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being written to.
+ *
+ * @param xBytesWritten The number of reserved bytes to send.
+ *
+ * @param pxHigherPriorityTaskWoken Used in the same way as the parameter of
+ * the same name of xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes sent.
+ *
+ * \defgroup xStreamBufferCommit xStreamBufferCommit
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+								   size_t xBytesWritten,
+								   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferPeekSpans( StreamBufferHandle_t xStreamBuffer,
+                               StreamBufferSpans_t * const pxSpans,
+                               TickType_t xTicksToWait );
+size_t xStreamBufferPeekSpansFromISR( StreamBufferHandle_t xStreamBuffer,
+                                      StreamBufferSpans_t * const pxSpans );
+</pre>
+ *
+ * Obtains the data held in a stream buffer in place, so the reader can process
+ * it without xStreamBufferReceive() first copying it out.  The data is not
+ * removed from the buffer until xStreamBufferConsume() is called, and remains
+ * valid until then.
+ *
+ * When used with a stream buffer all the bytes in the buffer are returned.
+ * When used with a message buffer only the next message is returned.
+ *
+ * The same single reader rule applies as to xStreamBufferReceive().
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param pxSpans Set to the one or two spans of the storage area that hold the
+ * data.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data, in the same way as for
+ * xStreamBufferReceive().  xStreamBufferPeekSpansFromISR() never blocks.
+ *
+ * @return The number of bytes described by *pxSpans.
+ *
+ * \defgroup xStreamBufferPeekSpans xStreamBufferPeekSpans
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeekSpans( StreamBufferHandle_t xStreamBuffer,
+							   StreamBufferSpans_t * const pxSpans,
+							   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferPeekSpansFromISR( StreamBufferHandle_t xStreamBuffer,
+									  StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesConsumed );
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xBytesConsumed,
+                                    BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Removes data obtained from xStreamBufferPeekSpans() from a stream buffer.  A
+ * task blocked waiting for space is unblocked through sbRECEIVE_COMPLETED(),
+ * exactly as if the data had been read with xStreamBufferReceive().
+ *
+ * When used with a stream buffer the first xBytesConsumed bytes are removed, so
+ * data can be consumed a little at a time.  When used with a message buffer
+ * the whole of the next message is removed and xBytesConsumed is not used.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to remove data from.
+ *
+ * @param xBytesConsumed The number of bytes to remove.
+ *
+ * @param pxHigherPriorityTaskWoken Used in the same way as the parameter of
+ * the same name of xStreamBufferReceiveFromISR().
+ *
+ * @return The number of bytes removed.
+ *
+ * \defgroup xStreamBufferConsume xStreamBufferConsume
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesConsumed ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xBytesConsumed,
+									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendVectored( StreamBufferHandle_t xStreamBuffer,
+                                  const StreamBufferTxSegment_t * const pxSegments,
+                                  UBaseType_t uxSegments,
+                                  TickType_t xTicksToWait );
+size_t xStreamBufferSendVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         const StreamBufferTxSegment_t * const pxSegments,
+                                         UBaseType_t uxSegments,
+                                         BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Versions of xStreamBufferSend() and xStreamBufferSendFromISR() that gather
+ * the data to send from several separate pieces of memory, so, for example, a
+ * header and a payload can be sent as a single message without first being
+ * copied into a temporary buffer.  The segments are copied straight into the
+ * buffer in array order.
+ *
+ * When used with a message buffer the segments form one message, whose length
+ * is the total length of the segments, and the message is only written if
+ * there is space for all of it.  When used with a stream buffer as many bytes
+ * as there is space for are written.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to which the data is
+ * being sent.
+ *
+ * @param pxSegments An array of uxSegments segments describing the data to
+ * send.
+ *
+ * @param uxSegments The number of segments in the pxSegments array.
+ *
+ * @param xTicksToWait Used in the same way as the parameter of the same name
+ * of xStreamBufferSend().
+ *
+ * @param pxHigherPriorityTaskWoken Used in the same way as the parameter of the
+ * same name of xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes written to the buffer, not counting the length
+ * of the message in the case of a message buffer.
+ *
+ * Example use:
+<pre>
+void vSendReading( MessageBufferHandle_t xMessageBuffer, const Header_t *pxHeader, const uint8_t *pucPayload, size_t xPayloadLength )
+{
+StreamBufferTxSegment_t xSegments[ 2 ];
+
+    xSegments[ 0 ].pvData = pxHeader;
+    xSegments[ 0 ].xLength = sizeof( Header_t );
+    xSegments[ 1 ].pvData = pucPayload;
+    xSegments[ 1 ].xLength = xPayloadLength;
+
+    // The header and payload arrive at the reader as one message.
+    xMessageBufferSendVectored( xMessageBuffer, xSegments, 2, portMAX_DELAY );
+}
+</pre>
+ * \defgroup xStreamBufferSendVectored xStreamBufferSendVectored
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendVectored( StreamBufferHandle_t xStreamBuffer,
+								  const StreamBufferTxSegment_t * const pxSegments,
+								  UBaseType_t uxSegments,
+								  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferSendVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+										 const StreamBufferTxSegment_t * const pxSegments,
+										 UBaseType_t uxSegments,
+										 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveVectored( StreamBufferHandle_t xStreamBuffer,
+                                     const StreamBufferRxSegment_t * const pxSegments,
+                                     UBaseType_t uxSegments,
+                                     TickType_t xTicksToWait );
+size_t xStreamBufferReceiveVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+                                            const StreamBufferRxSegment_t * const pxSegments,
+                                            UBaseType_t uxSegments,
+                                            BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Versions of xStreamBufferReceive() and xStreamBufferReceiveFromISR() that
+ * scatter the received data across several separate pieces of memory, filling
+ * each segment in array order before moving on to the next.
+ *
+ * When used with a message buffer the next message is received if it fits in
+ * the total length of the segments, otherwise it is left in the buffer and 0 is
+ * returned.  When used with a stream buffer as many bytes as will fit are
+ * received.
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is to be
+ * received.
+ *
+ * @param pxSegments An array of uxSegments segments describing where the
+ * received data is to be placed.
+ *
+ * @param uxSegments The number of segments in the pxSegments array.
+ *
+ * @param xTicksToWait Used in the same way as the parameter of the same name
+ * of xStreamBufferReceive().
+ *
+ * @param pxHigherPriorityTaskWoken Used in the same way as the parameter of the
+ * same name of xStreamBufferReceiveFromISR().
+ *
+ * @return The number of bytes received.
+ *
+ * \defgroup xStreamBufferReceiveVectored xStreamBufferReceiveVectored
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveVectored( StreamBufferHandle_t xStreamBuffer,
+									 const StreamBufferRxSegment_t * const pxSegments,
+									 UBaseType_t uxSegments,
+									 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferReceiveVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+											const StreamBufferRxSegment_t * const pxSegments,
+											UBaseType_t uxSegments,
+											BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+UBaseType_t uxStreamBufferDrain( StreamBufferHandle_t xStreamBuffer,
+                                 StreamBufferDrainCallback_t pxCallback,
+                                 void *pvContext,
+                                 TickType_t xTicksToWait );
+UBaseType_t uxStreamBufferDrainFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        StreamBufferDrainCallback_t pxCallback,
+                                        void *pvContext,
+                                        BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Receives every message that is in a message buffer at the time of the call
+ * in one go.  Each message is passed to pxCallback in turn, in place, so it is
+ * not copied out of the buffer.  Once the callback has been called for the
+ * last message all the messages are removed from the buffer together, and a
+ * task blocked waiting for space is notified once, rather than once per
+ * message.  Messages sent while the callbacks are running are left in the
+ * buffer for the next call.
+ *
+ * When used with a stream buffer all the bytes in the buffer are passed to
+ * pxCallback in a single call.
+ *
+ * The buffer cannot be written to until the callbacks have returned, so the
+ * callbacks should be short.
+ *
+ * @param xStreamBuffer The handle of the buffer to drain.
+ *
+ * @param pxCallback The function called for each message.
+ *
+ * @param pvContext Passed into pxCallback unchanged.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for a message, should the buffer be empty.
+ *
+ * @param pxHigherPriorityTaskWoken Used in the same way as the parameter of the
+ * same name of xStreamBufferReceiveFromISR().
+ *
+ * @return The number of times pxCallback was called.
+ *
+ * Example use:
+<pre>
+static void prvPrintLine( const StreamBufferSpans_t *pxSpans, size_t xLength, void *pvContext )
+{
+    ( void ) xLength;
+    ( void ) pvContext;
+
+    fwrite( pxSpans->pucFirst, 1, pxSpans->xFirstLength, stdout );
+    fwrite( pxSpans->pucSecond, 1, pxSpans->xSecondLength, stdout );
+}
+
+void vLoggingTask( void *pvParameters )
+{
+    for( ;; )
+    {
+        uxMessageBufferDrain( xLogBuffer, prvPrintLine, NULL, portMAX_DELAY );
+    }
+}
+</pre>
+ * \defgroup uxStreamBufferDrain uxStreamBufferDrain
+ * \ingroup StreamBufferManagement
+ */
+UBaseType_t uxStreamBufferDrain( StreamBufferHandle_t xStreamBuffer,
+								 StreamBufferDrainCallback_t pxCallback,
+								 void *pvContext,
+								 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+UBaseType_t uxStreamBufferDrainFromISR( StreamBufferHandle_t xStreamBuffer,
+									    StreamBufferDrainCallback_t pxCallback,
+									    void *pvContext,
+									    BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
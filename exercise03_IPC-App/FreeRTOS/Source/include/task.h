@@ -139,6 +139,21 @@ typedef struct xTASK_STATUS
 	configSTACK_DEPTH_TYPE usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* Used with the vTaskGetHeapUsage() function to return the heap memory charged
+to a task when configUSE_TASK_HEAP_ACCOUNTING is 1. */
+typedef struct xTASK_HEAP_USAGE
+{
+	size_t xBytesInUse;				/* The heap memory the task has allocated and not yet freed, including block headers and alignment padding. */
+	size_t xPeakBytesInUse;			/* The highest value xBytesInUse has had. */
+	size_t xQuotaInBytes;			/* The most heap memory the task can hold, or 0 if the task has no quota. */
+	uint32_t ulQuotaViolations;		/* The number of the task's allocations that failed because of its quota. */
+	UBaseType_t uxHeapAccount;		/* The account the task's allocations are charged to.  0 is the account shared by allocations made before the scheduler started and by tasks created when every other account was in use. */
+} TaskHeapUsage_t;
+
+/* Returned by uxTaskHeapCheckQuota() when an allocation would take the calling
+task over its heap quota. */
+#define taskHEAP_QUOTA_EXCEEDED		( ( UBaseType_t ) ~( ( UBaseType_t ) 0U ) )
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -697,6 +712,78 @@ void vTaskAllocateMPURegions( TaskHandle_t xTask, const MemoryRegion_t * const p
  */
 void vTaskDelete( TaskHandle_t xTaskToDelete ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskReclaimDeletedTasks( UBaseType_t uxMaxTasks );</pre>
+ *
+ * INCLUDE_vTaskDelete must be defined as 1 for this function to be available.
+ *
+ * Frees the kernel allocated memory of tasks that have deleted themselves,
+ * which is otherwise done by the idle task.  A task that deletes itself cannot
+ * free its own stack, so its memory is only reclaimed when the idle task runs,
+ * and never if higher priority tasks keep the idle task from running.  Calling
+ * uxTaskReclaimDeletedTasks() from a low priority task, or from the timer task
+ * by calling it from a software timer callback, reclaims the memory anyway.
+ *
+ * Deleted tasks are taken from the kernel's lists up to
+ * configTASK_RECLAIM_BATCH_SIZE at a time, each batch in one critical section,
+ * then freed outside of the critical section.
+ *
+ * If configTASK_RECYCLE_LENGTH is greater than 0 then, rather than being freed,
+ * the TCBs and stacks of up to configTASK_RECYCLE_LENGTH deleted tasks that
+ * were created with xTaskCreate() are kept.  A later call to xTaskCreate() that
+ * asks for a stack of the same depth reuses one of them instead of allocating
+ * new memory.  A call that asks for a depth none of them has allocates new
+ * memory, and only frees them all and tries again if that allocation fails.
+ * Once configTASK_RECYCLE_LENGTH are kept the one kept the longest is freed to
+ * make room for the next.  Kept memory stays charged
+ * to the heap account it was first allocated from.
+ *
+ * Must not be called from an interrupt.
+ *
+ * @param uxMaxTasks The most deleted tasks to reclaim.
+ *
+ * @return The number of deleted tasks that were reclaimed.
+ *
+ * Example usage:
+   <pre>
+ // A software timer callback that runs in the timer task, which has a high
+ // priority, so deleted tasks are reclaimed even if the idle task is starved.
+ void vReclaimTimerCallback( TimerHandle_t xTimer )
+ {
+	 uxTaskReclaimDeletedTasks( 4 );
+ }
+   </pre>
+ * \defgroup uxTaskReclaimDeletedTasks uxTaskReclaimDeletedTasks
+ * \ingroup Tasks
+ */
+UBaseType_t uxTaskReclaimDeletedTasks( UBaseType_t uxMaxTasks ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskFlushRecycledTasks( void );</pre>
+ *
+ * configTASK_RECYCLE_LENGTH must be greater than 0, and INCLUDE_vTaskDelete
+ * and configSUPPORT_DYNAMIC_ALLOCATION must both be 1, for this function to be
+ * available.
+ *
+ * Frees the TCBs and stacks of deleted tasks that are being kept for reuse by
+ * xTaskCreate(), returning their memory to the heap.  xTaskCreate() calls it
+ * itself when it cannot allocate a task that none of them can be reused for,
+ * then tries the allocation again, so it only needs to be called to return the
+ * memory sooner, for example before making a large allocation that is not a
+ * task.  Note the malloc failed hook, if used, is called for the allocation
+ * that failed before the kept tasks were freed.
+ *
+ * Must not be called from an interrupt.
+ *
+ * @return The number of kept tasks that were freed.
+ *
+ * \defgroup uxTaskFlushRecycledTasks uxTaskFlushRecycledTasks
+ * \ingroup Tasks
+ */
+UBaseType_t uxTaskFlushRecycledTasks( void ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------
  * TASK CONTROL API
  *----------------------------------------------------------*/
@@ -1422,6 +1509,83 @@ TaskHandle_t xTaskGetHandle( const char *pcNameToQuery ) PRIVILEGED_FUNCTION; /*
  */
 UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * <PRE>void vTaskStackProfilerStep( UBaseType_t uxWordsPerTask );</PRE>
+ *
+ * configUSE_STACK_PROFILER must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Does a little of the work of measuring how much stack every task has used.
+ * Each task's stack is checked from its end, a word at a time, for words that
+ * no longer hold the value the stack was filled with when the task was
+ * created.  A check that is not finished carries on from where it stopped the
+ * next time vTaskStackProfilerStep() is called, so the stacks of all the tasks
+ * can be measured continuously without holding up the system for long.
+ *
+ * vTaskStackProfilerStep() suspends the scheduler while it runs, and is
+ * intended to be called from the idle hook, or from a low priority task.
+ *
+ * Only the stack allocated to the task by the kernel is checked, so the
+ * profiler cannot be used with ports that run tasks on stacks of their own.
+ * The Win32 port is one - each task runs on the stack of a Windows thread, and
+ * only a few words at the top of the kernel's stack are ever written, so every
+ * task would appear to use almost no stack.
+ *
+ * @param uxWordsPerTask The most stack words checked for each task by one
+ * call.  A larger value finds changes in stack use sooner, but keeps the
+ * scheduler suspended for longer.
+ *
+ * Example usage:
+   <pre>
+ void vApplicationIdleHook( void )
+ {
+     vTaskStackProfilerStep( 32 );
+ }
+   </pre>
+ */
+void vTaskStackProfilerStep( UBaseType_t uxWordsPerTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * <PRE>UBaseType_t uxTaskGetStackPeakUsage( TaskHandle_t xTask );</PRE>
+ *
+ * configUSE_STACK_PROFILER must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Returns the most stack the task has been found to use, in words, by
+ * vTaskStackProfilerStep().  Unlike uxTaskGetStackHighWaterMark() the stack is
+ * not checked when the function is called, so it returns immediately, but the
+ * value can be out of date by however many calls to vTaskStackProfilerStep()
+ * it takes to check the whole stack.  Comparing the value with the depth the
+ * task was created with shows how far the stack can safely be reduced.
+ *
+ * @param xTask Handle of the task to query.  Set xTask to NULL to query the
+ * calling task.
+ *
+ * @return The peak stack use found for the task, in words.
+ */
+UBaseType_t uxTaskGetStackPeakUsage( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * <PRE>void vTaskListStackUsage( char *pcWriteBuffer );</PRE>
+ *
+ * configUSE_STACK_PROFILER must be set to 1, and
+ * configUSE_STATS_FORMATTING_FUNCTIONS must be greater than 0, in
+ * FreeRTOSConfig.h for this function to be available.
+ *
+ * Writes a human readable table to pcWriteBuffer with one line per task,
+ * giving the task's name, the depth of its stack, the peak stack use found by
+ * vTaskStackProfilerStep(), and the fewest free words, all in words.
+ *
+ * Like vTaskList(), this function is a debug aid that depends on sprintf().
+ * Production code should call uxTaskGetStackPeakUsage() directly.  The buffer
+ * is assumed to be large enough; approximately 40 bytes per task is
+ * sufficient.
+ */
+void vTaskListStackUsage( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
 /* When using trace macros it is sometimes necessary to include task.h before
 FreeRTOS.h.  When this is done TaskHookFunction_t will not yet have been defined,
 so the following two prototypes will cause a compilation error.  This can be
@@ -2119,6 +2283,62 @@ uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait
  */
 BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );
 
+/**
+ * task. h
+ * <PRE>void vTaskGetHeapUsage( TaskHandle_t xTask, TaskHeapUsage_t *pxHeapUsage );</pre>
+ *
+ * configUSE_TASK_HEAP_ACCOUNTING must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * When heap accounting is enabled every block allocated by pvPortMalloc() is
+ * charged to the task that was running when it was allocated, and credited
+ * back to the same task when it is freed, whichever task frees it.  The memory
+ * for a task's TCB and stack is charged to the task that created it.  Each task
+ * is given its own account when it is created, until all
+ * configTASK_HEAP_ACCOUNTS - 1 accounts are in use, after which new tasks share
+ * account 0 with the allocations made before the scheduler was started.  A
+ * deleted task's account is reused once everything it allocated has been
+ * freed.
+ *
+ * @param xTask The handle of the task being queried.  Passing NULL queries the
+ * calling task.
+ *
+ * @param pxHeapUsage The TaskHeapUsage_t structure to populate.
+ *
+ * \defgroup vTaskGetHeapUsage vTaskGetHeapUsage
+ * \ingroup TaskUtils
+ */
+void vTaskGetHeapUsage( TaskHandle_t xTask, TaskHeapUsage_t *pxHeapUsage ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskSetHeapQuota( TaskHandle_t xTask, size_t xQuotaInBytes );</pre>
+ *
+ * configUSE_TASK_HEAP_ACCOUNTING must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * Limits the heap memory a task can hold.  An allocation made by the task that
+ * would take the bytes charged to it over the quota fails, and calls
+ * vApplicationHeapQuotaHook() if configUSE_HEAP_QUOTA_HOOK is 1, before calling
+ * the malloc failed hook as for any other failed allocation.  The quota is
+ * checked against the size requested plus the block header, so a task can end
+ * up holding a few bytes over its quota when the heap hands it a block that is
+ * too small to split.
+ *
+ * @param xTask The handle of the task.  Passing NULL sets the quota of the
+ * calling task.
+ *
+ * @param xQuotaInBytes The most heap memory the task can hold, or 0 to remove
+ * the quota.
+ *
+ * @return pdPASS if the quota was set, or pdFAIL if the task shares account 0
+ * and so cannot have a quota.
+ *
+ * \defgroup xTaskSetHeapQuota xTaskSetHeapQuota
+ * \ingroup TaskUtils
+ */
+BaseType_t xTaskSetHeapQuota( TaskHandle_t xTask, size_t xQuotaInBytes ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
  *----------------------------------------------------------*/
@@ -2206,13 +2426,16 @@ void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTi
  * vTaskRemoveFromUnorderedEventList() is used when the event list is not
  * ordered and the event list items hold something other than the owning tasks
  * priority.  In this case the event list item value is updated to the value
- * passed in the xItemValue parameter.
+ * passed in the xItemValue parameter.  It must be called with the scheduler
+ * suspended.  xTaskRemoveFromUnorderedEventListFromISR() does the same from a
+ * critical section, including one within an ISR.
  *
  * @return pdTRUE if the task being removed has a higher priority than the task
  * making the call, otherwise pdFALSE.
  */
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
 void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
 
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
@@ -2323,6 +2546,40 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Used by the heap implementations when
+ * configUSE_TASK_HEAP_ACCOUNTING is 1, with the scheduler suspended.
+ * uxTaskHeapCheckQuota() returns the account an allocation of xWantedSize
+ * bytes made by the calling task is charged to, or taskHEAP_QUOTA_EXCEEDED if
+ * the allocation would take the task over its quota.  vTaskHeapCharge() and
+ * vTaskHeapCredit() add and remove the size of an allocated block to and from
+ * an account.
+ */
+UBaseType_t uxTaskHeapCheckQuota( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vTaskHeapCharge( UBaseType_t uxHeapAccount, size_t xBlockSize ) PRIVILEGED_FUNCTION;
+void vTaskHeapCredit( UBaseType_t uxHeapAccount, size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Returns the heap account the calling task's
+ * allocations are charged to, without checking its quota.
+ */
+UBaseType_t uxTaskGetHeapAccount( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Used by heap_5.c when configUSE_HEAP_TASK_CACHE is 1
+ * to find the calling task's heap cache.  Returns NULL if the scheduler has not
+ * been started.
+ */
+HeapTaskCache_t *pxTaskGetHeapCache( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Used by arena.c when configUSE_ARENAS is 1 to record
+ * the arena attached to a task.  pvTaskSetArenaPointer() returns the arena that
+ * was attached before.  Passing NULL as xTask uses the calling task.
+ */
+void *pvTaskSetArenaPointer( TaskHandle_t xTask, void *pvArena ) PRIVILEGED_FUNCTION;
+void *pvTaskGetArenaPointer( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critial
  * section.
@@ -34,8 +34,9 @@
 #endif
 
 /*lint -save -e537 This headers are only multiply included if the application code
-happens to also be including task.h. */
+happens to also be including task.h or queue.h. */
 #include "task.h"
+#include "queue.h"
 /*lint -restore */
 
 #ifdef __cplusplus
@@ -87,6 +88,17 @@ typedef void (*TimerCallbackFunction_t)( TimerHandle_t xTimer );
  */
 typedef void (*PendedFunction_t)( void *, uint32_t );
 
+/*
+ * Used with vTimerGetCoalescingStats() to report how effective timer slack has
+ * been at grouping timer expiries into fewer timer service task wakeups.
+ */
+typedef struct xTIMER_COALESCING_STATS
+{
+	uint32_t ulWakeups;			/* The number of times the timer service task woke and processed at least one expired timer. */
+	uint32_t ulExpiryTimes;		/* The number of distinct expiry times processed, which is the number of wakeups that would have been needed if no timer had any slack. */
+	uint32_t ulWakeupsSaved;	/* ulExpiryTimes minus ulWakeups. */
+} TimerCoalescingStats_t;
+
 /**
  * TimerHandle_t xTimerCreate( 	const char * const pcTimerName,
  * 								TickType_t xTimerPeriodInTicks,
@@ -1257,6 +1269,135 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+/**
+ * TimerHandle_t xTimerEnableFast( TimerHandle_t xTimer );
+ *
+ * Turns a timer that has been created but not yet started into a fast timer.
+ * configUSE_FAST_TIMERS must be set to 1 in FreeRTOSConfig.h for
+ * xTimerEnableFast() to be available.
+ *
+ * Commands sent to a normal timer, such as xTimerStart() and xTimerReset(), are
+ * posted to the timer service task, and its callback executes in the context of
+ * the timer service task.  Commands sent to a fast timer instead update the
+ * timer directly within a critical section, so they never block and never wait
+ * for the timer service task to run, and its callback executes from the tick
+ * interrupt.  A fast timer's callback must therefore be short, must not block,
+ * and must only call API functions that end in "FromISR".  Any task unblocked
+ * by the callback is switched to when the tick interrupt exits if it has a
+ * higher priority than the interrupted task, so the callback can pass NULL as
+ * the pxHigherPriorityTaskWoken parameter.  Ticks that occur while the
+ * scheduler is suspended are processed when the scheduler is resumed, so fast
+ * timers expiring during that time have their callbacks executed late, from
+ * within xTaskResumeAll().
+ *
+ * Fast timer commands always succeed, even when called from an interrupt, so
+ * the xTicksToWait parameter is ignored.  The time taken to execute the
+ * callback is measured every time it executes, and the longest is available
+ * from ulTimerGetMaxCallbackTime().
+ *
+ * xTimerCreateFast() and xTimerCreateFastStatic() are provided to create a
+ * timer and make it a fast timer in one call.
+ *
+ * @param xTimer The handle of the timer to make a fast timer.  The timer must
+ * not have been started.  If xTimer is NULL then nothing is done.
+ *
+ * @return xTimer, so the function can wrap a call to xTimerCreate().
+ */
+TimerHandle_t xTimerEnableFast( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+#define xTimerCreateFast( pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction ) xTimerEnableFast( xTimerCreate( ( pcTimerName ), ( xTimerPeriodInTicks ), ( uxAutoReload ), ( pvTimerID ), ( pxCallbackFunction ) ) )
+#define xTimerCreateFastStatic( pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction, pxTimerBuffer ) xTimerEnableFast( xTimerCreateStatic( ( pcTimerName ), ( xTimerPeriodInTicks ), ( uxAutoReload ), ( pvTimerID ), ( pxCallbackFunction ), ( pxTimerBuffer ) ) )
+
+/**
+ * uint32_t ulTimerGetMaxCallbackTime( TimerHandle_t xTimer );
+ *
+ * Returns the longest time a fast timer's callback has taken to execute.  The
+ * time is measured in processor cycles if the port defines
+ * portGET_CYCLE_COUNT(), otherwise with the run time stats counter, in which
+ * case configGENERATE_RUN_TIME_STATS must be set to 1.
+ * configUSE_FAST_TIMERS must be set to 1 in FreeRTOSConfig.h for
+ * ulTimerGetMaxCallbackTime() to be available.
+ *
+ * @param xTimer The handle of the fast timer being queried.
+ *
+ * @return The worst case callback execution time, or 0 if the callback has not
+ * yet executed.
+ */
+uint32_t ulTimerGetMaxCallbackTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vTimerSetSlack( TimerHandle_t xTimer, TickType_t xSlackInTicks );
+ *
+ * Sets the number of ticks by which the timer service task is allowed to delay
+ * a timer's expiry.  configUSE_TIMER_SLACK must be set to 1 in FreeRTOSConfig.h
+ * for vTimerSetSlack() to be available.
+ *
+ * A timer never expires before its expiry time, but with slack it can expire
+ * up to xSlackInTicks ticks after it.  The timer service task sleeps until the
+ * earliest time by which a timer must expire, then processes every timer that
+ * has reached its expiry time, so timers whose windows overlap are all handled
+ * by one wakeup instead of each waking the task separately.  An auto reload
+ * timer is always reloaded relative to its expiry time, not to the time it was
+ * processed, so slack does not cause its period to drift.  Timers are created
+ * with no slack.  Fast timers ignore their slack.
+ *
+ * The new slack is used the next time the timer is started, reset or
+ * reloaded.
+ *
+ * @param xTimer The handle of the timer being updated.
+ *
+ * @param xSlackInTicks The maximum number of ticks the timer may be delayed.
+ */
+void vTimerSetSlack( TimerHandle_t xTimer, TickType_t xSlackInTicks ) PRIVILEGED_FUNCTION;
+
+/**
+ * TickType_t xTimerGetSlack( TimerHandle_t xTimer );
+ *
+ * Returns the slack of a timer, as set by vTimerSetSlack().
+ *
+ * @param xTimer The handle of the timer being queried.
+ *
+ * @return The maximum number of ticks the timer may be delayed.
+ */
+TickType_t xTimerGetSlack( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vTimerGetCoalescingStats( TimerCoalescingStats_t *pxStats );
+ *
+ * Populates a TimerCoalescingStats_t structure with the number of times the
+ * timer service task has woken to process expired timers, and the number of
+ * wakeups saved by processing timers with different expiry times together.
+ * configUSE_TIMER_SLACK must be set to 1 in FreeRTOSConfig.h for
+ * vTimerGetCoalescingStats() to be available.
+ *
+ * @param pxStats The structure into which the counts are written.
+ */
+void vTimerGetCoalescingStats( TimerCoalescingStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * void vTimerGetCommandQueueStats( QueueStats_t *pxQueueStats );
+ * void vTimerResetCommandQueueStats( void );
+ *
+ * Obtain or reset the statistics of the queue used to send commands to the
+ * timer service task, in the same way as vQueueGetStats() and
+ * vQueueResetStats().  The peak number of items the queue has held, and the
+ * number of times a task blocked because the queue was full, show whether
+ * configTIMER_QUEUE_LENGTH is long enough for the bursts of commands the
+ * application sends.  configUSE_QUEUE_STATS must be set to 1 in
+ * FreeRTOSConfig.h for these functions to be available, and the timer service
+ * task must have been created.
+ *
+ * The timer service task receives up to configTIMER_COMMAND_BATCH_SIZE
+ * commands from the queue at a time, and samples the tick count once for each
+ * batch rather than once for each command.
+ *
+ * @param pxQueueStats The structure into which the statistics are written.
+ */
+#if( configUSE_QUEUE_STATS == 1 )
+	void vTimerGetCommandQueueStats( QueueStats_t *pxQueueStats ) PRIVILEGED_FUNCTION;
+	void vTimerResetCommandQueueStats( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
@@ -1264,6 +1405,12 @@ TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 BaseType_t xTimerCreateTimerTask( void ) PRIVILEGED_FUNCTION;
 BaseType_t xTimerGenericCommand( TimerHandle_t xTimer, const BaseType_t xCommandID, const TickType_t xOptionalValue, BaseType_t * const pxHigherPriorityTaskWoken, const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_FAST_TIMERS == 1 )
+	/* Called by xTaskIncrementTick() with the new tick count to execute the
+	callbacks of fast timers that expire on that tick. */
+	void vTimerProcessFastTimers( const TickType_t xTickCount ) PRIVILEGED_FUNCTION;
+#endif
+
 #if( configUSE_TRACE_FACILITY == 1 )
 	void vTimerSetTimerNumber( TimerHandle_t xTimer, UBaseType_t uxTimerNumber ) PRIVILEGED_FUNCTION;
 	UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
@@ -0,0 +1,211 @@
+/*
+ * Topic bus - publish/subscribe fan-out built on top of the FreeRTOS kernel.
+ *
+ * A topic holds a ring of fixed size items.  A publisher writes each item into
+ * the ring exactly once, no matter how many tasks subscribe to the topic.  Every
+ * subscriber has its own read cursor into the ring, so each subscriber receives
+ * every item published after it subscribed, in publish order.
+ *
+ * Publishing never blocks.  If a subscriber falls so far behind that the ring
+ * wraps past its read cursor then the items it missed are counted as overruns
+ * and its cursor is moved forward to the oldest item still held in the ring.
+ * A slow subscriber therefore never holds up the publisher or the other
+ * subscribers.
+ *
+ * Subscribers that block waiting for data are woken using direct to task
+ * notifications, in the same way as stream buffers, so a task must not wait on
+ * a topic and use its notification value for another purpose at the same time.
+ *
+ * Each topic counts the items published and delivered, the overruns, and the
+ * latency between an item being published and it being received.  Latency is
+ * measured with the run time stats counter if configGENERATE_RUN_TIME_STATS is
+ * 1, otherwise in ticks.
+ */
+
+#ifndef TOPIC_BUS_H
+#define TOPIC_BUS_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include topic_bus.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which topics are referenced.  For example, a call to xTopicCreate()
+ * returns a TopicHandle_t variable that can then be used as a parameter to
+ * xTopicPublish(), xTopicSubscribe(), etc.
+ */
+struct TopicDefinition;
+typedef struct TopicDefinition * TopicHandle_t;
+
+/**
+ * Type by which the subscriptions to a topic are referenced.  A call to
+ * xTopicSubscribe() returns a TopicSubscriberHandle_t variable that can then be
+ * used as a parameter to xTopicReceive().
+ */
+struct TopicSubscriberDefinition;
+typedef struct TopicSubscriberDefinition * TopicSubscriberHandle_t;
+
+/**
+ * Used with vTopicGetInfo() and vTopicGetSubscriberInfo() to obtain the
+ * throughput and latency counters of a topic or of one of its subscribers.
+ * Latencies are in run time stats counter units if configGENERATE_RUN_TIME_STATS
+ * is 1, otherwise in ticks.  The average latency is ulTotalLatency divided by
+ * ulDelivered.
+ */
+typedef struct xTOPIC_STATUS
+{
+	uint32_t ulPublished;		/* The number of items published to the topic.  Not used by vTopicGetSubscriberInfo(). */
+	uint32_t ulDelivered;		/* The number of items received by the subscriber(s). */
+	uint32_t ulOverruns;		/* The number of items the subscriber(s) missed because the ring wrapped before they were read. */
+	uint32_t ulMaxLatency;		/* The longest time an item spent in the ring before being received. */
+	uint32_t ulTotalLatency;	/* The sum of the time received items spent in the ring. */
+	UBaseType_t uxSubscribers;	/* The number of tasks currently subscribed to the topic.  Not used by vTopicGetSubscriberInfo(). */
+} TopicStatus_t;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+TopicHandle_t xTopicCreate( UBaseType_t uxTopicLength, UBaseType_t uxItemSize );
+</pre>
+ *
+ * Creates a new topic using dynamically allocated memory.
+ *
+ * @param uxTopicLength The number of items the topic's ring can hold.  A
+ * subscriber can fall up to uxTopicLength items behind the publisher before
+ * it starts to miss items.  Must be a power of two.
+ *
+ * @param uxItemSize The size, in bytes, of each item published to the topic.
+ *
+ * @return If the topic is created successfully then a handle to the created
+ * topic is returned.  If there was not enough heap memory to create the topic,
+ * or uxTopicLength is not a power of two, then NULL is returned.
+ */
+TopicHandle_t xTopicCreate( UBaseType_t uxTopicLength, UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicDelete( TopicHandle_t xTopic );
+</pre>
+ *
+ * Deletes a topic that was previously created using xTopicCreate().  All the
+ * subscribers must have been removed with vTopicUnsubscribe() first.
+ *
+ * @param xTopic The handle of the topic to be deleted.
+ */
+void vTopicDelete( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+TopicSubscriberHandle_t xTopicSubscribe( TopicHandle_t xTopic );
+</pre>
+ *
+ * Subscribes to a topic.  The subscriber receives every item published after
+ * this call returns.  A subscription should only be used by one task at a time.
+ *
+ * @param xTopic The handle of the topic to subscribe to.
+ *
+ * @return The handle of the new subscription, or NULL if there was not enough
+ * heap memory to create it.
+ */
+TopicSubscriberHandle_t xTopicSubscribe( TopicHandle_t xTopic ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicUnsubscribe( TopicSubscriberHandle_t xSubscriber );
+</pre>
+ *
+ * Removes a subscription that was created using xTopicSubscribe() and frees
+ * the memory it used.  No task may be blocked in xTopicReceive() on the
+ * subscription when it is removed.
+ *
+ * @param xSubscriber The handle of the subscription to remove.
+ */
+void vTopicUnsubscribe( TopicSubscriberHandle_t xSubscriber ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicPublish( TopicHandle_t xTopic, const void *pvItem );
+</pre>
+ *
+ * Copies an item into the topic's ring once and wakes any subscribers that are
+ * blocked waiting for data.  Never blocks.  Subscribers that have not read the
+ * oldest item in the ring by the time it is overwritten have an overrun
+ * recorded the next time they call xTopicReceive().
+ *
+ * Use vTopicPublishFromISR() to publish from an interrupt service routine.
+ *
+ * @param xTopic The handle of the topic to publish to.
+ *
+ * @param pvItem A pointer to the item to publish.  The size of the item was
+ * defined when the topic was created.
+ */
+void vTopicPublish( TopicHandle_t xTopic, const void *pvItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicPublishFromISR( TopicHandle_t xTopic, const void *pvItem, BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of vTopicPublish() that can be called from an interrupt service
+ * routine.  *pxHigherPriorityTaskWoken is set to pdTRUE if waking a subscriber
+ * unblocked a task with a priority above that of the interrupted task, in which
+ * case a context switch should be requested before the interrupt is exited.
+ */
+void vTopicPublishFromISR( TopicHandle_t xTopic, const void *pvItem, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+BaseType_t xTopicReceive( TopicSubscriberHandle_t xSubscriber, void *pvBuffer, TickType_t xTicksToWait );
+</pre>
+ *
+ * Receives the next item published to a topic that the subscriber has not yet
+ * read.
+ *
+ * @param xSubscriber The handle of the subscription to read from.
+ *
+ * @param pvBuffer Pointer to the buffer into which the item will be copied.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for an item to be published, should the subscriber
+ * already have read every item.
+ *
+ * @return pdPASS if an item was received, otherwise pdFAIL.
+ */
+BaseType_t xTopicReceive( TopicSubscriberHandle_t xSubscriber, void *pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * topic_bus.h
+ *
+<pre>
+void vTopicGetInfo( TopicHandle_t xTopic, TopicStatus_t *pxTopicStatus );
+void vTopicGetSubscriberInfo( TopicSubscriberHandle_t xSubscriber, TopicStatus_t *pxTopicStatus );
+</pre>
+ *
+ * Populates a TopicStatus_t structure with the counters of a whole topic, or
+ * of a single subscription to a topic.
+ */
+void vTopicGetInfo( TopicHandle_t xTopic, TopicStatus_t *pxTopicStatus ) PRIVILEGED_FUNCTION;
+void vTopicGetSubscriberInfo( TopicSubscriberHandle_t xSubscriber, TopicStatus_t *pxTopicStatus ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( TOPIC_BUS_H ) */
@@ -0,0 +1,268 @@
+/*
+ * Object pools - fixed size blocks for kernel objects.
+ * See object_pools.h for a description of the behaviour.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "object_pools.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+to use object pools.  This #if is closed at the very bottom of this file. */
+#if( configUSE_OBJECT_POOLS == 1 )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use object pools, as objects that do not fit in a pool are allocated from the heap
+#endif
+
+/* Rounds a block size up to a multiple of the alignment pvPortMalloc()
+guarantees, so every block in a pool is aligned. */
+#define poolALIGNED_SIZE( xSize )	( ( ( size_t ) ( xSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The size of the blocks in each pool.  The Static..._t structures are the same
+size as the structures the kernel allocates for each type of object. */
+#define poolTASK_BLOCK_SIZE			poolALIGNED_SIZE( sizeof( StaticTask_t ) )
+#define poolSTACK_BLOCK_SIZE		poolALIGNED_SIZE( ( size_t ) configSTACK_POOL_DEPTH * sizeof( StackType_t ) )
+#define poolQUEUE_BLOCK_SIZE		poolALIGNED_SIZE( sizeof( StaticQueue_t ) + ( size_t ) configQUEUE_POOL_STORAGE_SIZE )
+#define poolTIMER_BLOCK_SIZE		poolALIGNED_SIZE( sizeof( StaticTimer_t ) )
+#define poolEVENT_GROUP_BLOCK_SIZE	poolALIGNED_SIZE( sizeof( StaticEventGroup_t ) )
+
+/* The size of the region all the pools are carved from, including the bytes
+that may be lost aligning the start of the region. */
+#define poolREGION_SIZE		( ( ( size_t ) configTASK_POOL_LENGTH * poolTASK_BLOCK_SIZE ) +				\
+							  ( ( size_t ) configSTACK_POOL_LENGTH * poolSTACK_BLOCK_SIZE ) +			\
+							  ( ( size_t ) configQUEUE_POOL_LENGTH * poolQUEUE_BLOCK_SIZE ) +			\
+							  ( ( size_t ) configTIMER_POOL_LENGTH * poolTIMER_BLOCK_SIZE ) +			\
+							  ( ( size_t ) configEVENT_GROUP_POOL_LENGTH * poolEVENT_GROUP_BLOCK_SIZE ) +	\
+							  ( size_t ) portBYTE_ALIGNMENT )
+
+/* A free block holds a pointer to the next free block in the same pool. */
+typedef struct A_POOL_BLOCK
+{
+	struct A_POOL_BLOCK *pxNextFreeBlock;
+} PoolBlock_t;
+
+/* State held for each pool. */
+typedef struct xOBJECT_POOL
+{
+	uint8_t *pucFirstBlock;			/* The start of the pool's part of the region. */
+	uint8_t *pucLastBlock;			/* The start of the last block in the pool. */
+	PoolBlock_t *pxFreeBlocks;		/* Singly linked list of the blocks that do not hold an object. */
+	size_t xBlockSize;
+	UBaseType_t uxBlocks;
+	UBaseType_t uxBlocksInUse;
+	UBaseType_t uxPeakBlocksInUse;
+	uint32_t ulAllocations;
+	uint32_t ulFallbacks;
+} ObjectPool_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Carves the region into the pools and links each pool's blocks into its free
+ * list.  Called from a critical section the first time a block is requested.
+ */
+static void prvInitialisePools( void ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The region the pools are carved from. */
+static uint8_t ucPoolRegion[ poolREGION_SIZE ];
+
+/* The pools, indexed by eObjectPool. */
+static ObjectPool_t xObjectPools[ poolNUMBER_OF_POOLS ];
+static BaseType_t xPoolsInitialised = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void *pvObjectPoolMalloc( eObjectPool ePool, size_t xWantedSize )
+{
+ObjectPool_t *pxPool;
+PoolBlock_t *pxBlock = NULL;
+void *pvReturn;
+
+	configASSERT( ( UBaseType_t ) ePool < poolNUMBER_OF_POOLS );
+	pxPool = &( xObjectPools[ ePool ] );
+
+	taskENTER_CRITICAL();
+	{
+		if( xPoolsInitialised == pdFALSE )
+		{
+			prvInitialisePools();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( xWantedSize <= pxPool->xBlockSize ) && ( pxPool->pxFreeBlocks != NULL ) )
+		{
+			pxBlock = pxPool->pxFreeBlocks;
+			pxPool->pxFreeBlocks = pxBlock->pxNextFreeBlock;
+			( pxPool->uxBlocksInUse )++;
+			( pxPool->ulAllocations )++;
+
+			if( pxPool->uxBlocksInUse > pxPool->uxPeakBlocksInUse )
+			{
+				pxPool->uxPeakBlocksInUse = pxPool->uxBlocksInUse;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			( pxPool->ulFallbacks )++;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( pxBlock != NULL )
+	{
+		pvReturn = ( void * ) pxBlock;
+	}
+	else
+	{
+		/* The object does not fit in the pool, or the pool is empty, so
+		allocate it from the heap instead. */
+		pvReturn = pvPortMalloc( xWantedSize );
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vObjectPoolFree( eObjectPool ePool, void *pv )
+{
+ObjectPool_t *pxPool;
+uint8_t *pucBlock = ( uint8_t * ) pv;
+PoolBlock_t *pxBlock;
+
+	configASSERT( ( UBaseType_t ) ePool < poolNUMBER_OF_POOLS );
+	pxPool = &( xObjectPools[ ePool ] );
+
+	/* Memory that lies within the pool's part of the region came from the
+	pool, anything else came from the heap.  The pool is only empty if it has
+	no blocks, in which case the test always fails. */
+	if( ( pv != NULL ) && ( pucBlock >= pxPool->pucFirstBlock ) && ( pucBlock <= pxPool->pucLastBlock ) && ( pxPool->uxBlocks > ( UBaseType_t ) 0 ) )
+	{
+		/* Check the pointer is to the start of a block. */
+		configASSERT( ( ( size_t ) ( pucBlock - pxPool->pucFirstBlock ) % pxPool->xBlockSize ) == ( size_t ) 0 );
+
+		pxBlock = ( PoolBlock_t * ) pv; /*lint !e9087 !e9079 Pool blocks are aligned. */
+
+		taskENTER_CRITICAL();
+		{
+			configASSERT( pxPool->uxBlocksInUse > ( UBaseType_t ) 0 );
+			pxBlock->pxNextFreeBlock = pxPool->pxFreeBlocks;
+			pxPool->pxFreeBlocks = pxBlock;
+			( pxPool->uxBlocksInUse )--;
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		vPortFree( pv );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vObjectPoolGetInfo( eObjectPool ePool, ObjectPoolStatus_t *pxPoolStatus )
+{
+ObjectPool_t *pxPool;
+
+	configASSERT( ( UBaseType_t ) ePool < poolNUMBER_OF_POOLS );
+	configASSERT( pxPoolStatus );
+	pxPool = &( xObjectPools[ ePool ] );
+
+	taskENTER_CRITICAL();
+	{
+		if( xPoolsInitialised == pdFALSE )
+		{
+			prvInitialisePools();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxPoolStatus->xBlockSize = pxPool->xBlockSize;
+		pxPoolStatus->uxBlocks = pxPool->uxBlocks;
+		pxPoolStatus->uxBlocksInUse = pxPool->uxBlocksInUse;
+		pxPoolStatus->uxPeakBlocksInUse = pxPool->uxPeakBlocksInUse;
+		pxPoolStatus->ulAllocations = pxPool->ulAllocations;
+		pxPoolStatus->ulFallbacks = pxPool->ulFallbacks;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialisePools( void )
+{
+static const size_t xBlockSizes[ poolNUMBER_OF_POOLS ] =
+{
+	poolTASK_BLOCK_SIZE,
+	poolSTACK_BLOCK_SIZE,
+	poolQUEUE_BLOCK_SIZE,
+	poolTIMER_BLOCK_SIZE,
+	poolEVENT_GROUP_BLOCK_SIZE
+};
+static const UBaseType_t uxPoolLengths[ poolNUMBER_OF_POOLS ] =
+{
+	configTASK_POOL_LENGTH,
+	configSTACK_POOL_LENGTH,
+	configQUEUE_POOL_LENGTH,
+	configTIMER_POOL_LENGTH,
+	configEVENT_GROUP_POOL_LENGTH
+};
+ObjectPool_t *pxPool;
+uint8_t *pucNextBlock;
+UBaseType_t uxPool, uxBlock;
+PoolBlock_t *pxBlock;
+
+	/* Ensure the region starts on a correctly aligned boundary. */
+	pucNextBlock = &( ucPoolRegion[ portBYTE_ALIGNMENT ] );
+	pucNextBlock = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pucNextBlock ) & ( ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) ) );
+
+	for( uxPool = 0; uxPool < poolNUMBER_OF_POOLS; uxPool++ )
+	{
+		pxPool = &( xObjectPools[ uxPool ] );
+		pxPool->xBlockSize = xBlockSizes[ uxPool ];
+		pxPool->uxBlocks = uxPoolLengths[ uxPool ];
+		pxPool->pucFirstBlock = pucNextBlock;
+		pxPool->pxFreeBlocks = NULL;
+
+		/* Link the blocks in reverse order, so the block at the lowest address
+		is used first. */
+		pucNextBlock += pxPool->xBlockSize * ( size_t ) pxPool->uxBlocks;
+
+		for( uxBlock = 0; uxBlock < pxPool->uxBlocks; uxBlock++ )
+		{
+			pxBlock = ( PoolBlock_t * ) ( pucNextBlock - ( pxPool->xBlockSize * ( size_t ) ( uxBlock + 1U ) ) ); /*lint !e9087 !e9079 Pool blocks are aligned. */
+			pxBlock->pxNextFreeBlock = pxPool->pxFreeBlocks;
+			pxPool->pxFreeBlocks = pxBlock;
+		}
+
+		pxPool->pucLastBlock = ( pxPool->uxBlocks > ( UBaseType_t ) 0 ) ? ( pucNextBlock - pxPool->xBlockSize ) : pxPool->pucFirstBlock;
+	}
+
+	xPoolsInitialised = pdTRUE;
+}
+
+/* This entire source file will be skipped if the application is not configured
+to use object pools.  If you want to include object pools then ensure
+configUSE_OBJECT_POOLS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_OBJECT_POOLS == 1 */
+
@@ -27,6 +27,7 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <malloc.h>
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
@@ -47,6 +48,12 @@
 #define portSIMULATED_TIMER_THREAD_PRIORITY		 THREAD_PRIORITY_HIGHEST
 #define portTASK_THREAD_PRIORITY				 THREAD_PRIORITY_ABOVE_NORMAL
 
+/* When configWIN32_GUARDED_TASK_STACKS is 1, the stack Windows keeps back so
+the stack overflow handler can run once a task's thread has overflowed its
+stack, and the extra stack reserved for each thread's own use. */
+#define portSTACK_OVERFLOW_HANDLER_SPACE		( 16384UL )
+#define portGUARDED_STACK_MARGIN				( 65536UL )
+
 /*
  * Created as a high priority thread, this function uses a timer to simulate
  * a tick interrupt being generated on an embedded target.  In this Windows
@@ -74,6 +81,28 @@ static uint32_t prvProcessTickInterrupt( void );
  */
 static BOOL WINAPI prvEndProcess( DWORD dwCtrlType );
 
+#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+
+	/*
+	 * The function each task's thread starts in.  Uses up any stack the thread
+	 * has beyond the size of the task's own stack, then calls the task
+	 * function.
+	 */
+	static DWORD WINAPI prvGuardedTaskThread( LPVOID lpParameter );
+
+	/*
+	 * Reports the name of the task whose thread overflowed its stack.
+	 */
+	static LONG WINAPI prvStackOverflowHandler( PEXCEPTION_POINTERS pxExceptionInfo );
+
+	/*
+	 * Called with the task that overflowed its stack.  Defined by the
+	 * application.
+	 */
+	extern void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName );
+
+#endif /* configWIN32_GUARDED_TASK_STACKS */
+
 /*-----------------------------------------------------------*/
 
 /* The WIN32 simulator runs each task in a thread.  The context switching is
@@ -86,6 +115,16 @@ typedef struct
 	/* Handle of the thread that executes the task. */
 	void *pvThread;
 
+	#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+		/* The task function and its parameter, which prvGuardedTaskThread()
+		calls. */
+		TaskFunction_t pxCode;
+		void *pvParameters;
+
+		/* The number of bytes of stack the task can use before it overflows. */
+		size_t xStackSize;
+	#endif
+
 } xThreadState;
 
 /* Simulated interrupts waiting to be processed.  This is a bit mask where each
@@ -207,7 +246,11 @@ TIMECAPS xTimeCaps;
 }
 /*-----------------------------------------------------------*/
 
+#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+#else
 StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+#endif
 {
 xThreadState *pxThreadState = NULL;
 int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
@@ -221,8 +264,25 @@ const SIZE_T xStackSize = 1024; /* Set the size to a small number which will get
 	other than holding this structure. */
 	pxThreadState = ( xThreadState * ) ( pcTopOfStack - sizeof( xThreadState ) );
 
-	/* Create the thread itself. */
-	pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
+	#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+	{
+		/* The thread is given configWIN32_TASK_STACK_MULTIPLIER times the
+		stack of the task, to allow for the Windows functions the task calls.
+		prvGuardedTaskThread() uses up the rest of the reservation, so the task
+		cannot use more. */
+		pxThreadState->pxCode = pxCode;
+		pxThreadState->pvParameters = pvParameters;
+		pxThreadState->xStackSize = ( ( size_t ) ( ( int8_t * ) pxTopOfStack - ( int8_t * ) pxEndOfStack ) + sizeof( StackType_t ) ) * ( size_t ) configWIN32_TASK_STACK_MULTIPLIER;
+
+		( void ) xStackSize;
+		pxThreadState->pvThread = CreateThread( NULL, pxThreadState->xStackSize + portSTACK_OVERFLOW_HANDLER_SPACE + portGUARDED_STACK_MARGIN, prvGuardedTaskThread, pxThreadState, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
+	}
+	#else
+	{
+		/* Create the thread itself. */
+		pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
+	}
+	#endif /* configWIN32_GUARDED_TASK_STACKS */
 	configASSERT( pxThreadState->pvThread ); /* See comment where TerminateThread() is called. */
 	SetThreadAffinityMask( pxThreadState->pvThread, 0x01 );
 	SetThreadPriorityBoost( pxThreadState->pvThread, TRUE );
@@ -232,6 +292,75 @@ const SIZE_T xStackSize = 1024; /* Set the size to a small number which will get
 }
 /*-----------------------------------------------------------*/
 
+#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+
+	static DWORD WINAPI prvGuardedTaskThread( LPVOID lpParameter )
+	{
+	xThreadState *pxThreadState = ( xThreadState * ) lpParameter;
+	ULONG ulHandlerSpace = portSTACK_OVERFLOW_HANDLER_SPACE;
+	MEMORY_BASIC_INFORMATION xStackInfo;
+	SYSTEM_INFO xSystemInfo;
+	size_t xAvailable, xUnusable;
+	volatile int8_t *pcPadding;
+
+		/* Keep enough stack back for prvStackOverflowHandler() to run once the
+		stack has overflowed. */
+		SetThreadStackGuarantee( &ulHandlerSpace );
+
+		/* The stack below this point runs down to the base of the allocation
+		that holds it, which is the bottom of the thread's stack reservation. */
+		VirtualQuery( ( LPCVOID ) &xStackInfo, &xStackInfo, sizeof( xStackInfo ) );
+		xAvailable = ( size_t ) ( ( int8_t * ) &xStackInfo - ( int8_t * ) xStackInfo.AllocationBase );
+
+		/* Windows raises EXCEPTION_STACK_OVERFLOW when the stack reaches the
+		guard page above the space kept back for the handler.  The last page
+		of the reservation is never used. */
+		GetSystemInfo( &xSystemInfo );
+		xUnusable = ( size_t ) portSTACK_OVERFLOW_HANDLER_SPACE + ( 2U * ( size_t ) xSystemInfo.dwPageSize );
+
+		/* Windows rounds the reservation up to its allocation granularity, so
+		the thread has more stack than it was sized for.  Take the excess here,
+		so the task overflows once it uses more than xStackSize bytes. */
+		if( xAvailable > ( xUnusable + pxThreadState->xStackSize ) )
+		{
+			pcPadding = ( volatile int8_t * ) _alloca( xAvailable - xUnusable - pxThreadState->xStackSize );
+			pcPadding[ 0 ] = 0;
+		}
+
+		pxThreadState->pxCode( pxThreadState->pvParameters );
+
+		return 0;
+	}
+
+#endif /* configWIN32_GUARDED_TASK_STACKS */
+/*-----------------------------------------------------------*/
+
+#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+
+	static LONG WINAPI prvStackOverflowHandler( PEXCEPTION_POINTERS pxExceptionInfo )
+	{
+	xThreadState *pxThreadState;
+
+		if( ( pxExceptionInfo->ExceptionRecord->ExceptionCode == EXCEPTION_STACK_OVERFLOW ) && ( xPortRunning == pdTRUE ) )
+		{
+			/* Only the thread of the task in the Running state runs, so if the
+			exception is raised in that thread then that task overflowed. */
+			pxThreadState = ( xThreadState * ) *( ( size_t * ) pxCurrentTCB );
+
+			if( ( pxThreadState->pvThread != NULL ) && ( GetThreadId( pxThreadState->pvThread ) == GetCurrentThreadId() ) )
+			{
+				printf( "Stack overflow in task %s\r\n", pcTaskGetName( NULL ) );
+				vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcTaskGetName( NULL ) );
+			}
+		}
+
+		/* Let Windows end the process as normal if the hook returns. */
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+
+#endif /* configWIN32_GUARDED_TASK_STACKS */
+/*-----------------------------------------------------------*/
+
 BaseType_t xPortStartScheduler( void )
 {
 void *pvHandle = NULL;
@@ -263,6 +392,13 @@ SYSTEM_INFO xSystemInfo;
 		vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
 		vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
 
+		#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+		{
+			/* Report tasks that overflow their stacks. */
+			AddVectoredExceptionHandler( 1, prvStackOverflowHandler );
+		}
+		#endif
+
 		/* Create the events and mutexes that are used to synchronise all the
 		threads. */
 		pvInterruptEventMutex = CreateMutex( NULL, FALSE, NULL );
@@ -123,11 +123,59 @@ void vPortExitCritical( void );
 
 #endif /* taskRECORD_READY_PRIORITY */
 
+/* The address pvPortMalloc() will return to, used by the heap caller ledger
+(configUSE_HEAP_CALLER_LEDGER) to identify the call site. */
+#ifdef __GNUC__
+	#define portGET_RETURN_ADDRESS() __builtin_return_address( 0 )
+#else
+	void *_ReturnAddress( void );
+	#pragma intrinsic( _ReturnAddress )
+	#define portGET_RETURN_ADDRESS() _ReturnAddress()
+#endif /* __GNUC__ */
+
+/* A free running count of processor cycles, truncated to 32 bits, used to time
+short sections of code such as fast timer callbacks. */
+#ifdef __GNUC__
+	#define portGET_CYCLE_COUNT() ( ( uint32_t ) __builtin_ia32_rdtsc() )
+#else
+	unsigned __int64 __rdtsc( void );
+	#pragma intrinsic( __rdtsc )
+	#define portGET_CYCLE_COUNT() ( ( uint32_t ) __rdtsc() )
+#endif /* __GNUC__ */
+
 #ifndef __GNUC__
 	__pragma( warning( disable:4211 ) ) /* Nonstandard extension used, as extern is only nonstandard to MSVC. */
 #endif
 
 
+/* Set configWIN32_GUARDED_TASK_STACKS to 1 in FreeRTOSConfig.h to size the
+stack of the thread that runs each task from the stack depth the task was
+created with, multiplied by configWIN32_TASK_STACK_MULTIPLIER.  A task that uses
+more stack than that overflows the stack of its thread, which Windows traps,
+and the port reports the name of the task.  Normally each thread has a large
+default stack and a task can use far more stack than it was given without
+anything being noticed.  This is not an exact overflow check: only a task that
+uses more than configWIN32_TASK_STACK_MULTIPLIER times the stack it was created
+with (four times by default) is trapped.  A task that overruns its stack by
+less than that is not reported, and would overflow on an embedded target. */
+#ifndef configWIN32_GUARDED_TASK_STACKS
+	#define configWIN32_GUARDED_TASK_STACKS 0
+#endif
+
+/* When configWIN32_GUARDED_TASK_STACKS is 1, the thread that runs each task is
+given configWIN32_TASK_STACK_MULTIPLIER times the stack the task was created
+with.  The Windows and C library functions tasks call use much more stack than
+their equivalents on an embedded target, so raise it if tasks with small stacks
+that call them, printf() in particular, are reported as overflowing. */
+#ifndef configWIN32_TASK_STACK_MULTIPLIER
+	#define configWIN32_TASK_STACK_MULTIPLIER 4
+#endif
+
+#if( configWIN32_GUARDED_TASK_STACKS == 1 )
+	/* pxPortInitialiseStack() needs the end of the stack to size the thread. */
+	#define portHAS_STACK_OVERFLOW_CHECKING 1
+#endif
+
 /* Task function macros as described on the FreeRTOS.org WEB site. */
 #define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void * pvParameters )
@@ -49,6 +49,27 @@ task.h is included from an application file. */
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	#ifndef portGET_RETURN_ADDRESS
+		#error portGET_RETURN_ADDRESS() must be defined by the port to use the heap caller ledger
+	#endif
+
+	#if( configHEAP_CALLER_LEDGER_LENGTH < 2 )
+		#error configHEAP_CALLER_LEDGER_LENGTH must be at least 2, as the last entry records the callers that do not fit in the ledger
+	#endif
+#endif
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#error configUSE_HEAP_TASK_CACHE is only supported by heap_5.c
+#endif
+
+/* Allocations that would take the calling task over its heap quota fail. */
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	#define heapWITHIN_QUOTA( uxHeapAccount )	( ( uxHeapAccount ) != taskHEAP_QUOTA_EXCEEDED )
+#else
+	#define heapWITHIN_QUOTA( uxHeapAccount )	pdTRUE
+#endif
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
 
@@ -70,6 +91,14 @@ typedef struct A_BLOCK_LINK
 {
 	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next free block in the list. */
 	size_t xBlockSize;						/*<< The size of the free block. */
+
+	#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+		HeapLedgerEntry_t *pxLedgerEntry;	/*<< The ledger entry of the call site that allocated the block. */
+	#endif
+
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		UBaseType_t uxHeapAccount;			/*<< The task heap account the block is charged to. */
+	#endif
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
@@ -88,6 +117,29 @@ static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
  */
 static void prvHeapInit( void );
 
+/*
+ * Returns the vPortGetHeapStats() size class of a free block.
+ */
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize );
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	/*
+	 * Records a block that has just been allocated against the ledger entry of
+	 * the call site that allocated it, or against the last entry if the ledger
+	 * is full.  Finding the entry is a linear search, so the ledger is intended
+	 * for profiling rather than production builds.
+	 */
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller );
+
+	/*
+	 * Removes a block that is being freed from the ledger entry it was recorded
+	 * against.
+	 */
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock );
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -102,6 +154,20 @@ fragmentation. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
 
+/* Allocation counters reported by vPortGetHeapStats(). */
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+static uint64_t ullBytesAllocated = 0U;
+static uint64_t ullBytesFreed = 0U;
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	/* One entry per call site, in the order the call sites first allocated.
+	The last entry is shared by the call sites that do not get an entry of
+	their own. */
+	static HeapLedgerEntry_t xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH ];
+	static UBaseType_t uxHeapLedgerEntriesUsed = 0U;
+#endif
+
 /* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
 member of an BlockLink_t structure is set then the block belongs to the
 application.  When the bit is free the block is still part of the free heap
@@ -114,6 +180,12 @@ void *pvPortMalloc( size_t xWantedSize )
 {
 BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
 void *pvReturn = NULL;
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	void * const pvCaller = portGET_RETURN_ADDRESS();
+#endif
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	UBaseType_t uxHeapAccount = 0;
+#endif
 
 	vTaskSuspendAll();
 	{
@@ -158,7 +230,13 @@ void *pvReturn = NULL;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+			#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+			{
+				uxHeapAccount = uxTaskHeapCheckQuota( xWantedSize );
+			}
+			#endif
+
+			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) && heapWITHIN_QUOTA( uxHeapAccount ) )
 			{
 				/* Traverse the list from the start	(lowest address) block until
 				one	of adequate size is found. */
@@ -170,9 +248,25 @@ void *pvReturn = NULL;
 					pxBlock = pxBlock->pxNextFreeBlock;
 				}
 
+				#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+				{
+					/* A block too small to split is allocated, and so charged, whole.
+					The quota was only checked against the wanted size, so check it
+					again against the size that will be charged. */
+					if( ( pxBlock != pxEnd ) && ( ( pxBlock->xBlockSize - xWantedSize ) <= heapMINIMUM_BLOCK_SIZE ) )
+					{
+						uxHeapAccount = uxTaskHeapCheckQuota( pxBlock->xBlockSize );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif
+
 				/* If the end marker was reached then a block of adequate size
 				was	not found. */
-				if( pxBlock != pxEnd )
+				if( ( pxBlock != pxEnd ) && heapWITHIN_QUOTA( uxHeapAccount ) )
 				{
 					/* Return the memory space pointed to - jumping over the
 					BlockLink_t structure at its start. */
@@ -217,6 +311,22 @@ void *pvReturn = NULL;
 						mtCOVERAGE_TEST_MARKER();
 					}
 
+					xNumberOfSuccessfulAllocations++;
+					ullBytesAllocated += ( uint64_t ) pxBlock->xBlockSize;
+
+					#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+					{
+						prvLedgerRecordAllocation( pxBlock, pvCaller );
+					}
+					#endif
+
+					#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+					{
+						pxBlock->uxHeapAccount = uxHeapAccount;
+						vTaskHeapCharge( uxHeapAccount, pxBlock->xBlockSize );
+					}
+					#endif
+
 					/* The block is being returned - it is allocated and owned
 					by the application and has no "next" block. */
 					pxBlock->xBlockSize |= xBlockAllocatedBit;
@@ -241,6 +351,20 @@ void *pvReturn = NULL;
 	}
 	( void ) xTaskResumeAll();
 
+	#if( ( configUSE_TASK_HEAP_ACCOUNTING == 1 ) && ( configUSE_HEAP_QUOTA_HOOK == 1 ) )
+	{
+		if( uxHeapAccount == taskHEAP_QUOTA_EXCEEDED )
+		{
+			extern void vApplicationHeapQuotaHook( size_t xWantedSize );
+			vApplicationHeapQuotaHook( xWantedSize );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
 	{
 		if( pvReturn == NULL )
@@ -290,6 +414,21 @@ BlockLink_t *pxLink;
 				{
 					/* Add this block to the list of free blocks. */
 					xFreeBytesRemaining += pxLink->xBlockSize;
+					xNumberOfSuccessfulFrees++;
+					ullBytesFreed += ( uint64_t ) pxLink->xBlockSize;
+
+					#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+					{
+						prvLedgerRecordFree( pxLink );
+					}
+					#endif
+
+					#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+					{
+						vTaskHeapCredit( pxLink->uxHeapAccount, pxLink->xBlockSize );
+					}
+					#endif
+
 					traceFREE( pv, pxLink->xBlockSize );
 					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
 				}
@@ -320,6 +459,185 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockLink_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0;
+UBaseType_t uxClass;
+
+	configASSERT( pxHeapStats );
+
+	for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES; uxClass++ )
+	{
+		pxHeapStats->xFreeBlocksBySize[ uxClass ] = 0;
+	}
+
+	vTaskSuspendAll();
+	{
+		pxBlock = xStart.pxNextFreeBlock;
+
+		/* pxBlock will be NULL if the heap has not been initialised. */
+		if( pxBlock != NULL )
+		{
+			while( pxBlock != pxEnd )
+			{
+				xBlocks++;
+
+				if( pxBlock->xBlockSize > xMaxSize )
+				{
+					xMaxSize = pxBlock->xBlockSize;
+				}
+
+				if( ( xMinSize == 0 ) || ( pxBlock->xBlockSize < xMinSize ) )
+				{
+					xMinSize = pxBlock->xBlockSize;
+				}
+
+				( pxHeapStats->xFreeBlocksBySize[ prvHeapSizeClass( pxBlock->xBlockSize ) ] )++;
+
+				pxBlock = pxBlock->pxNextFreeBlock;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->ullBytesAllocated = ullBytesAllocated;
+		pxHeapStats->ullBytesFreed = ullBytesFreed;
+	}
+	( void ) xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize )
+{
+UBaseType_t uxClass = 0;
+
+	/* Class 0 holds blocks below 32 bytes, and each class after that covers
+	twice the range of the one before. */
+	xBlockSize >>= 5;
+
+	while( ( xBlockSize != 0 ) && ( uxClass < ( ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES - 1U ) ) )
+	{
+		xBlockSize >>= 1;
+		uxClass++;
+	}
+
+	return uxClass;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller )
+	{
+	HeapLedgerEntry_t *pxEntry = NULL;
+	UBaseType_t uxEntry;
+
+		/* Called with the scheduler suspended. */
+		for( uxEntry = 0; uxEntry < uxHeapLedgerEntriesUsed; uxEntry++ )
+		{
+			if( xHeapLedger[ uxEntry ].pvCaller == pvCaller )
+			{
+				pxEntry = &( xHeapLedger[ uxEntry ] );
+				break;
+			}
+		}
+
+		if( pxEntry == NULL )
+		{
+			if( uxHeapLedgerEntriesUsed < ( ( UBaseType_t ) configHEAP_CALLER_LEDGER_LENGTH - 1U ) )
+			{
+				pxEntry = &( xHeapLedger[ uxHeapLedgerEntriesUsed ] );
+				pxEntry->pvCaller = pvCaller;
+				uxHeapLedgerEntriesUsed++;
+			}
+			else
+			{
+				/* The ledger is full.  The last entry keeps a NULL caller. */
+				pxEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxEntry->xNumberOfAllocations )++;
+		( pxEntry->xBlocksInUse )++;
+		pxEntry->xBytesInUse += pxBlock->xBlockSize;
+
+		if( pxEntry->xBytesInUse > pxEntry->xPeakBytesInUse )
+		{
+			pxEntry->xPeakBytesInUse = pxEntry->xBytesInUse;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxBlock->pxLedgerEntry = pxEntry;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock )
+	{
+	HeapLedgerEntry_t *pxEntry = pxBlock->pxLedgerEntry;
+
+		/* Called with the scheduler suspended, after the allocated bit has
+		been cleared from the block size. */
+		configASSERT( pxEntry != NULL );
+		configASSERT( pxEntry->xBlocksInUse > 0 );
+
+		( pxEntry->xBlocksInUse )--;
+		pxEntry->xBytesInUse -= pxBlock->xBlockSize;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortGetHeapLedger( HeapLedgerEntry_t *pxLedger, UBaseType_t uxLedgerLength )
+	{
+	UBaseType_t uxEntry, uxEntries = 0;
+	const HeapLedgerEntry_t *pxOverflowEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+
+		configASSERT( pxLedger );
+
+		vTaskSuspendAll();
+		{
+			for( uxEntry = 0; ( uxEntry < uxHeapLedgerEntriesUsed ) && ( uxEntries < uxLedgerLength ); uxEntry++ )
+			{
+				pxLedger[ uxEntries ] = xHeapLedger[ uxEntry ];
+				uxEntries++;
+			}
+
+			/* Only report the entry shared by the call sites that did not fit
+			if it has been used. */
+			if( ( pxOverflowEntry->xNumberOfAllocations > 0 ) && ( uxEntries < uxLedgerLength ) )
+			{
+				pxLedger[ uxEntries ] = *pxOverflowEntry;
+				uxEntries++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxEntries;
+	}
+
+#endif /* configUSE_HEAP_CALLER_LEDGER */
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
 	/* This just exists to keep the linker quiet. */
@@ -66,6 +66,16 @@
  *
  * Note 0x80000000 is the lower address so appears in the array first.
  *
+ * If configUSE_HEAP_TASK_CACHE is 1 then each task keeps the small blocks it
+ * both allocated and freed in a cache in its TCB, up to configHEAP_TASK_CACHE_DEPTH blocks in each
+ * of configHEAP_TASK_CACHE_CLASSES size classes, and reuses them for its later
+ * requests without suspending the scheduler.  When a class is full half of it
+ * is returned to the heap in a single batch.  Blocks held in a cache are still
+ * counted as allocated by xPortGetFreeHeapSize(), vPortGetHeapStats() and the
+ * task heap accounts, and are returned to the heap when the task is deleted.
+ * A task that is deleted by another task while it is part way through taking a
+ * block from, or putting blocks into, its cache can leak the blocks involved.
+ *
  */
 #include <stdlib.h>
 
@@ -83,6 +93,50 @@ task.h is included from an application file. */
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	#ifndef portGET_RETURN_ADDRESS
+		#error portGET_RETURN_ADDRESS() must be defined by the port to use the heap caller ledger
+	#endif
+
+	#if( configHEAP_CALLER_LEDGER_LENGTH < 2 )
+		#error configHEAP_CALLER_LEDGER_LENGTH must be at least 2, as the last entry records the callers that do not fit in the ledger
+	#endif
+#endif
+
+/* Allocations that would take the calling task over its heap quota fail. */
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	#define heapWITHIN_QUOTA( uxHeapAccount )	( ( uxHeapAccount ) != taskHEAP_QUOTA_EXCEEDED )
+#else
+	#define heapWITHIN_QUOTA( uxHeapAccount )	pdTRUE
+#endif
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#if( ( configHEAP_TASK_CACHE_DEPTH < 1 ) || ( configHEAP_TASK_CACHE_DEPTH > 255 ) )
+		#error configHEAP_TASK_CACHE_DEPTH must be between 1 and 255
+	#endif
+
+	/* Class n of a task's heap cache holds blocks of at least
+	heapCACHE_CLASS_SIZE( n ) bytes, and less than heapCACHE_CLASS_SIZE( n + 1 )
+	bytes, including the BlockLink_t structure. */
+	#define heapCACHE_CLASS_SIZE( uxClass )			( ( ( size_t ) 16 ) << ( uxClass ) )
+	#define heapTAKE_FROM_TASK_CACHE( xWantedSize )	prvTakeFromTaskCache( xWantedSize )
+	#define heapRETURN_TO_TASK_CACHE( pxLink )		prvReturnToTaskCache( pxLink )
+
+	/* A task only caches the blocks it allocated itself, so blocks passed to
+	another task, such as the idle or timer task, and freed there go back to
+	the heap rather than into a cache that will never use them.  The block must
+	also still be charged to the task's own heap account, so the bytes held in
+	caches are always charged to the task holding them. */
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		#define heapCACHE_OWNS_BLOCK( pxCache, pxLink )	( ( ( pxLink )->pxOwnerCache == ( pxCache ) ) && ( ( pxLink )->uxHeapAccount == uxTaskGetHeapAccount() ) )
+	#else
+		#define heapCACHE_OWNS_BLOCK( pxCache, pxLink )	( ( pxLink )->pxOwnerCache == ( pxCache ) )
+	#endif
+#else
+	#define heapTAKE_FROM_TASK_CACHE( xWantedSize )	NULL
+	#define heapRETURN_TO_TASK_CACHE( pxLink )		pdFALSE
+#endif
+
 /* Block sizes must not get too small. */
 #define heapMINIMUM_BLOCK_SIZE	( ( size_t ) ( xHeapStructSize << 1 ) )
 
@@ -95,6 +149,18 @@ typedef struct A_BLOCK_LINK
 {
 	struct A_BLOCK_LINK *pxNextFreeBlock;	/*<< The next free block in the list. */
 	size_t xBlockSize;						/*<< The size of the free block. */
+
+	#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+		HeapLedgerEntry_t *pxLedgerEntry;	/*<< The ledger entry of the call site that allocated the block. */
+	#endif
+
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		UBaseType_t uxHeapAccount;			/*<< The task heap account the block is charged to. */
+	#endif
+
+	#if( configUSE_HEAP_TASK_CACHE == 1 )
+		HeapTaskCache_t *pxOwnerCache;		/*<< The heap cache of the task that allocated the block, or NULL if it was allocated before the scheduler started. */
+	#endif
 } BlockLink_t;
 
 /*-----------------------------------------------------------*/
@@ -107,6 +173,61 @@ typedef struct A_BLOCK_LINK
  */
 static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
 
+/*
+ * Returns the vPortGetHeapStats() size class of a free block.
+ */
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize );
+
+/*
+ * Returns an allocated block to the list of free blocks and updates the
+ * statistics.  Called with the scheduler suspended.
+ */
+static void prvFreeBlock( BlockLink_t *pxLink );
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	/*
+	 * Takes a block of at least the size pvPortMalloc() would allocate for
+	 * xWantedSize from the calling task's heap cache.  Returns NULL if the
+	 * request is too large for the cache or the cache holds no suitable block.
+	 */
+	static void *prvTakeFromTaskCache( size_t xWantedSize );
+
+	/*
+	 * Puts a block that is being freed into the calling task's heap cache,
+	 * flushing part of the cache first if the block's class is full.  Returns
+	 * pdFALSE, leaving the block untouched, if the block is the wrong size for
+	 * the cache, was allocated by a different task, or is charged to a different
+	 * task's heap account.
+	 */
+	static BaseType_t prvReturnToTaskCache( BlockLink_t *pxLink );
+
+	/*
+	 * Returns all but the first uxBlocksToKeep blocks of a cache class to the
+	 * heap, suspending the scheduler once for the whole batch.
+	 */
+	static void prvFlushTaskCacheClass( HeapTaskCache_t *pxCache, UBaseType_t uxClass, UBaseType_t uxBlocksToKeep );
+
+#endif
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	/*
+	 * Records a block that has just been allocated against the ledger entry of
+	 * the call site that allocated it, or against the last entry if the ledger
+	 * is full.  Finding the entry is a linear search, so the ledger is intended
+	 * for profiling rather than production builds.
+	 */
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller );
+
+	/*
+	 * Removes a block that is being freed from the ledger entry it was recorded
+	 * against.
+	 */
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock );
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The size of the structure placed at the beginning of each allocated memory
@@ -121,6 +242,20 @@ fragmentation. */
 static size_t xFreeBytesRemaining = 0U;
 static size_t xMinimumEverFreeBytesRemaining = 0U;
 
+/* Allocation counters reported by vPortGetHeapStats(). */
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+static uint64_t ullBytesAllocated = 0U;
+static uint64_t ullBytesFreed = 0U;
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	/* One entry per call site, in the order the call sites first allocated.
+	The last entry is shared by the call sites that do not get an entry of
+	their own. */
+	static HeapLedgerEntry_t xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH ];
+	static UBaseType_t uxHeapLedgerEntriesUsed = 0U;
+#endif
+
 /* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
 member of an BlockLink_t structure is set then the block belongs to the
 application.  When the bit is free the block is still part of the free heap
@@ -133,104 +268,165 @@ void *pvPortMalloc( size_t xWantedSize )
 {
 BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
 void *pvReturn = NULL;
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	void * const pvCaller = portGET_RETURN_ADDRESS();
+#endif
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	UBaseType_t uxHeapAccount = 0;
+#endif
 
 	/* The heap must be initialised before the first call to
 	prvPortMalloc(). */
 	configASSERT( pxEnd );
 
-	vTaskSuspendAll();
+	/* Small requests are satisfied from the calling task's heap cache when it
+	holds a suitable block, which does not need the scheduler to be suspended. */
+	pvReturn = heapTAKE_FROM_TASK_CACHE( xWantedSize );
+
+	if( pvReturn == NULL )
 	{
-		/* Check the requested block size is not so large that the top bit is
-		set.  The top bit of the block size member of the BlockLink_t structure
-		is used to determine who owns the block - the application or the
-		kernel, so it must be free. */
-		if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+		vTaskSuspendAll();
 		{
-			/* The wanted size is increased so it can contain a BlockLink_t
-			structure in addition to the requested amount of bytes. */
-			if( xWantedSize > 0 )
+			/* Check the requested block size is not so large that the top bit is
+			set.  The top bit of the block size member of the BlockLink_t structure
+			is used to determine who owns the block - the application or the
+			kernel, so it must be free. */
+			if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
 			{
-				xWantedSize += xHeapStructSize;
-
-				/* Ensure that blocks are always aligned to the required number
-				of bytes. */
-				if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+				/* The wanted size is increased so it can contain a BlockLink_t
+				structure in addition to the requested amount of bytes. */
+				if( xWantedSize > 0 )
 				{
-					/* Byte alignment required. */
-					xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+					xWantedSize += xHeapStructSize;
+
+					/* Ensure that blocks are always aligned to the required number
+					of bytes. */
+					if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+					{
+						/* Byte alignment required. */
+						xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
-			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
 
-			if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
-			{
-				/* Traverse the list from the start	(lowest address) block until
-				one	of adequate size is found. */
-				pxPreviousBlock = &xStart;
-				pxBlock = xStart.pxNextFreeBlock;
-				while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+				#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
 				{
-					pxPreviousBlock = pxBlock;
-					pxBlock = pxBlock->pxNextFreeBlock;
+					uxHeapAccount = uxTaskHeapCheckQuota( xWantedSize );
 				}
+				#endif
 
-				/* If the end marker was reached then a block of adequate size
-				was	not found. */
-				if( pxBlock != pxEnd )
+				if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) && heapWITHIN_QUOTA( uxHeapAccount ) )
 				{
-					/* Return the memory space pointed to - jumping over the
-					BlockLink_t structure at its start. */
-					pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
-
-					/* This block is being returned for use so must be taken out
-					of the list of free blocks. */
-					pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
-
-					/* If the block is larger than required it can be split into
-					two. */
-					if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+					/* Traverse the list from the start	(lowest address) block until
+					one	of adequate size is found. */
+					pxPreviousBlock = &xStart;
+					pxBlock = xStart.pxNextFreeBlock;
+					while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
 					{
-						/* This block is to be split into two.  Create a new
-						block following the number of bytes requested. The void
-						cast is used to prevent byte alignment warnings from the
-						compiler. */
-						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
-
-						/* Calculate the sizes of two blocks split from the
-						single block. */
-						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
-						pxBlock->xBlockSize = xWantedSize;
-
-						/* Insert the new block into the list of free blocks. */
-						prvInsertBlockIntoFreeList( ( pxNewBlockLink ) );
+						pxPreviousBlock = pxBlock;
+						pxBlock = pxBlock->pxNextFreeBlock;
 					}
-					else
+
+					#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
 					{
-						mtCOVERAGE_TEST_MARKER();
+						/* A block too small to split is allocated, and so charged, whole.
+						The quota was only checked against the wanted size, so check it
+						again against the size that will be charged. */
+						if( ( pxBlock != pxEnd ) && ( ( pxBlock->xBlockSize - xWantedSize ) <= heapMINIMUM_BLOCK_SIZE ) )
+						{
+							uxHeapAccount = uxTaskHeapCheckQuota( pxBlock->xBlockSize );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
+					#endif
 
-					xFreeBytesRemaining -= pxBlock->xBlockSize;
-
-					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					/* If the end marker was reached then a block of adequate size
+					was	not found. */
+					if( ( pxBlock != pxEnd ) && heapWITHIN_QUOTA( uxHeapAccount ) )
 					{
-						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+						/* Return the memory space pointed to - jumping over the
+						BlockLink_t structure at its start. */
+						pvReturn = ( void * ) ( ( ( uint8_t * ) pxPreviousBlock->pxNextFreeBlock ) + xHeapStructSize );
+
+						/* This block is being returned for use so must be taken out
+						of the list of free blocks. */
+						pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+						/* If the block is larger than required it can be split into
+						two. */
+						if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+						{
+							/* This block is to be split into two.  Create a new
+							block following the number of bytes requested. The void
+							cast is used to prevent byte alignment warnings from the
+							compiler. */
+							pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+
+							/* Calculate the sizes of two blocks split from the
+							single block. */
+							pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+							pxBlock->xBlockSize = xWantedSize;
+
+							/* Insert the new block into the list of free blocks. */
+							prvInsertBlockIntoFreeList( ( pxNewBlockLink ) );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+						if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+						{
+							xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						xNumberOfSuccessfulAllocations++;
+						ullBytesAllocated += ( uint64_t ) pxBlock->xBlockSize;
+
+						#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+						{
+							prvLedgerRecordAllocation( pxBlock, pvCaller );
+						}
+						#endif
+
+						#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+						{
+							pxBlock->uxHeapAccount = uxHeapAccount;
+							vTaskHeapCharge( uxHeapAccount, pxBlock->xBlockSize );
+						}
+						#endif
+
+						#if( configUSE_HEAP_TASK_CACHE == 1 )
+						{
+							pxBlock->pxOwnerCache = pxTaskGetHeapCache();
+						}
+						#endif
+
+						/* The block is being returned - it is allocated and owned
+						by the application and has no "next" block. */
+						pxBlock->xBlockSize |= xBlockAllocatedBit;
+						pxBlock->pxNextFreeBlock = NULL;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-
-					/* The block is being returned - it is allocated and owned
-					by the application and has no "next" block. */
-					pxBlock->xBlockSize |= xBlockAllocatedBit;
-					pxBlock->pxNextFreeBlock = NULL;
 				}
 				else
 				{
@@ -241,15 +437,29 @@ void *pvReturn = NULL;
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+
+			traceMALLOC( pvReturn, xWantedSize );
+		}
+		( void ) xTaskResumeAll();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	#if( ( configUSE_TASK_HEAP_ACCOUNTING == 1 ) && ( configUSE_HEAP_QUOTA_HOOK == 1 ) )
+	{
+		if( uxHeapAccount == taskHEAP_QUOTA_EXCEEDED )
+		{
+			extern void vApplicationHeapQuotaHook( size_t xWantedSize );
+			vApplicationHeapQuotaHook( xWantedSize );
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-
-		traceMALLOC( pvReturn, xWantedSize );
 	}
-	( void ) xTaskResumeAll();
+	#endif
 
 	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
 	{
@@ -291,18 +501,21 @@ BlockLink_t *pxLink;
 		{
 			if( pxLink->pxNextFreeBlock == NULL )
 			{
-				/* The block is being returned to the heap - it is no longer
-				allocated. */
-				pxLink->xBlockSize &= ~xBlockAllocatedBit;
-
-				vTaskSuspendAll();
+				/* Small blocks are kept in the calling task's heap cache if
+				there is room, which does not need the scheduler to be
+				suspended.  Anything else is returned to the heap. */
+				if( heapRETURN_TO_TASK_CACHE( pxLink ) == pdFALSE )
 				{
-					/* Add this block to the list of free blocks. */
-					xFreeBytesRemaining += pxLink->xBlockSize;
-					traceFREE( pv, pxLink->xBlockSize );
-					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+					vTaskSuspendAll();
+					{
+						prvFreeBlock( pxLink );
+					}
+					( void ) xTaskResumeAll();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
 				}
-				( void ) xTaskResumeAll();
 			}
 			else
 			{
@@ -317,6 +530,211 @@ BlockLink_t *pxLink;
 }
 /*-----------------------------------------------------------*/
 
+static void prvFreeBlock( BlockLink_t *pxLink )
+{
+	/* The block is being returned to the heap - it is no longer allocated. */
+	pxLink->xBlockSize &= ~xBlockAllocatedBit;
+
+	/* Add this block to the list of free blocks. */
+	xFreeBytesRemaining += pxLink->xBlockSize;
+	xNumberOfSuccessfulFrees++;
+	ullBytesFreed += ( uint64_t ) pxLink->xBlockSize;
+
+	#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	{
+		prvLedgerRecordFree( pxLink );
+	}
+	#endif
+
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	{
+		vTaskHeapCredit( pxLink->uxHeapAccount, pxLink->xBlockSize );
+	}
+	#endif
+
+	traceFREE( ( ( uint8_t * ) pxLink ) + xHeapStructSize, pxLink->xBlockSize );
+	prvInsertBlockIntoFreeList( pxLink );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	static void *prvTakeFromTaskCache( size_t xWantedSize )
+	{
+	HeapTaskCache_t * const pxCache = pxTaskGetHeapCache();
+	BlockLink_t *pxBlock;
+	UBaseType_t uxClass;
+	size_t xBlockSize;
+	void *pvReturn = NULL;
+
+		/* Requests larger than the smallest block in the largest class are
+		never satisfied from the cache, which also stops the size calculation
+		below overflowing. */
+		if( ( pxCache != NULL ) && ( xWantedSize > 0 ) && ( xWantedSize <= heapCACHE_CLASS_SIZE( configHEAP_TASK_CACHE_CLASSES - 1 ) ) )
+		{
+			/* The size of the block pvPortMalloc() would allocate. */
+			xBlockSize = ( xWantedSize + xHeapStructSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+			/* Every block in the smallest class whose minimum size is at least
+			xBlockSize is big enough. */
+			for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_TASK_CACHE_CLASSES; uxClass++ )
+			{
+				if( heapCACHE_CLASS_SIZE( uxClass ) >= xBlockSize )
+				{
+					break;
+				}
+			}
+
+			if( uxClass < ( UBaseType_t ) configHEAP_TASK_CACHE_CLASSES )
+			{
+				pxBlock = ( BlockLink_t * ) pxCache->pvBlocks[ uxClass ];
+
+				if( pxBlock != NULL )
+				{
+					pxCache->pvBlocks[ uxClass ] = ( void * ) pxBlock->pxNextFreeBlock;
+					( pxCache->ucBlockCounts[ uxClass ] )--;
+
+					/* The block is still marked as allocated, and is still
+					owned by and charged to the task, so only the link needs
+					clearing. */
+					pxBlock->pxNextFreeBlock = NULL;
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+					traceMALLOC( pvReturn, xWantedSize );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pvReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReturnToTaskCache( BlockLink_t *pxLink )
+	{
+	HeapTaskCache_t * const pxCache = pxTaskGetHeapCache();
+	const size_t xBlockSize = pxLink->xBlockSize & ~xBlockAllocatedBit;
+	UBaseType_t uxClass;
+	BaseType_t xReturn = pdFALSE;
+
+		if( ( pxCache != NULL ) &&
+			( xBlockSize >= heapCACHE_CLASS_SIZE( 0 ) ) &&
+			( xBlockSize < heapCACHE_CLASS_SIZE( configHEAP_TASK_CACHE_CLASSES ) ) &&
+			heapCACHE_OWNS_BLOCK( pxCache, pxLink ) )
+		{
+			/* Find the largest class whose minimum size the block meets. */
+			uxClass = ( UBaseType_t ) configHEAP_TASK_CACHE_CLASSES - 1U;
+			while( heapCACHE_CLASS_SIZE( uxClass ) > xBlockSize )
+			{
+				uxClass--;
+			}
+
+			/* If the class is full then return half of it to the heap in one
+			go, so the scheduler is suspended once per batch rather than once
+			per block. */
+			if( pxCache->ucBlockCounts[ uxClass ] >= ( uint8_t ) configHEAP_TASK_CACHE_DEPTH )
+			{
+				prvFlushTaskCacheClass( pxCache, uxClass, ( UBaseType_t ) configHEAP_TASK_CACHE_DEPTH / 2U );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxLink->pxNextFreeBlock = ( BlockLink_t * ) pxCache->pvBlocks[ uxClass ];
+			pxCache->pvBlocks[ uxClass ] = ( void * ) pxLink;
+			( pxCache->ucBlockCounts[ uxClass ] )++;
+			traceFREE( ( ( uint8_t * ) pxLink ) + xHeapStructSize, xBlockSize );
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvFlushTaskCacheClass( HeapTaskCache_t *pxCache, UBaseType_t uxClass, UBaseType_t uxBlocksToKeep )
+	{
+	BlockLink_t *pxBlock, *pxNextBlock;
+	UBaseType_t uxBlock;
+
+		/* Detach the blocks after the first uxBlocksToKeep from the class. */
+		if( uxBlocksToKeep == 0U )
+		{
+			pxBlock = ( BlockLink_t * ) pxCache->pvBlocks[ uxClass ];
+			pxCache->pvBlocks[ uxClass ] = NULL;
+		}
+		else
+		{
+			pxNextBlock = ( BlockLink_t * ) pxCache->pvBlocks[ uxClass ];
+
+			for( uxBlock = 1U; ( uxBlock < uxBlocksToKeep ) && ( pxNextBlock != NULL ); uxBlock++ )
+			{
+				pxNextBlock = pxNextBlock->pxNextFreeBlock;
+			}
+
+			if( pxNextBlock != NULL )
+			{
+				pxBlock = pxNextBlock->pxNextFreeBlock;
+				pxNextBlock->pxNextFreeBlock = NULL;
+			}
+			else
+			{
+				pxBlock = NULL;
+			}
+		}
+
+		pxCache->ucBlockCounts[ uxClass ] = ( uint8_t ) uxBlocksToKeep;
+
+		if( pxBlock != NULL )
+		{
+			vTaskSuspendAll();
+			{
+				while( pxBlock != NULL )
+				{
+					pxNextBlock = pxBlock->pxNextFreeBlock;
+					pxBlock->pxNextFreeBlock = NULL;
+					prvFreeBlock( pxBlock );
+					pxBlock = pxNextBlock;
+				}
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortFreeTaskHeapCache( HeapTaskCache_t *pxCache )
+	{
+	UBaseType_t uxClass;
+
+		configASSERT( pxCache );
+
+		for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_TASK_CACHE_CLASSES; uxClass++ )
+		{
+			prvFlushTaskCacheClass( pxCache, uxClass, 0U );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+
 size_t xPortGetFreeHeapSize( void )
 {
 	return xFreeBytesRemaining;
@@ -329,6 +747,194 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockLink_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0;
+UBaseType_t uxClass;
+
+	configASSERT( pxHeapStats );
+
+	for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES; uxClass++ )
+	{
+		pxHeapStats->xFreeBlocksBySize[ uxClass ] = 0;
+	}
+
+	vTaskSuspendAll();
+	{
+		pxBlock = xStart.pxNextFreeBlock;
+
+		/* pxBlock will be NULL if the heap has not been initialised. */
+		if( pxBlock != NULL )
+		{
+			while( pxBlock != pxEnd )
+			{
+				/* The end markers of all but the last region are also in the
+				list, but do not hold any memory. */
+				if( pxBlock->xBlockSize > 0 )
+				{
+					xBlocks++;
+
+					if( pxBlock->xBlockSize > xMaxSize )
+					{
+						xMaxSize = pxBlock->xBlockSize;
+					}
+
+					if( ( xMinSize == 0 ) || ( pxBlock->xBlockSize < xMinSize ) )
+					{
+						xMinSize = pxBlock->xBlockSize;
+					}
+
+					( pxHeapStats->xFreeBlocksBySize[ prvHeapSizeClass( pxBlock->xBlockSize ) ] )++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxBlock = pxBlock->pxNextFreeBlock;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->ullBytesAllocated = ullBytesAllocated;
+		pxHeapStats->ullBytesFreed = ullBytesFreed;
+	}
+	( void ) xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize )
+{
+UBaseType_t uxClass = 0;
+
+	/* Class 0 holds blocks below 32 bytes, and each class after that covers
+	twice the range of the one before. */
+	xBlockSize >>= 5;
+
+	while( ( xBlockSize != 0 ) && ( uxClass < ( ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES - 1U ) ) )
+	{
+		xBlockSize >>= 1;
+		uxClass++;
+	}
+
+	return uxClass;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller )
+	{
+	HeapLedgerEntry_t *pxEntry = NULL;
+	UBaseType_t uxEntry;
+
+		/* Called with the scheduler suspended. */
+		for( uxEntry = 0; uxEntry < uxHeapLedgerEntriesUsed; uxEntry++ )
+		{
+			if( xHeapLedger[ uxEntry ].pvCaller == pvCaller )
+			{
+				pxEntry = &( xHeapLedger[ uxEntry ] );
+				break;
+			}
+		}
+
+		if( pxEntry == NULL )
+		{
+			if( uxHeapLedgerEntriesUsed < ( ( UBaseType_t ) configHEAP_CALLER_LEDGER_LENGTH - 1U ) )
+			{
+				pxEntry = &( xHeapLedger[ uxHeapLedgerEntriesUsed ] );
+				pxEntry->pvCaller = pvCaller;
+				uxHeapLedgerEntriesUsed++;
+			}
+			else
+			{
+				/* The ledger is full.  The last entry keeps a NULL caller. */
+				pxEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxEntry->xNumberOfAllocations )++;
+		( pxEntry->xBlocksInUse )++;
+		pxEntry->xBytesInUse += pxBlock->xBlockSize;
+
+		if( pxEntry->xBytesInUse > pxEntry->xPeakBytesInUse )
+		{
+			pxEntry->xPeakBytesInUse = pxEntry->xBytesInUse;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxBlock->pxLedgerEntry = pxEntry;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock )
+	{
+	HeapLedgerEntry_t *pxEntry = pxBlock->pxLedgerEntry;
+
+		/* Called with the scheduler suspended, after the allocated bit has
+		been cleared from the block size. */
+		configASSERT( pxEntry != NULL );
+		configASSERT( pxEntry->xBlocksInUse > 0 );
+
+		( pxEntry->xBlocksInUse )--;
+		pxEntry->xBytesInUse -= pxBlock->xBlockSize;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortGetHeapLedger( HeapLedgerEntry_t *pxLedger, UBaseType_t uxLedgerLength )
+	{
+	UBaseType_t uxEntry, uxEntries = 0;
+	const HeapLedgerEntry_t *pxOverflowEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+
+		configASSERT( pxLedger );
+
+		vTaskSuspendAll();
+		{
+			for( uxEntry = 0; ( uxEntry < uxHeapLedgerEntriesUsed ) && ( uxEntries < uxLedgerLength ); uxEntry++ )
+			{
+				pxLedger[ uxEntries ] = xHeapLedger[ uxEntry ];
+				uxEntries++;
+			}
+
+			/* Only report the entry shared by the call sites that did not fit
+			if it has been used. */
+			if( ( pxOverflowEntry->xNumberOfAllocations > 0 ) && ( uxEntries < uxLedgerLength ) )
+			{
+				pxLedger[ uxEntries ] = *pxOverflowEntry;
+				uxEntries++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxEntries;
+	}
+
+#endif /* configUSE_HEAP_CALLER_LEDGER */
+/*-----------------------------------------------------------*/
+
 static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
 {
 BlockLink_t *pxIterator;
@@ -0,0 +1,1055 @@
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that allows the
+ * heap to be defined across multiple non-contiguous blocks, in the same way as
+ * heap_5.c, but that allocates and frees memory in constant time.
+ *
+ * heap_5.c keeps a single list of free blocks in address order.  Allocating
+ * walks the list for the first block that is big enough, and freeing walks it
+ * again to find where the block goes, so both take longer as the heap becomes
+ * more fragmented.  This file uses a two-level segregated fit (TLSF) allocator
+ * instead.  Free blocks are kept in many lists, each holding blocks in a narrow
+ * range of sizes.  The first level divides sizes into powers of two, and the
+ * second level divides each power of two into heapSL_INDEX_COUNT equal parts.
+ * A bitmap records which lists are not empty, so a list holding blocks that are
+ * certainly big enough is found with two bit scans rather than a search.  The
+ * blocks either side of a block being freed are found from the block's own
+ * header, so they can be combined with it without searching either.
+ *
+ * Because the lists are searched from the smallest size class that is certain
+ * to satisfy a request, a request can be rounded up by at most
+ * 1 / heapSL_INDEX_COUNT of its size before a block is chosen, and freed blocks
+ * are always combined with free neighbours, which bounds fragmentation.
+ *
+ * A single block cannot be larger than heapMAX_BLOCK_SIZE bytes.  Regions that
+ * are larger than that are divided into several blocks.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ *
+ * Usage notes:
+ *
+ * vPortDefineHeapRegions() ***must*** be called before pvPortMalloc(), and
+ * takes the same array of HeapRegion_t structures as the heap_5.c version.  The
+ * regions ***must*** appear in address order from low address to high address.
+ * See heap_5.c for an example.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	#ifndef portGET_RETURN_ADDRESS
+		#error portGET_RETURN_ADDRESS() must be defined by the port to use the heap caller ledger
+	#endif
+
+	#if( configHEAP_CALLER_LEDGER_LENGTH < 2 )
+		#error configHEAP_CALLER_LEDGER_LENGTH must be at least 2, as the last entry records the callers that do not fit in the ledger
+	#endif
+#endif
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+	#error configUSE_HEAP_TASK_CACHE is only supported by heap_5.c
+#endif
+
+/* Allocations that would take the calling task over its heap quota fail. */
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	#define heapWITHIN_QUOTA( uxHeapAccount )	( ( uxHeapAccount ) != taskHEAP_QUOTA_EXCEEDED )
+#else
+	#define heapWITHIN_QUOTA( uxHeapAccount )	pdTRUE
+#endif
+
+/* The base two logarithm of portBYTE_ALIGNMENT.  Block sizes are always a
+multiple of portBYTE_ALIGNMENT. */
+#if portBYTE_ALIGNMENT == 32
+	#define heapALIGNMENT_LOG2		5
+#elif portBYTE_ALIGNMENT == 16
+	#define heapALIGNMENT_LOG2		4
+#elif portBYTE_ALIGNMENT == 8
+	#define heapALIGNMENT_LOG2		3
+#elif portBYTE_ALIGNMENT == 4
+	#define heapALIGNMENT_LOG2		2
+#elif portBYTE_ALIGNMENT == 2
+	#define heapALIGNMENT_LOG2		1
+#else
+	#define heapALIGNMENT_LOG2		0
+#endif
+
+/* Each power of two range of block sizes is divided into heapSL_INDEX_COUNT
+second level size classes. */
+#define heapSL_INDEX_COUNT_LOG2		4
+#define heapSL_INDEX_COUNT			( 1 << heapSL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all go in the first first level
+list, which is divided into size classes portBYTE_ALIGNMENT bytes apart.
+Larger blocks go in the first level list for their most significant bit. */
+#define heapFL_INDEX_SHIFT			( heapSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapSMALL_BLOCK_SIZE		( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+/* Blocks must be smaller than heapMAX_BLOCK_SIZE, which sets the number of first
+level lists.  The first level bitmap is 32 bits, so there can be no more than
+32 first level lists. */
+#define heapMAX_BLOCK_SIZE_LOG2		24
+#define heapMAX_BLOCK_SIZE			( ( size_t ) 1 << heapMAX_BLOCK_SIZE_LOG2 )
+#define heapFL_INDEX_COUNT			( heapMAX_BLOCK_SIZE_LOG2 - heapFL_INDEX_SHIFT + 1 )
+
+#if( heapFL_INDEX_COUNT > 32 )
+	#error heapMAX_BLOCK_SIZE_LOG2 is too large for the first level bitmap
+#endif
+
+/* Block sizes must not get too small - a free block must be able to hold the
+whole BlockLink_t structure. */
+#define heapMINIMUM_BLOCK_SIZE	( ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE		( ( size_t ) 8 )
+
+/* Define the structure placed at the start of every block.  The members before
+pxNextFreeBlock are present in every block.  The free list links are only used while
+the block is free - once the block is allocated they form the start of the
+memory returned to the application. */
+typedef struct A_BLOCK_LINK
+{
+	struct A_BLOCK_LINK *pxPreviousPhysicalBlock;	/*<< The block immediately below this one in memory, or NULL if this is the first block in its region. */
+	size_t xBlockSize;								/*<< The size of the block, including this structure. */
+
+	#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+		HeapLedgerEntry_t *pxLedgerEntry;			/*<< The ledger entry of the call site that allocated the block. */
+	#endif
+
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		UBaseType_t uxHeapAccount;					/*<< The task heap account the block is charged to. */
+	#endif
+
+	struct A_BLOCK_LINK *pxNextFreeBlock;			/*<< The next block in the same free list. */
+	struct A_BLOCK_LINK *pxPreviousFreeBlock;		/*<< The previous block in the same free list. */
+} BlockLink_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the position of the most or least significant set bit in ulValue,
+ * which must not be 0.  Both take the same time whatever the value, and use
+ * the port's bit scan instruction when it has one.
+ */
+static UBaseType_t prvFindLastSet( uint32_t ulValue );
+static UBaseType_t prvFindFirstSet( uint32_t ulValue );
+
+/*
+ * Calculates the first and second level indexes of the free list that holds
+ * blocks of xBlockSize bytes.
+ */
+static void prvMapBlockSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel );
+
+/*
+ * Returns the smallest free block from a list that only holds blocks of at
+ * least xWantedSize bytes, or NULL if there is no such block.  The block is
+ * removed from its free list.
+ */
+static BlockLink_t *prvTakeSuitableBlock( size_t xWantedSize );
+
+/*
+ * Add a free block to, or remove a free block from, the free list for its
+ * size.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert );
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove );
+
+/*
+ * Returns the vPortGetHeapStats() size class of a free block.
+ */
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize );
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	/*
+	 * Records a block that has just been allocated against the ledger entry of
+	 * the call site that allocated it, or against the last entry if the ledger
+	 * is full.  Finding the entry is a linear search, so the ledger is intended
+	 * for profiling rather than production builds.
+	 */
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller );
+
+	/*
+	 * Removes a block that is being freed from the ledger entry it was recorded
+	 * against.
+	 */
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The size of the part of the BlockLink_t structure that is placed at the
+beginning of each allocated memory block must by correctly byte aligned. */
+static const size_t xHeapStructSize	= ( offsetof( BlockLink_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The free lists, and the bitmaps that show which of them hold blocks.  Bit n of
+ulFirstLevelBitmap is set if any bit in ulSecondLevelBitmaps[ n ] is set, and bit
+m of ulSecondLevelBitmaps[ n ] is set if pxFreeBlocks[ n ][ m ] is not empty. */
+static BlockLink_t *pxFreeBlocks[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+static uint32_t ulFirstLevelBitmap = 0U;
+static uint32_t ulSecondLevelBitmaps[ heapFL_INDEX_COUNT ];
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+
+/* Allocation counters reported by vPortGetHeapStats(). */
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+static uint64_t ullBytesAllocated = 0U;
+static uint64_t ullBytesFreed = 0U;
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	/* One entry per call site, in the order the call sites first allocated.
+	The last entry is shared by the call sites that do not get an entry of
+	their own. */
+	static HeapLedgerEntry_t xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH ];
+	static UBaseType_t uxHeapLedgerEntriesUsed = 0U;
+#endif
+
+/* Gets set to the top bit of an size_t type.  When this bit in the xBlockSize
+member of an BlockLink_t structure is set then the block belongs to the
+application.  When the bit is free the block is still part of the free heap
+space.  The block that marks the end of each region is always allocated, so is
+never combined with the block below it. */
+static size_t xBlockAllocatedBit = 0;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockLink_t *pxBlock, *pxNewBlockLink, *pxNextPhysicalBlock;
+void *pvReturn = NULL;
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+	void * const pvCaller = portGET_RETURN_ADDRESS();
+#endif
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+	UBaseType_t uxHeapAccount = 0;
+#endif
+
+	/* The heap must be initialised before the first call to
+	prvPortMalloc(). */
+	configASSERT( xBlockAllocatedBit );
+
+	vTaskSuspendAll();
+	{
+		/* Check the requested block size is not so large that it can never be
+		satisfied.  This also ensures the top bit, which is used to mark blocks
+		as allocated, is clear. */
+		if( ( xWantedSize > 0 ) && ( xWantedSize < ( heapMAX_BLOCK_SIZE - heapMINIMUM_BLOCK_SIZE ) ) )
+		{
+			/* The wanted size is increased so it can contain the header of a
+			BlockLink_t structure in addition to the requested amount of bytes,
+			and then aligned. */
+			xWantedSize += xHeapStructSize;
+
+			if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+			{
+				/* Byte alignment required. */
+				xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The block must be big enough to hold the free list links once it
+			is freed again. */
+			if( xWantedSize < heapMINIMUM_BLOCK_SIZE )
+			{
+				xWantedSize = heapMINIMUM_BLOCK_SIZE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+			{
+				uxHeapAccount = uxTaskHeapCheckQuota( xWantedSize );
+			}
+			#endif
+
+			if( ( xWantedSize <= xFreeBytesRemaining ) && heapWITHIN_QUOTA( uxHeapAccount ) )
+			{
+				pxBlock = prvTakeSuitableBlock( xWantedSize );
+
+				#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+				{
+					/* A block too small to split is allocated, and so charged,
+					whole.  The quota was only checked against the wanted size,
+					so check it again against the size that will be charged, and
+					return the block to the free lists if it is not allowed. */
+					if( ( pxBlock != NULL ) && ( ( pxBlock->xBlockSize - xWantedSize ) < heapMINIMUM_BLOCK_SIZE ) )
+					{
+						uxHeapAccount = uxTaskHeapCheckQuota( pxBlock->xBlockSize );
+
+						if( uxHeapAccount == taskHEAP_QUOTA_EXCEEDED )
+						{
+							prvInsertBlockIntoFreeList( pxBlock );
+							pxBlock = NULL;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif
+
+				if( pxBlock != NULL )
+				{
+					/* If the block is larger than required it can be split into
+					two. */
+					if( ( pxBlock->xBlockSize - xWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+					{
+						/* This block is to be split into two.  Create a new
+						block following the number of bytes requested. The void
+						cast is used to prevent byte alignment warnings from the
+						compiler. */
+						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+
+						/* Calculate the sizes of two blocks split from the
+						single block, and link the new block in between the
+						block and the block that follows it. */
+						pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+						pxNewBlockLink->pxPreviousPhysicalBlock = pxBlock;
+						pxBlock->xBlockSize = xWantedSize;
+
+						/* The block that follows is normally allocated, as free
+						blocks are combined when they are freed.  It can only be
+						free if combining them would have made a block that was
+						too large, in which case try again now the block has
+						shrunk. */
+						pxNextPhysicalBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlockLink ) + pxNewBlockLink->xBlockSize );
+
+						if( ( ( pxNextPhysicalBlock->xBlockSize & xBlockAllocatedBit ) == 0 ) && ( ( pxNewBlockLink->xBlockSize + pxNextPhysicalBlock->xBlockSize ) < heapMAX_BLOCK_SIZE ) )
+						{
+							prvRemoveBlockFromFreeList( pxNextPhysicalBlock );
+							pxNewBlockLink->xBlockSize += pxNextPhysicalBlock->xBlockSize;
+							pxNextPhysicalBlock = ( void * ) ( ( ( uint8_t * ) pxNewBlockLink ) + pxNewBlockLink->xBlockSize );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						pxNextPhysicalBlock->pxPreviousPhysicalBlock = pxNewBlockLink;
+
+						/* Insert the new block into the free lists. */
+						prvInsertBlockIntoFreeList( pxNewBlockLink );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xNumberOfSuccessfulAllocations++;
+					ullBytesAllocated += ( uint64_t ) pxBlock->xBlockSize;
+
+					#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+					{
+						prvLedgerRecordAllocation( pxBlock, pvCaller );
+					}
+					#endif
+
+					#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+					{
+						pxBlock->uxHeapAccount = uxHeapAccount;
+						vTaskHeapCharge( uxHeapAccount, pxBlock->xBlockSize );
+					}
+					#endif
+
+					/* The block is being returned - it is allocated and owned
+					by the application.  Return the memory space pointed to -
+					jumping over the BlockLink_t header at its start. */
+					pxBlock->xBlockSize |= xBlockAllocatedBit;
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( ( configUSE_TASK_HEAP_ACCOUNTING == 1 ) && ( configUSE_HEAP_QUOTA_HOOK == 1 ) )
+	{
+		if( uxHeapAccount == taskHEAP_QUOTA_EXCEEDED )
+		{
+			extern void vApplicationHeapQuotaHook( size_t xWantedSize );
+			vApplicationHeapQuotaHook( xWantedSize );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+BlockLink_t *pxLink, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have an BlockLink_t header immediately
+		before it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxLink = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 );
+
+		if( ( pxLink->xBlockSize & xBlockAllocatedBit ) != 0 )
+		{
+			vTaskSuspendAll();
+			{
+				/* The block is being returned to the heap - it is no longer
+				allocated. */
+				pxLink->xBlockSize &= ~xBlockAllocatedBit;
+				xFreeBytesRemaining += pxLink->xBlockSize;
+				xNumberOfSuccessfulFrees++;
+				ullBytesFreed += ( uint64_t ) pxLink->xBlockSize;
+
+				#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+				{
+					prvLedgerRecordFree( pxLink );
+				}
+				#endif
+
+				#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+				{
+					vTaskHeapCredit( pxLink->uxHeapAccount, pxLink->xBlockSize );
+				}
+				#endif
+
+				traceFREE( pv, pxLink->xBlockSize );
+
+				/* If the block above this one is free, and the two together
+				are not too big to be a single block, then take the block above
+				out of its free list and add it to this one. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+
+				if( ( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 ) && ( ( pxLink->xBlockSize + pxNeighbour->xBlockSize ) < heapMAX_BLOCK_SIZE ) )
+				{
+					prvRemoveBlockFromFreeList( pxNeighbour );
+					pxLink->xBlockSize += pxNeighbour->xBlockSize;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Likewise, if the block below this one is free then add this
+				block to it. */
+				pxNeighbour = pxLink->pxPreviousPhysicalBlock;
+
+				if( pxNeighbour != NULL )
+				{
+					if( ( ( pxNeighbour->xBlockSize & xBlockAllocatedBit ) == 0 ) && ( ( pxLink->xBlockSize + pxNeighbour->xBlockSize ) < heapMAX_BLOCK_SIZE ) )
+					{
+						prvRemoveBlockFromFreeList( pxNeighbour );
+						pxNeighbour->xBlockSize += pxLink->xBlockSize;
+						pxLink = pxNeighbour;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The block that now follows the freed block must point back to
+				it. */
+				pxNeighbour = ( void * ) ( ( ( uint8_t * ) pxLink ) + pxLink->xBlockSize );
+				pxNeighbour->pxPreviousPhysicalBlock = pxLink;
+
+				prvInsertBlockIntoFreeList( pxLink );
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockLink_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0;
+UBaseType_t uxClass, uxFirstLevel, uxSecondLevel;
+
+	configASSERT( pxHeapStats );
+
+	for( uxClass = 0; uxClass < ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES; uxClass++ )
+	{
+		pxHeapStats->xFreeBlocksBySize[ uxClass ] = 0;
+	}
+
+	vTaskSuspendAll();
+	{
+		/* Only visit the lists the bitmaps show are not empty. */
+		for( uxFirstLevel = 0; uxFirstLevel < ( UBaseType_t ) heapFL_INDEX_COUNT; uxFirstLevel++ )
+		{
+			if( ( ulFirstLevelBitmap & ( 1UL << uxFirstLevel ) ) != 0UL )
+			{
+				for( uxSecondLevel = 0; uxSecondLevel < ( UBaseType_t ) heapSL_INDEX_COUNT; uxSecondLevel++ )
+				{
+					for( pxBlock = pxFreeBlocks[ uxFirstLevel ][ uxSecondLevel ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+					{
+						xBlocks++;
+
+						if( pxBlock->xBlockSize > xMaxSize )
+						{
+							xMaxSize = pxBlock->xBlockSize;
+						}
+
+						if( ( xMinSize == 0 ) || ( pxBlock->xBlockSize < xMinSize ) )
+						{
+							xMinSize = pxBlock->xBlockSize;
+						}
+
+						( pxHeapStats->xFreeBlocksBySize[ prvHeapSizeClass( pxBlock->xBlockSize ) ] )++;
+					}
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->ullBytesAllocated = ullBytesAllocated;
+		pxHeapStats->ullBytesFreed = ullBytesFreed;
+	}
+	( void ) xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHeapSizeClass( size_t xBlockSize )
+{
+UBaseType_t uxClass = 0;
+
+	/* Class 0 holds blocks below 32 bytes, and each class after that covers
+	twice the range of the one before. */
+	xBlockSize >>= 5;
+
+	while( ( xBlockSize != 0 ) && ( uxClass < ( ( UBaseType_t ) configHEAP_STATS_SIZE_CLASSES - 1U ) ) )
+	{
+		xBlockSize >>= 1;
+		uxClass++;
+	}
+
+	return uxClass;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_CALLER_LEDGER == 1 )
+
+	static void prvLedgerRecordAllocation( BlockLink_t *pxBlock, void *pvCaller )
+	{
+	HeapLedgerEntry_t *pxEntry = NULL;
+	UBaseType_t uxEntry;
+
+		/* Called with the scheduler suspended. */
+		for( uxEntry = 0; uxEntry < uxHeapLedgerEntriesUsed; uxEntry++ )
+		{
+			if( xHeapLedger[ uxEntry ].pvCaller == pvCaller )
+			{
+				pxEntry = &( xHeapLedger[ uxEntry ] );
+				break;
+			}
+		}
+
+		if( pxEntry == NULL )
+		{
+			if( uxHeapLedgerEntriesUsed < ( ( UBaseType_t ) configHEAP_CALLER_LEDGER_LENGTH - 1U ) )
+			{
+				pxEntry = &( xHeapLedger[ uxHeapLedgerEntriesUsed ] );
+				pxEntry->pvCaller = pvCaller;
+				uxHeapLedgerEntriesUsed++;
+			}
+			else
+			{
+				/* The ledger is full.  The last entry keeps a NULL caller. */
+				pxEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxEntry->xNumberOfAllocations )++;
+		( pxEntry->xBlocksInUse )++;
+		pxEntry->xBytesInUse += pxBlock->xBlockSize;
+
+		if( pxEntry->xBytesInUse > pxEntry->xPeakBytesInUse )
+		{
+			pxEntry->xPeakBytesInUse = pxEntry->xBytesInUse;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxBlock->pxLedgerEntry = pxEntry;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvLedgerRecordFree( const BlockLink_t *pxBlock )
+	{
+	HeapLedgerEntry_t *pxEntry = pxBlock->pxLedgerEntry;
+
+		/* Called with the scheduler suspended, after the allocated bit has
+		been cleared from the block size. */
+		configASSERT( pxEntry != NULL );
+		configASSERT( pxEntry->xBlocksInUse > 0 );
+
+		( pxEntry->xBlocksInUse )--;
+		pxEntry->xBytesInUse -= pxBlock->xBlockSize;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortGetHeapLedger( HeapLedgerEntry_t *pxLedger, UBaseType_t uxLedgerLength )
+	{
+	UBaseType_t uxEntry, uxEntries = 0;
+	const HeapLedgerEntry_t *pxOverflowEntry = &( xHeapLedger[ configHEAP_CALLER_LEDGER_LENGTH - 1 ] );
+
+		configASSERT( pxLedger );
+
+		vTaskSuspendAll();
+		{
+			for( uxEntry = 0; ( uxEntry < uxHeapLedgerEntriesUsed ) && ( uxEntries < uxLedgerLength ); uxEntry++ )
+			{
+				pxLedger[ uxEntries ] = xHeapLedger[ uxEntry ];
+				uxEntries++;
+			}
+
+			/* Only report the entry shared by the call sites that did not fit
+			if it has been used. */
+			if( ( pxOverflowEntry->xNumberOfAllocations > 0 ) && ( uxEntries < uxLedgerLength ) )
+			{
+				pxLedger[ uxEntries ] = *pxOverflowEntry;
+				uxEntries++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxEntries;
+	}
+
+#endif /* configUSE_HEAP_CALLER_LEDGER */
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+UBaseType_t uxBit = 0;
+
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+	{
+		/* The port provides a fast way of finding the most significant set bit
+		for selecting the highest priority ready task, which works just as well
+		here. */
+		UBaseType_t uxValue = ( UBaseType_t ) ulValue;
+
+		portGET_HIGHEST_PRIORITY( uxBit, uxValue );
+	}
+	#else
+	{
+		/* A binary search for the most significant set bit, so the time taken
+		does not depend on the value. */
+		if( ( ulValue & 0xffff0000UL ) != 0 )
+		{
+			ulValue >>= 16;
+			uxBit += 16;
+		}
+
+		if( ( ulValue & 0x0000ff00UL ) != 0 )
+		{
+			ulValue >>= 8;
+			uxBit += 8;
+		}
+
+		if( ( ulValue & 0x000000f0UL ) != 0 )
+		{
+			ulValue >>= 4;
+			uxBit += 4;
+		}
+
+		if( ( ulValue & 0x0000000cUL ) != 0 )
+		{
+			ulValue >>= 2;
+			uxBit += 2;
+		}
+
+		if( ( ulValue & 0x00000002UL ) != 0 )
+		{
+			uxBit += 1;
+		}
+	}
+	#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindFirstSet( uint32_t ulValue )
+{
+	/* Isolate the least significant set bit, which is then the only bit set. */
+	return prvFindLastSet( ulValue & ( ~ulValue + 1UL ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapBlockSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel )
+{
+UBaseType_t uxMostSignificantBit;
+
+	if( xBlockSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks all go in the first first level list, with one second
+		level list for each multiple of portBYTE_ALIGNMENT. */
+		*puxFirstLevel = 0;
+		*puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> heapALIGNMENT_LOG2 );
+	}
+	else
+	{
+		/* The most significant bit selects the first level list, and the
+		heapSL_INDEX_COUNT_LOG2 bits below it select the second level list. */
+		uxMostSignificantBit = prvFindLastSet( ( uint32_t ) xBlockSize );
+		*puxFirstLevel = uxMostSignificantBit - ( heapFL_INDEX_SHIFT - 1 );
+		*puxSecondLevel = ( UBaseType_t ) ( xBlockSize >> ( uxMostSignificantBit - heapSL_INDEX_COUNT_LOG2 ) ) & ( heapSL_INDEX_COUNT - 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t *prvTakeSuitableBlock( size_t xWantedSize )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+uint32_t ulBitmap;
+BlockLink_t *pxBlock = NULL;
+
+	/* Round the wanted size up to the start of the next size class, so every
+	block in the list it maps to is big enough.  Blocks in the size class of
+	the unrounded size might be smaller than wanted. */
+	if( xWantedSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xWantedSize += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xWantedSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMapBlockSize( xWantedSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( uxFirstLevel < heapFL_INDEX_COUNT )
+	{
+		/* Look for a list in the same first level list at or above the second
+		level index. */
+		ulBitmap = ulSecondLevelBitmaps[ uxFirstLevel ] & ( ~0UL << uxSecondLevel );
+
+		if( ulBitmap == 0 )
+		{
+			/* There is none, so look for the smallest non-empty list in a
+			higher first level list. */
+			if( ( uxFirstLevel + 1 ) < heapFL_INDEX_COUNT )
+			{
+				ulBitmap = ulFirstLevelBitmap & ( ~0UL << ( uxFirstLevel + 1 ) );
+			}
+			else
+			{
+				ulBitmap = 0;
+			}
+
+			if( ulBitmap != 0 )
+			{
+				uxFirstLevel = prvFindFirstSet( ulBitmap );
+				ulBitmap = ulSecondLevelBitmaps[ uxFirstLevel ];
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ulBitmap != 0 )
+		{
+			uxSecondLevel = prvFindFirstSet( ulBitmap );
+			pxBlock = pxFreeBlocks[ uxFirstLevel ][ uxSecondLevel ];
+			prvRemoveBlockFromFreeList( pxBlock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( BlockLink_t *pxBlockToInsert )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+BlockLink_t *pxHead;
+
+	prvMapBlockSize( pxBlockToInsert->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+	/* Add the block to the front of its list. */
+	pxHead = pxFreeBlocks[ uxFirstLevel ][ uxSecondLevel ];
+	pxBlockToInsert->pxNextFreeBlock = pxHead;
+	pxBlockToInsert->pxPreviousFreeBlock = NULL;
+
+	if( pxHead != NULL )
+	{
+		pxHead->pxPreviousFreeBlock = pxBlockToInsert;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeBlocks[ uxFirstLevel ][ uxSecondLevel ] = pxBlockToInsert;
+	ulFirstLevelBitmap |= 1UL << uxFirstLevel;
+	ulSecondLevelBitmaps[ uxFirstLevel ] |= 1UL << uxSecondLevel;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBlockFromFreeList( BlockLink_t *pxBlockToRemove )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+
+	prvMapBlockSize( pxBlockToRemove->xBlockSize, &uxFirstLevel, &uxSecondLevel );
+
+	if( pxBlockToRemove->pxNextFreeBlock != NULL )
+	{
+		pxBlockToRemove->pxNextFreeBlock->pxPreviousFreeBlock = pxBlockToRemove->pxPreviousFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlockToRemove->pxPreviousFreeBlock != NULL )
+	{
+		pxBlockToRemove->pxPreviousFreeBlock->pxNextFreeBlock = pxBlockToRemove->pxNextFreeBlock;
+	}
+	else
+	{
+		/* The block was at the front of its list.  If the list is now empty
+		then clear its bit, and the first level bit too if that was the last
+		non-empty list in the first level list. */
+		pxFreeBlocks[ uxFirstLevel ][ uxSecondLevel ] = pxBlockToRemove->pxNextFreeBlock;
+
+		if( pxBlockToRemove->pxNextFreeBlock == NULL )
+		{
+			ulSecondLevelBitmaps[ uxFirstLevel ] &= ~( 1UL << uxSecondLevel );
+
+			if( ulSecondLevelBitmaps[ uxFirstLevel ] == 0 )
+			{
+				ulFirstLevelBitmap &= ~( 1UL << uxFirstLevel );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+BlockLink_t *pxBlock, *pxPreviousBlock, *pxEnd = NULL;
+size_t xTotalRegionSize, xTotalHeapSize = 0, xBlockSize;
+BaseType_t xDefinedRegions = 0;
+size_t xAddress, xEndAddress;
+const HeapRegion_t *pxHeapRegion;
+
+	/* Can only call once! */
+	configASSERT( xBlockAllocatedBit == 0 );
+
+	/* Work out the position of the top bit in a size_t variable. */
+	xBlockAllocatedBit = ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 );
+
+	pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+
+	while( pxHeapRegion->xSizeInBytes > 0 )
+	{
+		xTotalRegionSize = pxHeapRegion->xSizeInBytes;
+
+		/* Ensure the heap region starts on a correctly aligned boundary. */
+		xAddress = ( size_t ) pxHeapRegion->pucStartAddress;
+		if( ( xAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+		{
+			xAddress += ( portBYTE_ALIGNMENT - 1 );
+			xAddress &= ~portBYTE_ALIGNMENT_MASK;
+
+			/* Adjust the size for the bytes lost to alignment. */
+			xTotalRegionSize -= xAddress - ( size_t ) pxHeapRegion->pucStartAddress;
+		}
+
+		/* Check blocks are passed in with increasing start addresses. */
+		configASSERT( ( pxEnd == NULL ) || ( xAddress > ( size_t ) pxEnd ) );
+
+		/* The end of each region is marked by a block header that is always
+		allocated, so the block below it is never combined with anything beyond
+		the end of the region. */
+		xEndAddress = xAddress + xTotalRegionSize;
+		xEndAddress -= xHeapStructSize;
+		xEndAddress &= ~portBYTE_ALIGNMENT_MASK;
+
+		/* Divide the region into free blocks that are no larger than a single
+		block can be.  Blocks are normally combined when they are freed, so the
+		blocks are never combined to make one that is too large either. */
+		pxPreviousBlock = NULL;
+
+		while( ( xEndAddress - xAddress ) >= heapMINIMUM_BLOCK_SIZE )
+		{
+			xBlockSize = xEndAddress - xAddress;
+
+			if( xBlockSize >= heapMAX_BLOCK_SIZE )
+			{
+				xBlockSize = ( heapMAX_BLOCK_SIZE >> 1 );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxBlock = ( BlockLink_t * ) xAddress;
+			pxBlock->xBlockSize = xBlockSize;
+			pxBlock->pxPreviousPhysicalBlock = pxPreviousBlock;
+			prvInsertBlockIntoFreeList( pxBlock );
+
+			xTotalHeapSize += xBlockSize;
+			xAddress += xBlockSize;
+			pxPreviousBlock = pxBlock;
+		}
+
+		/* Any bytes too few to form a block are left as part of the end
+		marker. */
+		pxEnd = ( BlockLink_t * ) xAddress;
+		pxEnd->xBlockSize = xBlockAllocatedBit;
+		pxEnd->pxPreviousPhysicalBlock = pxPreviousBlock;
+
+		/* Move onto the next HeapRegion_t structure. */
+		xDefinedRegions++;
+		pxHeapRegion = &( pxHeapRegions[ xDefinedRegions ] );
+	}
+
+	xMinimumEverFreeBytesRemaining = xTotalHeapSize;
+	xFreeBytesRemaining = xTotalHeapSize;
+
+	/* Check something was actually defined before it is accessed. */
+	configASSERT( xTotalHeapSize );
+}
+
@@ -36,6 +36,7 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "object_pools.h"
 
 #if ( configUSE_CO_ROUTINES == 1 )
 	#include "croutine.h"
@@ -47,6 +48,11 @@ for the header files above, but not in this file, in order to generate the
 correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
 
+/* Set configUSE_STATS_FORMATTING_FUNCTIONS to 2 to include vQueueListStats()
+but without including stdio.h here. */
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS == 1 ) )
+	#include <stdio.h>
+#endif
 
 /* Constants used with the cRxLock and cTxLock structure members. */
 #define queueUNLOCKED					( ( int8_t ) -1 )
@@ -64,6 +70,14 @@ being used for. */
 #define uxQueueType						pcHead
 #define queueQUEUE_IS_MUTEX				NULL
 
+/* A queue set never has one of its own members pointing at it through the
+pxNextReadyInSet member, as a queue set cannot itself be added to a queue set.
+When the Queue_t structure is used to represent a queue set the member is
+therefore instead used to point to the tail of the set's circular list of ready
+members.  Map an alternative name to the member to ensure the readability of the
+code is maintained. */
+#define pxReadyMembersTail				pxNextReadyInSet
+
 typedef struct QueuePointers
 {
 	int8_t *pcTail;					/*< Points to the byte at the end of the queue storage area.  Once more byte is allocated than necessary to store the queue items, this is used as a marker. */
@@ -81,6 +95,86 @@ zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME		 ( ( TickType_t ) 0U )
 
+#if( configUSE_QUEUE_SIZED_COPY == 1 )
+	/* Value held in ucCopySize when the item size has no dedicated copy path
+	and items are copied with a variable length memcpy(). */
+	#define queueCOPY_SIZE_GENERIC	( ( uint8_t ) 0U )
+
+	/* Copies an item of pxQueue from pvSource to pvDestination using the path
+	selected for the queue's item size when the queue was created. */
+	#define queueCOPY_ITEM( pxQueue, pvDestination, pvSource ) prvCopyItem( ( pxQueue ), ( pvDestination ), ( pvSource ) )
+#else
+	#define queueCOPY_ITEM( pxQueue, pvDestination, pvSource ) ( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), ( size_t ) ( pxQueue )->uxItemSize ) /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0. */
+#endif
+
+#if( configUSE_QUEUE_STATS == 1 )
+	/* Called with the scheduler suspended just before the calling task is
+	placed on one of the queue's event lists.  Counts the block, and notes the
+	time so the time spent blocked can be added up once the task runs again.
+	xBlockedAt is a local variable of the calling function. */
+	#define queueSTATS_BLOCKING( pxQueue, ulCounter )	\
+	{													\
+		( ( pxQueue )->ulCounter )++;					\
+		xBlockedAt = xTaskGetTickCount();				\
+	}
+
+	/* Called from a critical section after an item has been added to the
+	queue. */
+	#define queueSTATS_UPDATE_PEAK( pxQueue )										\
+	{																				\
+		if( ( pxQueue )->uxMessagesWaiting > ( pxQueue )->uxPeakMessagesWaiting )	\
+		{																			\
+			( pxQueue )->uxPeakMessagesWaiting = ( pxQueue )->uxMessagesWaiting;	\
+		}																			\
+	}
+
+	/* Called when a task that blocked on the queue is running again. */
+	#define queueSTATS_UNBLOCKED( pxQueue )									\
+	{																		\
+		taskENTER_CRITICAL();												\
+		{																	\
+			( pxQueue )->xBlockedTicks += xTaskGetTickCount() - xBlockedAt;	\
+		}																	\
+		taskEXIT_CRITICAL();												\
+	}
+
+	/* Called when a send or receive fails because its block time expired. */
+	#define queueSTATS_TIMED_OUT( pxQueue, ulCounter )	\
+	{													\
+		taskENTER_CRITICAL();							\
+		{												\
+			( ( pxQueue )->ulCounter )++;				\
+		}												\
+		taskEXIT_CRITICAL();							\
+	}
+#else
+	#define queueSTATS_BLOCKING( pxQueue, ulCounter )
+	#define queueSTATS_UPDATE_PEAK( pxQueue )
+	#define queueSTATS_UNBLOCKED( pxQueue )
+	#define queueSTATS_TIMED_OUT( pxQueue, ulCounter )
+#endif /* configUSE_QUEUE_STATS */
+
+#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+	/* The time base used to measure how long items stay in a timestamped
+	queue.  The run time stats counter gives a finer resolution than the tick
+	count, but is only configured when run time stats are being gathered.  Items
+	can be sent from interrupts, so the interrupt safe tick count is used. */
+	#ifndef queueGET_TIMESTAMP
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+			#define queueGET_TIMESTAMP() ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+		#else
+			#define queueGET_TIMESTAMP() ( ( uint32_t ) xTaskGetTickCountFromISR() )
+		#endif
+	#endif
+
+	/* The offset of the residence statistics from the start of the memory
+	xQueueCreateTimestamped() allocates.  sizeof( Queue_t ) is only a multiple
+	of the alignment of the structure's own members, which can be less than
+	that of the 64-bit total in the statistics, so the offset is rounded up to
+	the alignment pvPortMalloc() guarantees. */
+	#define queueRESIDENCE_STATS_OFFSET	( ( sizeof( Queue_t ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+#endif
+
 #if( configUSE_PREEMPTION == 0 )
 	/* If the cooperative scheduler is being used then a yield should not be
 	performed just because a higher priority task has been woken. */
@@ -115,12 +209,19 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
 	volatile int8_t cRxLock;		/*< Stores the number of items received from the queue (removed from the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 	volatile int8_t cTxLock;		/*< Stores the number of items transmitted to the queue (added to the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
 
+	#if ( configUSE_QUEUE_SIZED_COPY == 1 )
+		uint8_t ucCopySize;			/*< The item size if it is one of the sizes that has a dedicated copy path, otherwise queueCOPY_SIZE_GENERIC. */
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t ucStaticallyAllocated;	/*< Set to pdTRUE if the memory used by the queue was statically allocated to ensure no attempt is made to free the memory. */
 	#endif
 
 	#if ( configUSE_QUEUE_SETS == 1 )
-		struct QueueDefinition *pxQueueSetContainer;
+		struct QueueDefinition *pxQueueSetContainer;	/*< The queue set this queue or semaphore is a member of, if any. */
+		struct QueueDefinition *pxNextReadyInSet;		/*< Links this member into the circular ready list of its queue set while uxSetEventsPending is non-zero.  Holds the tail of the ready list when the structure is used as a queue set. */
+		UBaseType_t uxSetEventsPending;					/*< The number of events this member has posted to its queue set that have not yet been returned by xQueueSelectFromSet(). */
+		uint8_t ucIsQueueSet;							/*< Set to pdTRUE if the structure is used as a queue set rather than as a queue or semaphore. */
 	#endif
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -128,6 +229,20 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+		uint32_t *pulEnqueueTimes;					/*< The time at which the item in each slot of the storage area was sent, or NULL if the queue does not record timestamps. */
+		QueueResidenceStats_t *pxResidenceStats;	/*< Statistics on how long items spent in the queue, or NULL if the queue does not record timestamps. */
+	#endif
+
+	#if ( configUSE_QUEUE_STATS == 1 )
+		UBaseType_t uxPeakMessagesWaiting;	/*< The largest number of items the queue has held. */
+		uint32_t ulSendsBlocked;			/*< The number of times a task blocked because the queue was full. */
+		uint32_t ulSendsTimedOut;			/*< The number of sends that failed after their block time expired. */
+		uint32_t ulReceivesBlocked;			/*< The number of times a task blocked because the queue was empty. */
+		uint32_t ulReceivesTimedOut;		/*< The number of receives that failed after their block time expired. */
+		TickType_t xBlockedTicks;			/*< The total number of ticks tasks spent blocked on the queue. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -204,6 +319,52 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	 * the queue set that the queue contains data.
 	 */
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Records that pxMember has one more event pending in the queue set
+	 * pxQueueSet, linking pxMember into the set's ready list if it was not
+	 * already there.  O(1), no data is copied.
+	 */
+	static void prvAddReadyMemberToSet( Queue_t * const pxQueueSet, Queue_t * const pxMember, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Removes one event from the queue set pxQueueSet and returns the member
+	 * the event belongs to.  Members that still have events pending are moved
+	 * to the back of the ready list so ready members are serviced round robin.
+	 * O(1).
+	 */
+	static Queue_t *prvTakeReadyMemberFromSet( Queue_t * const pxQueueSet ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Unlinks pxMember from the ready list of the queue set pxQueueSet,
+	 * discarding any events it still has pending in the set.
+	 */
+	static void prvRemoveReadyMemberFromSet( Queue_t * const pxQueueSet, Queue_t * const pxMember ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_SIZED_COPY == 1 )
+	/*
+	 * Copies one item of pxQueue.  Items of 1, 2, 4, 8 or 16 bytes are copied
+	 * with a fixed length copy that the compiler can reduce to one or two
+	 * register moves, so word sized items never go through a library call.
+	 * Other sizes fall back to a variable length memcpy().
+	 */
+	static void prvCopyItem( const Queue_t * const pxQueue, void * const pvDestination, const void * const pvSource ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+	/*
+	 * Records the current time against the storage slot pcSlot of a
+	 * timestamped queue.  Does nothing if the queue does not record timestamps.
+	 */
+	static void prvRecordEnqueueTime( Queue_t * const pxQueue, const int8_t * const pcSlot ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called after an item has been removed from a queue to update the
+	 * queue's residence statistics.  Returns the age of the item, or 0 if the
+	 * queue does not record timestamps.
+	 */
+	static uint32_t prvRecordResidence( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
 /*
@@ -269,6 +430,28 @@ Queue_t * const pxQueue = xQueue;
 
 		if( xNewQueue == pdFALSE )
 		{
+			#if ( configUSE_QUEUE_SETS == 1 )
+			{
+				/* Resetting a queue set discards every pending event, so all
+				the members must be unlinked from its ready list. */
+				if( pxQueue->ucIsQueueSet != pdFALSE )
+				{
+					while( pxQueue->pxReadyMembersTail != NULL )
+					{
+						prvRemoveReadyMemberFromSet( pxQueue, pxQueue->pxReadyMembersTail->pxNextReadyInSet );
+					}
+
+					/* Unlinking the members adjusted the event count, which
+					had already been cleared above. */
+					pxQueue->uxMessagesWaiting = ( UBaseType_t ) 0U;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_QUEUE_SETS */
+
 			/* If there are tasks blocked waiting to read from the queue, then
 			the tasks will remain blocked as after this function exits the queue
 			will still be empty.  If there are tasks blocked waiting to write to
@@ -394,7 +577,7 @@ Queue_t * const pxQueue = xQueue;
 		are greater than or equal to the pointer to char requirements the cast
 		is safe.  In other cases alignment requirements are not strict (one or
 		two bytes). */
-		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
+		pxNewQueue = ( Queue_t * ) poolMALLOC( eQueuePool, sizeof( Queue_t ) + xQueueSizeInBytes ); /*lint !e9087 !e9079 see comment above. */
 
 		if( pxNewQueue != NULL )
 		{
@@ -426,6 +609,86 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateTimestamped( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+	{
+	Queue_t *pxNewQueue;
+	size_t xStatsSizeInBytes;
+	uint8_t *pucQueueStorage;
+
+		configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+
+		/* Only queues that hold data have slots to timestamp. */
+		configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+		/* The Queue_t structure, the residence statistics, one timestamp per
+		item and the queue storage area are allocated in a single call to
+		pvPortMalloc(), in that order.  The statistics start at
+		queueRESIDENCE_STATS_OFFSET so they are aligned, and the size of the
+		statistics keeps the timestamps after them aligned. */
+		xStatsSizeInBytes = sizeof( QueueResidenceStats_t ) + ( ( size_t ) uxQueueLength * sizeof( uint32_t ) );
+		pxNewQueue = ( Queue_t * ) pvPortMalloc( queueRESIDENCE_STATS_OFFSET + xStatsSizeInBytes + ( size_t ) ( uxQueueLength * uxItemSize ) ); /*lint !e9087 !e9079 see comment in xQueueGenericCreate(). */
+
+		if( pxNewQueue != NULL )
+		{
+			pucQueueStorage = ( uint8_t * ) pxNewQueue;
+			pucQueueStorage += queueRESIDENCE_STATS_OFFSET + xStatsSizeInBytes; /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				pxNewQueue->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			prvInitialiseNewQueue( uxQueueLength, uxItemSize, pucQueueStorage, queueQUEUE_TYPE_BASE, pxNewQueue );
+
+			pxNewQueue->pxResidenceStats = ( QueueResidenceStats_t * ) ( ( ( uint8_t * ) pxNewQueue ) + queueRESIDENCE_STATS_OFFSET ); /*lint !e9087 !e9016 Safe as the offset keeps the statistics aligned. */
+			pxNewQueue->pulEnqueueTimes = ( uint32_t * ) &( pxNewQueue->pxResidenceStats[ 1 ] ); /*lint !e9087 Safe as the structure size keeps the array aligned. */
+			vQueueResetResidenceStats( pxNewQueue );
+		}
+		else
+		{
+			traceQUEUE_CREATE_FAILED( queueQUEUE_TYPE_BASE );
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxNewQueue;
+	}
+
+#endif /* ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateTimestampedStatic( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, uint32_t *pulEnqueueTimes, QueueResidenceStats_t *pxResidenceStats, StaticQueue_t *pxStaticQueue )
+	{
+	Queue_t *pxNewQueue;
+
+		/* Only queues that hold data have slots to timestamp. */
+		configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+		configASSERT( pulEnqueueTimes != NULL );
+		configASSERT( pxResidenceStats != NULL );
+
+		pxNewQueue = ( Queue_t * ) xQueueGenericCreateStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxStaticQueue, queueQUEUE_TYPE_BASE ); /*lint !e9087 !e9079 The handle is a Queue_t. */
+
+		if( pxNewQueue != NULL )
+		{
+			pxNewQueue->pxResidenceStats = pxResidenceStats;
+			pxNewQueue->pulEnqueueTimes = pulEnqueueTimes;
+			vQueueResetResidenceStats( pxNewQueue );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxNewQueue;
+	}
+
+#endif /* ( configUSE_QUEUE_TIMESTAMPS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, const uint8_t ucQueueType, Queue_t *pxNewQueue )
 {
 	/* Remove compiler warnings about unused parameters should
@@ -450,6 +713,27 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	defined. */
 	pxNewQueue->uxLength = uxQueueLength;
 	pxNewQueue->uxItemSize = uxItemSize;
+
+	#if ( configUSE_QUEUE_SIZED_COPY == 1 )
+	{
+		/* Select the copy path once here rather than on every send and
+		receive. */
+		switch( uxItemSize )
+		{
+			case 1U :
+			case 2U :
+			case 4U :
+			case 8U :
+			case 16U :
+				pxNewQueue->ucCopySize = ( uint8_t ) uxItemSize;
+				break;
+
+			default :
+				pxNewQueue->ucCopySize = queueCOPY_SIZE_GENERIC;
+				break;
+		}
+	}
+	#endif /* configUSE_QUEUE_SIZED_COPY */
 	( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
 
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -461,9 +745,30 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	#if( configUSE_QUEUE_SETS == 1 )
 	{
 		pxNewQueue->pxQueueSetContainer = NULL;
+		pxNewQueue->pxNextReadyInSet = NULL;
+		pxNewQueue->uxSetEventsPending = ( UBaseType_t ) 0U;
+		pxNewQueue->ucIsQueueSet = pdFALSE;
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+	{
+		pxNewQueue->pulEnqueueTimes = NULL;
+		pxNewQueue->pxResidenceStats = NULL;
+	}
+	#endif /* configUSE_QUEUE_TIMESTAMPS */
+
+	#if( configUSE_QUEUE_STATS == 1 )
+	{
+		pxNewQueue->uxPeakMessagesWaiting = ( UBaseType_t ) 0U;
+		pxNewQueue->ulSendsBlocked = 0UL;
+		pxNewQueue->ulSendsTimedOut = 0UL;
+		pxNewQueue->ulReceivesBlocked = 0UL;
+		pxNewQueue->ulReceivesTimedOut = 0UL;
+		pxNewQueue->xBlockedTicks = ( TickType_t ) 0U;
+	}
+	#endif /* configUSE_QUEUE_STATS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -750,6 +1055,10 @@ BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATS == 1 )
+	TickType_t xBlockedAt = 0;
+#endif
+
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 	configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
@@ -915,6 +1224,7 @@ Queue_t * const pxQueue = xQueue;
 			if( prvIsQueueFull( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+				queueSTATS_BLOCKING( pxQueue, ulSendsBlocked );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
 
 				/* Unlocking the queue means queue events can effect the
@@ -933,6 +1243,8 @@ Queue_t * const pxQueue = xQueue;
 				{
 					portYIELD_WITHIN_API();
 				}
+
+				queueSTATS_UNBLOCKED( pxQueue );
 			}
 			else
 			{
@@ -944,6 +1256,7 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			/* The timeout has expired. */
+			queueSTATS_TIMED_OUT( pxQueue, ulSendsTimedOut );
 			prvUnlockQueue( pxQueue );
 			( void ) xTaskResumeAll();
 
@@ -1164,6 +1477,7 @@ Queue_t * const pxQueue = xQueue;
 			priority disinheritance is needed.  Simply increase the count of
 			messages (semaphores) available. */
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+			queueSTATS_UPDATE_PEAK( pxQueue );
 
 			/* The event list is not altered if the queue is locked.  This will
 			be done when the queue is unlocked later. */
@@ -1270,12 +1584,33 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+
+	BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+	{
+		return xQueueReceiveWithAge( xQueue, pvBuffer, NULL, xTicksToWait );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* When timestamps are in use the body below implements
+	xQueueReceiveWithAge(), otherwise it implements xQueueReceive() directly so
+	queues that do not use timestamps pay nothing for them. */
+	BaseType_t xQueueReceiveWithAge( QueueHandle_t xQueue, void * const pvBuffer, uint32_t * const pulAge, TickType_t xTicksToWait )
+
+#else
+
+	BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+
+#endif /* configUSE_QUEUE_TIMESTAMPS */
 {
 BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATS == 1 )
+	TickType_t xBlockedAt = 0;
+#endif
+
 	/* Check the pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
 
@@ -1309,6 +1644,21 @@ Queue_t * const pxQueue = xQueue;
 				traceQUEUE_RECEIVE( pxQueue );
 				pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
+				#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+				{
+				const uint32_t ulAge = prvRecordResidence( pxQueue );
+
+					if( pulAge != NULL )
+					{
+						*pulAge = ulAge;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_QUEUE_TIMESTAMPS */
+
 				/* There is now space in the queue, were any tasks waiting to
 				post to the queue?  If so, unblock the highest priority waiting
 				task. */
@@ -1371,6 +1721,7 @@ Queue_t * const pxQueue = xQueue;
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				queueSTATS_BLOCKING( pxQueue, ulReceivesBlocked );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
@@ -1381,6 +1732,8 @@ Queue_t * const pxQueue = xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_UNBLOCKED( pxQueue );
 			}
 			else
 			{
@@ -1399,6 +1752,7 @@ Queue_t * const pxQueue = xQueue;
 
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
+				queueSTATS_TIMED_OUT( pxQueue, ulReceivesTimedOut );
 				traceQUEUE_RECEIVE_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1417,6 +1771,10 @@ BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATS == 1 )
+	TickType_t xBlockedAt = 0;
+#endif
+
 #if( configUSE_MUTEXES == 1 )
 	BaseType_t xInheritanceOccurred = pdFALSE;
 #endif
@@ -1544,6 +1902,7 @@ Queue_t * const pxQueue = xQueue;
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				queueSTATS_BLOCKING( pxQueue, ulReceivesBlocked );
 
 				#if ( configUSE_MUTEXES == 1 )
 				{
@@ -1572,6 +1931,8 @@ Queue_t * const pxQueue = xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_UNBLOCKED( pxQueue );
 			}
 			else
 			{
@@ -1617,6 +1978,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#endif /* configUSE_MUTEXES */
 
+				queueSTATS_TIMED_OUT( pxQueue, ulReceivesTimedOut );
 				traceQUEUE_RECEIVE_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1636,6 +1998,10 @@ TimeOut_t xTimeOut;
 int8_t *pcOriginalReadPosition;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATS == 1 )
+	TickType_t xBlockedAt = 0;
+#endif
+
 	/* Check the pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
 
@@ -1643,6 +2009,13 @@ Queue_t * const pxQueue = xQueue;
 	is zero (so no data is copied into the buffer. */
 	configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
 
+	/* Queue sets do not hold copies of their events, so cannot be peeked. */
+	#if ( configUSE_QUEUE_SETS == 1 )
+	{
+		configASSERT( pxQueue->ucIsQueueSet == pdFALSE );
+	}
+	#endif
+
 	/* Cannot block if the scheduler is suspended. */
 	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 	{
@@ -1738,6 +2111,7 @@ Queue_t * const pxQueue = xQueue;
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_PEEK( pxQueue );
+				queueSTATS_BLOCKING( pxQueue, ulReceivesBlocked );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
 				prvUnlockQueue( pxQueue );
 				if( xTaskResumeAll() == pdFALSE )
@@ -1748,6 +2122,8 @@ Queue_t * const pxQueue = xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				queueSTATS_UNBLOCKED( pxQueue );
 			}
 			else
 			{
@@ -1766,6 +2142,7 @@ Queue_t * const pxQueue = xQueue;
 
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
+				queueSTATS_TIMED_OUT( pxQueue, ulReceivesTimedOut );
 				traceQUEUE_PEEK_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1817,6 +2194,12 @@ Queue_t * const pxQueue = xQueue;
 			prvCopyDataFromQueue( pxQueue, pvBuffer );
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
 
+			#if( configUSE_QUEUE_TIMESTAMPS == 1 )
+			{
+				( void ) prvRecordResidence( pxQueue );
+			}
+			#endif /* configUSE_QUEUE_TIMESTAMPS */
+
 			/* If the queue is locked the event list will not be modified.
 			Instead update the lock count so the task that unlocks the queue
 			will know that an ISR has removed data while the queue was
@@ -1985,7 +2368,7 @@ Queue_t * const pxQueue = xQueue;
 	{
 		/* The queue can only have been allocated dynamically - free it
 		again. */
-		vPortFree( pxQueue );
+		poolFREE( eQueuePool, pxQueue );
 	}
 	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
 	{
@@ -1993,7 +2376,7 @@ Queue_t * const pxQueue = xQueue;
 		check before attempting to free the memory. */
 		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
 		{
-			vPortFree( pxQueue );
+			poolFREE( eQueuePool, pxQueue );
 		}
 		else
 		{
@@ -2076,6 +2459,18 @@ UBaseType_t uxMessagesWaiting;
 
 	uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
+	#if ( configUSE_QUEUE_SETS == 1 )
+	if( pxQueue->ucIsQueueSet != pdFALSE )
+	{
+		/* The item posted to a queue set is the handle of the member that
+		contains data.  Rather than copying the handle into a storage area the
+		member is flagged as ready and its count of pending events is
+		incremented.  Overwriting an item a member already holds does not post
+		to the set, so every call here is a new event. */
+		prvAddReadyMemberToSet( pxQueue, *( ( Queue_t * const * ) pvItemToQueue ), xPosition ); /*lint !e9079 The set is always posted the address of a member handle. */
+	}
+	else
+	#endif /* configUSE_QUEUE_SETS */
 	if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
 	{
 		#if ( configUSE_MUTEXES == 1 )
@@ -2095,7 +2490,13 @@ UBaseType_t uxMessagesWaiting;
 	}
 	else if( xPosition == queueSEND_TO_BACK )
 	{
-		( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+		{
+			prvRecordEnqueueTime( pxQueue, pxQueue->pcWriteTo );
+		}
+		#endif /* configUSE_QUEUE_TIMESTAMPS */
+
+		queueCOPY_ITEM( pxQueue, pxQueue->pcWriteTo, pvItemToQueue );
 		pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
 		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
 		{
@@ -2108,7 +2509,13 @@ UBaseType_t uxMessagesWaiting;
 	}
 	else
 	{
-		( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
+		#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+		{
+			prvRecordEnqueueTime( pxQueue, pxQueue->u.xQueue.pcReadFrom );
+		}
+		#endif /* configUSE_QUEUE_TIMESTAMPS */
+
+		queueCOPY_ITEM( pxQueue, pxQueue->u.xQueue.pcReadFrom, pvItemToQueue );
 		pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
 		if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
 		{
@@ -2142,12 +2549,23 @@ UBaseType_t uxMessagesWaiting;
 
 	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
 
+	queueSTATS_UPDATE_PEAK( pxQueue );
+
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
 static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer )
 {
+	#if ( configUSE_QUEUE_SETS == 1 )
+	if( pxQueue->ucIsQueueSet != pdFALSE )
+	{
+		/* Reading from a queue set returns the handle of the next ready
+		member. */
+		*( ( QueueSetMemberHandle_t * ) pvBuffer ) = prvTakeReadyMemberFromSet( pxQueue );
+	}
+	else
+	#endif /* configUSE_QUEUE_SETS */
 	if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
 	{
 		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
@@ -2159,11 +2577,49 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
-		( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+		queueCOPY_ITEM( pxQueue, pvBuffer, pxQueue->u.xQueue.pcReadFrom );
 	}
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_SIZED_COPY == 1 )
+
+	static void prvCopyItem( const Queue_t * const pxQueue, void * const pvDestination, const void * const pvSource )
+	{
+		/* The fixed length copies make no assumption about the alignment of
+		either buffer.  Compilers replace a memcpy() of a small constant length
+		with the equivalent load and store instructions. */
+		switch( pxQueue->ucCopySize )
+		{
+			case 1U :
+				*( ( uint8_t * ) pvDestination ) = *( ( const uint8_t * ) pvSource );
+				break;
+
+			case 2U :
+				( void ) memcpy( pvDestination, pvSource, 2U );
+				break;
+
+			case 4U :
+				( void ) memcpy( pvDestination, pvSource, 4U );
+				break;
+
+			case 8U :
+				( void ) memcpy( pvDestination, pvSource, 8U );
+				break;
+
+			case 16U :
+				( void ) memcpy( pvDestination, pvSource, 16U );
+				break;
+
+			default :
+				( void ) memcpy( pvDestination, pvSource, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0. */
+				break;
+		}
+	}
+
+#endif /* configUSE_QUEUE_SIZED_COPY */
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
 	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -2768,9 +3224,21 @@ Queue_t * const pxQueue = xQueue;
 
 	QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength )
 	{
-	QueueSetHandle_t pxQueue;
+	Queue_t *pxQueue;
 
-		pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) sizeof( Queue_t * ), queueQUEUE_TYPE_SET );
+		/* A queue set does not store its events, it only links ready members
+		into a list, so no storage area is allocated.  uxEventQueueLength is
+		retained as the upper bound on the number of outstanding events. */
+		pxQueue = ( Queue_t * ) xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) 0, queueQUEUE_TYPE_SET );
+
+		if( pxQueue != NULL )
+		{
+			pxQueue->ucIsQueueSet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
 		return pxQueue;
 	}
@@ -2778,6 +3246,30 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueSetHandle_t xQueueCreateSetStatic( const UBaseType_t uxEventQueueLength, StaticQueue_t *pxStaticQueueSet )
+	{
+	Queue_t *pxQueue;
+
+		/* As in xQueueCreateSet(), the set has no storage area. */
+		pxQueue = ( Queue_t * ) xQueueGenericCreateStatic( uxEventQueueLength, ( UBaseType_t ) 0, NULL, pxStaticQueueSet, queueQUEUE_TYPE_SET ); /*lint !e9087 !e9079 The handle is a Queue_t. */
+
+		if( pxQueue != NULL )
+		{
+			pxQueue->ucIsQueueSet = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxQueue;
+	}
+
+#endif /* ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 	BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore, QueueSetHandle_t xQueueSet )
@@ -2791,6 +3283,11 @@ Queue_t * const pxQueue = xQueue;
 				/* Cannot add a queue/semaphore to more than one queue set. */
 				xReturn = pdFAIL;
 			}
+			else if( ( ( Queue_t * ) xQueueOrSemaphore )->ucIsQueueSet != pdFALSE )
+			{
+				/* Cannot add a queue set to a queue set. */
+				xReturn = pdFAIL;
+			}
 			else if( ( ( Queue_t * ) xQueueOrSemaphore )->uxMessagesWaiting != ( UBaseType_t ) 0 )
 			{
 				/* Cannot add a queue/semaphore to a queue set if there are already
@@ -2834,6 +3331,17 @@ Queue_t * const pxQueue = xQueue;
 		{
 			taskENTER_CRITICAL();
 			{
+				/* Events the member has already posted to the set, but that
+				were never selected, are discarded along with the membership. */
+				if( pxQueueOrSemaphore->uxSetEventsPending != ( UBaseType_t ) 0 )
+				{
+					prvRemoveReadyMemberFromSet( ( Queue_t * ) xQueueSet, pxQueueOrSemaphore );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
 				/* The queue is no longer contained in the set. */
 				pxQueueOrSemaphore->pxQueueSetContainer = NULL;
 			}
@@ -2927,15 +3435,401 @@ Queue_t * const pxQueue = xQueue;
 	}
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_SETS == 1 )
+
+	static void prvAddReadyMemberToSet( Queue_t * const pxQueueSet, Queue_t * const pxMember, const BaseType_t xCopyPosition )
+	{
+		/* This function must be called from a critical section. */
+
+		if( pxMember->uxSetEventsPending == ( UBaseType_t ) 0 )
+		{
+			/* The member was not ready, link it into the circular ready list.
+			The tail's successor is the head of the list. */
+			if( pxQueueSet->pxReadyMembersTail == NULL )
+			{
+				pxMember->pxNextReadyInSet = pxMember;
+				pxQueueSet->pxReadyMembersTail = pxMember;
+			}
+			else
+			{
+				pxMember->pxNextReadyInSet = pxQueueSet->pxReadyMembersTail->pxNextReadyInSet;
+				pxQueueSet->pxReadyMembersTail->pxNextReadyInSet = pxMember;
+
+				/* Inserting after the tail makes the member the new head, so
+				only move the tail if the member was sent to the back. */
+				if( xCopyPosition != queueSEND_TO_FRONT )
+				{
+					pxQueueSet->pxReadyMembersTail = pxMember;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			/* Already in the ready list - its position is retained. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxMember->uxSetEventsPending )++;
+	}
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SETS == 1 )
+
+	static Queue_t *prvTakeReadyMemberFromSet( Queue_t * const pxQueueSet )
+	{
+	Queue_t *pxTail = pxQueueSet->pxReadyMembersTail;
+	Queue_t *pxHead;
+
+		/* This function must be called from a critical section, and only when
+		the set's message count shows an event is pending. */
+		configASSERT( pxTail );
+
+		pxHead = pxTail->pxNextReadyInSet;
+		( pxHead->uxSetEventsPending )--;
+
+		if( pxHead->uxSetEventsPending == ( UBaseType_t ) 0 )
+		{
+			/* No more events for this member, unlink it. */
+			if( pxHead == pxTail )
+			{
+				pxQueueSet->pxReadyMembersTail = NULL;
+			}
+			else
+			{
+				pxTail->pxNextReadyInSet = pxHead->pxNextReadyInSet;
+			}
+
+			pxHead->pxNextReadyInSet = NULL;
+		}
+		else
+		{
+			/* The member still has events pending.  Rotating the list makes it
+			the tail, so other ready members are returned before it is again. */
+			pxQueueSet->pxReadyMembersTail = pxHead;
+		}
+
+		return pxHead;
+	}
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SETS == 1 )
+
+	static void prvRemoveReadyMemberFromSet( Queue_t * const pxQueueSet, Queue_t * const pxMember )
+	{
+	Queue_t *pxPrevious = pxQueueSet->pxReadyMembersTail;
+
+		/* This function must be called from a critical section.  Unlike
+		selecting from a set this walks the ready list to find the member's
+		predecessor, but it is only used when a member leaves the set. */
+		configASSERT( pxPrevious );
+
+		while( pxPrevious->pxNextReadyInSet != pxMember )
+		{
+			pxPrevious = pxPrevious->pxNextReadyInSet;
+		}
+
+		if( pxPrevious == pxMember )
+		{
+			/* The member was the only ready member. */
+			pxQueueSet->pxReadyMembersTail = NULL;
+		}
+		else
+		{
+			pxPrevious->pxNextReadyInSet = pxMember->pxNextReadyInSet;
+
+			if( pxQueueSet->pxReadyMembersTail == pxMember )
+			{
+				pxQueueSet->pxReadyMembersTail = pxPrevious;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxQueueSet->uxMessagesWaiting -= pxMember->uxSetEventsPending;
+		pxMember->uxSetEventsPending = ( UBaseType_t ) 0;
+		pxMember->pxNextReadyInSet = NULL;
+	}
+
+#endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+
+	static void prvRecordEnqueueTime( Queue_t * const pxQueue, const int8_t * const pcSlot )
+	{
+		/* This function is called from a critical section. */
+		if( pxQueue->pulEnqueueTimes != NULL )
+		{
+			pxQueue->pulEnqueueTimes[ ( UBaseType_t ) ( pcSlot - pxQueue->pcHead ) / pxQueue->uxItemSize ] = queueGET_TIMESTAMP(); /*lint !e946 !e947 Pointer subtraction is within the storage area. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_QUEUE_TIMESTAMPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+
+	static uint32_t prvRecordResidence( Queue_t * const pxQueue )
+	{
+	QueueResidenceStats_t * const pxStats = pxQueue->pxResidenceStats;
+	uint32_t ulAge = 0, ulBucket = 0;
+
+		/* This function is called from a critical section, directly after
+		prvCopyDataFromQueue() has left pcReadFrom pointing at the slot of the
+		item that was removed. */
+		if( pxStats != NULL )
+		{
+			ulAge = queueGET_TIMESTAMP() - pxQueue->pulEnqueueTimes[ ( UBaseType_t ) ( pxQueue->u.xQueue.pcReadFrom - pxQueue->pcHead ) / pxQueue->uxItemSize ]; /*lint !e946 !e947 Pointer subtraction is within the storage area. */
+
+			( pxStats->ulItems )++;
+			pxStats->ullTotalAge += ulAge;
+
+			if( ulAge < pxStats->ulMinAge )
+			{
+				pxStats->ulMinAge = ulAge;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ulAge > pxStats->ulMaxAge )
+			{
+				pxStats->ulMaxAge = ulAge;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The histogram bucket is the number of significant bits in the
+			age, capped at the last bucket. */
+			while( ( ( ulAge >> ulBucket ) != 0UL ) && ( ulBucket < ( uint32_t ) ( configQUEUE_RESIDENCE_HISTOGRAM_BUCKETS - 1 ) ) )
+			{
+				ulBucket++;
+			}
+			( pxStats->ulHistogram[ ulBucket ] )++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return ulAge;
+	}
+
+#endif /* configUSE_QUEUE_TIMESTAMPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+
+	BaseType_t xQueueGetResidenceStats( QueueHandle_t xQueue, QueueResidenceStats_t *pxStats )
+	{
+	Queue_t * const pxQueue = xQueue;
+	BaseType_t xReturn;
+
+		configASSERT( pxQueue );
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueue->pxResidenceStats != NULL )
+			{
+				*pxStats = *( pxQueue->pxResidenceStats );
+				xReturn = pdPASS;
+			}
+			else
+			{
+				xReturn = pdFAIL;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_TIMESTAMPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_TIMESTAMPS == 1 )
+
+	void vQueueResetResidenceStats( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxQueue->pxResidenceStats != NULL )
+			{
+				( void ) memset( ( void * ) pxQueue->pxResidenceStats, 0x00, sizeof( QueueResidenceStats_t ) );
+				pxQueue->pxResidenceStats->ulMinAge = ( uint32_t ) 0xffffffffUL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_TIMESTAMPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATS == 1 )
+
+	void vQueueGetStats( QueueHandle_t xQueue, QueueStats_t *pxQueueStats )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pxQueueStats );
+
+		pxQueueStats->xHandle = xQueue;
+
+		#if ( configQUEUE_REGISTRY_SIZE > 0 )
+		{
+			pxQueueStats->pcQueueName = pcQueueGetName( xQueue );
+		}
+		#else
+		{
+			pxQueueStats->pcQueueName = NULL;
+		}
+		#endif
 
+		taskENTER_CRITICAL();
+		{
+			pxQueueStats->uxLength = pxQueue->uxLength;
+			pxQueueStats->uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+			pxQueueStats->uxPeakMessagesWaiting = pxQueue->uxPeakMessagesWaiting;
+			pxQueueStats->ulSendsBlocked = pxQueue->ulSendsBlocked;
+			pxQueueStats->ulSendsTimedOut = pxQueue->ulSendsTimedOut;
+			pxQueueStats->ulReceivesBlocked = pxQueue->ulReceivesBlocked;
+			pxQueueStats->ulReceivesTimedOut = pxQueue->ulReceivesTimedOut;
+			pxQueueStats->xBlockedTicks = pxQueue->xBlockedTicks;
+		}
+		taskEXIT_CRITICAL();
 
+		/* A counting semaphore can be created holding items that were never
+		sent, so never report a peak below the current occupancy. */
+		if( pxQueueStats->uxMessagesWaiting > pxQueueStats->uxPeakMessagesWaiting )
+		{
+			pxQueueStats->uxPeakMessagesWaiting = pxQueueStats->uxMessagesWaiting;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
 
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATS == 1 )
 
+	void vQueueResetStats( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			pxQueue->uxPeakMessagesWaiting = pxQueue->uxMessagesWaiting;
+			pxQueue->ulSendsBlocked = 0UL;
+			pxQueue->ulSendsTimedOut = 0UL;
+			pxQueue->ulReceivesBlocked = 0UL;
+			pxQueue->ulReceivesTimedOut = 0UL;
+			pxQueue->xBlockedTicks = ( TickType_t ) 0U;
+		}
+		taskEXIT_CRITICAL();
+	}
 
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
 
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
 
+	UBaseType_t uxQueueGetRegistryStats( QueueStats_t * const pxQueueStatsArray, const UBaseType_t uxArraySize )
+	{
+	UBaseType_t ux, uxQueues = ( UBaseType_t ) 0U;
+	QueueHandle_t xHandle;
 
+		configASSERT( pxQueueStatsArray );
 
+		for( ux = ( UBaseType_t ) 0U; ( ux < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE ) && ( uxQueues < uxArraySize ); ux++ )
+		{
+			xHandle = xQueueRegistry[ ux ].xHandle;
+
+			if( xHandle != NULL )
+			{
+				vQueueGetStats( xHandle, &( pxQueueStatsArray[ uxQueues ] ) );
+				uxQueues++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return uxQueues;
+	}
+
+#endif /* ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+
+	void vQueueListStats( char *pcWriteBuffer )
+	{
+	UBaseType_t ux;
+	QueueStats_t xStats;
+
+		/*
+		 * PLEASE NOTE:
+		 *
+		 * This function is provided for convenience only, in the same way as
+		 * vTaskList().  It depends on sprintf(), and production systems should
+		 * call uxQueueGetRegistryStats() directly to get the raw data instead.
+		 */
+
+		/* Make sure the write buffer does not contain a string. */
+		*pcWriteBuffer = ( char ) 0x00;
+
+		for( ux = ( UBaseType_t ) 0U; ux < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE; ux++ )
+		{
+			if( xQueueRegistry[ ux ].xHandle != NULL )
+			{
+				vQueueGetStats( xQueueRegistry[ ux ].xHandle, &xStats );
+
+				/* The columns are name, length, items now, peak items, sends
+				blocked/timed out, receives blocked/timed out and ticks spent
+				blocked. */
+				sprintf( pcWriteBuffer, "%-*s\t%u\t%u\t%u\t%u/%u\t%u/%u\t%u\r\n", ( int ) ( configMAX_TASK_NAME_LEN - 1 ), ( xStats.pcQueueName != NULL ) ? xStats.pcQueueName : "", ( unsigned int ) xStats.uxLength, ( unsigned int ) xStats.uxMessagesWaiting, ( unsigned int ) xStats.uxPeakMessagesWaiting, ( unsigned int ) xStats.ulSendsBlocked, ( unsigned int ) xStats.ulSendsTimedOut, ( unsigned int ) xStats.ulReceivesBlocked, ( unsigned int ) xStats.ulReceivesTimedOut, ( unsigned int ) xStats.xBlockedTicks ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+				pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
 
+#endif /* ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) */
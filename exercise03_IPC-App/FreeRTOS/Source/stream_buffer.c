@@ -134,6 +134,19 @@ that uses task notifications. */
 /* Bits stored in the ucFlags field of the stream buffer. */
 #define sbFLAGS_IS_MESSAGE_BUFFER		( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
+#define sbFLAGS_IS_MULTI_PRODUCER		( ( uint8_t ) 4 ) /* Set if the stream buffer can be written by more than one task or interrupt at a time. */
+
+/* Producers of a multi-producer stream buffer that are blocked waiting for
+space are held in an event list, rather than using a task notification, as
+there can be more than one of them.  They are all unblocked whenever data is
+read out of the buffer. */
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	#define sbUNBLOCK_PRODUCERS( pxStreamBuffer ) prvUnblockProducers( pxStreamBuffer )
+	#define sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken ) prvUnblockProducersFromISR( ( pxStreamBuffer ), ( pxHigherPriorityTaskWoken ) )
+#else
+	#define sbUNBLOCK_PRODUCERS( pxStreamBuffer )
+	#define sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken )
+#endif
 
 /*-----------------------------------------------------------*/
 
@@ -144,6 +157,7 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	volatile size_t xHead;				/* Index to the next item to write within the buffer. */
 	size_t xLength;						/* The length of the buffer pointed to by pucBuffer. */
 	size_t xTriggerLevelBytes;			/* The number of bytes that must be in the stream buffer before a task that is waiting for data is unblocked. */
+	size_t xReservedLength;				/* The number of data bytes returned by the last call to xStreamBufferReserve(), which is the most that can be committed. */
 	volatile TaskHandle_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
 	volatile TaskHandle_t xTaskWaitingToSend;	/* Holds the handle of a task waiting to send data to a message buffer that is full. */
 	uint8_t *pucBuffer;					/* Points to the buffer itself - that is - the RAM that stores the data passed through the buffer. */
@@ -152,6 +166,15 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+		volatile size_t xReserved;				/* Index to the first byte not yet claimed by a producer.  Bytes between xHead and xReserved are being written and are not yet visible to the reader. */
+		volatile UBaseType_t uxActiveProducers;	/* The number of claims that have not yet been published. */
+		UBaseType_t uxOldestClaim;				/* Index into xClaimEnds[] and ucClaimWritten[] of the oldest claim that has not yet been published. */
+		size_t xClaimEnds[ configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ];		/* Index to the first byte after each claim, in the order the claims were made. */
+		uint8_t ucClaimWritten[ configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ];	/* Set to pdTRUE once the producer that made each claim has finished writing it. */
+		List_t xProducersWaitingForSpace;		/* Producers blocked waiting for space in a multi-producer buffer, in priority order. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -202,6 +225,164 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer,
 									  size_t xMaxCount,
 									  size_t xBytesAvailable ) PRIVILEGED_FUNCTION;
 
+/*
+ * Describes the xCount bytes of the buffer's data storage area that start at
+ * index xStart as one span, or as two spans if they wrap past the end of the
+ * storage area.  Returns xCount.
+ */
+static size_t prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+						   size_t xStart,
+						   size_t xCount,
+						   StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+/*
+ * The parts of xStreamBufferReserve() and xStreamBufferReserveFromISR() that
+ * are common to both, and likewise for the commit, peek and consume functions
+ * below.  xSpace and xBytesAvailable are the free space and used space
+ * respectively, as already obtained by the caller.
+ */
+static size_t prvReserve( StreamBuffer_t * const pxStreamBuffer,
+						  size_t xDataLengthBytes,
+						  size_t xSpace,
+						  StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+static size_t prvCommit( StreamBuffer_t * const pxStreamBuffer, size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+static size_t prvPeekSpans( StreamBuffer_t * const pxStreamBuffer,
+							size_t xBytesAvailable,
+							StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+static size_t prvConsume( StreamBuffer_t * const pxStreamBuffer, size_t xBytesConsumed ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task until there are at least xRequiredSpace bytes of
+ * space in the buffer, or xTicksToWait ticks have passed, in the same way as
+ * xStreamBufferSend().  Returns the space available.
+ */
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+							   size_t xRequiredSpace,
+							   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task until there are more than xBytesToStoreMessageLength
+ * bytes in the buffer, or xTicksToWait ticks have passed, in the same way as
+ * xStreamBufferReceive().  Returns the number of bytes in the buffer.
+ */
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+							  size_t xBytesToStoreMessageLength,
+							  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns how many of xDataLengthBytes bytes can be written to a buffer that
+ * has xSpace bytes of space: as many as possible for a stream buffer, or either
+ * all or none of them for a message buffer.
+ */
+static size_t prvBytesThatFit( const StreamBuffer_t * const pxStreamBuffer,
+							   size_t xDataLengthBytes,
+							   size_t xSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * Writes xDataLengthBytes bytes gathered from the uxSegments segments in
+ * pxSegments, preceded by their length if this is a message buffer, into the
+ * storage area starting at index xStart.  The head is not moved.  Returns the
+ * index that follows the last byte written.
+ */
+static size_t prvWriteSegments( const StreamBuffer_t * const pxStreamBuffer,
+								size_t xStart,
+								const StreamBufferTxSegment_t * const pxSegments,
+								UBaseType_t uxSegments,
+								size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the next message from a message buffer, or as many bytes as possible
+ * from a stream buffer, scattering them into the uxSegments segments in
+ * pxSegments.  A message that is larger than the segments is left in the
+ * buffer.  Returns the number of bytes removed, not counting the length of the
+ * message.
+ */
+static size_t prvReadSegments( StreamBuffer_t * const pxStreamBuffer,
+							   const StreamBufferRxSegment_t * const pxSegments,
+							   UBaseType_t uxSegments,
+							   size_t xBytesAvailable ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy xCount bytes between the storage area, starting at index xStart, and
+ * the segments in pxSegments, filling each segment before moving to the next.
+ * Each segment is copied with one call to memcpy(), or two if it straddles the
+ * end of the storage area.  Return the index that follows the last byte copied.
+ */
+static size_t prvGatherIntoBuffer( const StreamBuffer_t * const pxStreamBuffer,
+								   size_t xStart,
+								   const StreamBufferTxSegment_t * const pxSegments,
+								   UBaseType_t uxSegments,
+								   size_t xCount ) PRIVILEGED_FUNCTION;
+static size_t prvScatterFromBuffer( const StreamBuffer_t * const pxStreamBuffer,
+									size_t xStart,
+									const StreamBufferRxSegment_t * const pxSegments,
+									UBaseType_t uxSegments,
+									size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * The part of uxStreamBufferDrain() and uxStreamBufferDrainFromISR() that is
+ * common to both.  Passes each complete message in the first xBytesAvailable
+ * bytes of the buffer to pxCallback, or all of them as one piece of data for a
+ * stream buffer, then moves the tail past them all at once.  Returns the number
+ * of times pxCallback was called.
+ */
+static UBaseType_t prvDrain( StreamBuffer_t * const pxStreamBuffer,
+							 size_t xBytesAvailable,
+							 StreamBufferDrainCallback_t pxCallback,
+							 void *pvContext ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	/*
+	 * xStreamBufferSend() and xStreamBufferSendFromISR() for a multi-producer
+	 * stream buffer.  Space is claimed by moving xReserved in a critical section,
+	 * the data is copied into the claimed space with interrupts enabled, then the
+	 * space is published to the reader by prvPublish().
+	 */
+	static size_t prvSendMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+										const StreamBufferTxSegment_t * const pxSegments,
+										UBaseType_t uxSegments,
+										size_t xDataLengthBytes,
+										size_t xRequiredSpace,
+										TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+	static size_t prvSendMultiProducerFromISR( StreamBuffer_t * const pxStreamBuffer,
+											   const StreamBufferTxSegment_t * const pxSegments,
+											   UBaseType_t uxSegments,
+											   size_t xDataLengthBytes,
+											   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Claims space for a message, or for as many bytes of a stream as possible,
+	 * by moving xReserved.  Returns the number of data bytes claimed, the index
+	 * at which the claimed space starts in *pxStart, and the claim's entry in
+	 * the table of unpublished claims in *puxClaim.  Nothing is claimed if the
+	 * table is full.  Must be called from a critical section.
+	 */
+	static size_t prvClaimSpace( StreamBuffer_t * const pxStreamBuffer,
+								 size_t xDataLengthBytes,
+								 size_t * const pxStart,
+								 UBaseType_t * const puxClaim ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called by a producer once it has written the space of claim uxClaim.  The
+	 * claim is marked as written, then the head is moved past every written
+	 * claim that follows on from the data already published, stopping at the
+	 * first claim that is still being written.  The reader therefore sees
+	 * complete messages in the order their space was claimed and never sees a
+	 * message that is only partly written.  Returns pdTRUE if the head was moved.
+	 * Must be called from a critical section.
+	 */
+	static BaseType_t prvPublish( StreamBuffer_t * const pxStreamBuffer, UBaseType_t uxClaim ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Unblock every producer waiting for space in a multi-producer buffer so
+	 * they can check again whether there is now enough space for them.
+	 */
+	static void prvUnblockProducers( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+	static void prvUnblockProducersFromISR( StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -356,6 +537,33 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 #endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	StreamBufferHandle_t xStreamBufferEnableMultiProducer( StreamBufferHandle_t xStreamBuffer )
+	{
+	StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+		/* NULL is passed through so the result of a create function can be
+		passed in directly. */
+		if( pxStreamBuffer != NULL )
+		{
+			/* The mode can only be changed before the buffer is first used. */
+			configASSERT( ( pxStreamBuffer->xHead == ( size_t ) 0 ) && ( pxStreamBuffer->xTail == ( size_t ) 0 ) );
+			configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+
+			pxStreamBuffer->ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xStreamBuffer;
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
 void vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer )
 {
 StreamBuffer_t * pxStreamBuffer = xStreamBuffer;
@@ -408,12 +616,19 @@ BaseType_t xReturn = pdFAIL;
 	}
 	#endif
 
-	/* Can only reset a message buffer if there are no tasks blocked on it. */
+	/* Can only reset a message buffer if there are no tasks blocked on it, or
+	part way through writing to it. */
 	taskENTER_CRITICAL();
 	{
 		if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
 		{
-			if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+				if( ( pxStreamBuffer->xTaskWaitingToSend == NULL ) &&
+					( pxStreamBuffer->uxActiveProducers == ( UBaseType_t ) 0 ) &&
+					( listLIST_IS_EMPTY( &( pxStreamBuffer->xProducersWaitingForSpace ) ) != pdFALSE ) )
+			#else
+				if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#endif
 			{
 				prvInitialiseNewStreamBuffer( pxStreamBuffer,
 											  pxStreamBuffer->pucBuffer,
@@ -475,7 +690,26 @@ size_t xSpace;
 	configASSERT( pxStreamBuffer );
 
 	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-	xSpace -= pxStreamBuffer->xHead;
+
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		/* Space claimed by a producer is not free, even though it is not
+		visible to the reader until it is published. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xSpace -= pxStreamBuffer->xReserved;
+		}
+		else
+		{
+			xSpace -= pxStreamBuffer->xHead;
+		}
+	}
+	#else
+	{
+		xSpace -= pxStreamBuffer->xHead;
+	}
+	#endif
+
 	xSpace -= ( size_t ) 1;
 
 	if( xSpace >= pxStreamBuffer->xLength )
@@ -512,6 +746,9 @@ StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace = 0;
 size_t xRequiredSpace = xDataLengthBytes;
 TimeOut_t xTimeOut;
+#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	StreamBufferTxSegment_t xSegment;
+#endif
 
 	configASSERT( pvTxData );
 	configASSERT( pxStreamBuffer );
@@ -532,6 +769,23 @@ TimeOut_t xTimeOut;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		/* A multi-producer buffer is written in a different way so writers do
+		not need to be serialised by the application. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xSegment.pvData = pvTxData;
+			xSegment.xLength = xDataLengthBytes;
+			return prvSendMultiProducer( pxStreamBuffer, &xSegment, 1, xDataLengthBytes, xRequiredSpace, xTicksToWait );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+
 	if( xTicksToWait != ( TickType_t ) 0 )
 	{
 		vTaskSetTimeOutState( &xTimeOut );
@@ -615,6 +869,9 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace;
 size_t xRequiredSpace = xDataLengthBytes;
+#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	StreamBufferTxSegment_t xSegment;
+#endif
 
 	configASSERT( pvTxData );
 	configASSERT( pxStreamBuffer );
@@ -632,6 +889,21 @@ size_t xRequiredSpace = xDataLengthBytes;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			xSegment.pvData = pvTxData;
+			xSegment.xLength = xDataLengthBytes;
+			return prvSendMultiProducerFromISR( pxStreamBuffer, &xSegment, 1, xDataLengthBytes, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+
 	xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
 	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
 
@@ -798,6 +1070,7 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		{
 			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
 			sbRECEIVE_COMPLETED( pxStreamBuffer );
+			sbUNBLOCK_PRODUCERS( pxStreamBuffer );
 		}
 		else
 		{
@@ -898,6 +1171,7 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		if( xReceivedLength != ( size_t ) 0 )
 		{
 			sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
 		}
 		else
 		{
@@ -967,225 +1241,1684 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+							 size_t xDataLengthBytes,
+							 StreamBufferSpans_t * const pxSpans,
+							 TickType_t xTicksToWait )
 {
-const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-BaseType_t xReturn;
-size_t xTail;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xSpace;
+size_t xRequiredSpace = xDataLengthBytes;
 
+	configASSERT( pxSpans );
 	configASSERT( pxStreamBuffer );
 
-	/* True if no bytes are available. */
-	xTail = pxStreamBuffer->xTail;
-	if( pxStreamBuffer->xHead == xTail )
+	/* A message buffer also needs space for the length of the message, which
+	is written in front of the message when it is committed. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xReturn = pdTRUE;
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+		/* Overflow? */
+		configASSERT( xRequiredSpace > xDataLengthBytes );
 	}
 	else
 	{
-		xReturn = pdFALSE;
+		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xReturn;
+	/* Waiting for space is performed exactly as in xStreamBufferSend(), so
+	sbRECEIVE_COMPLETED() unblocks the writer in the same way. */
+	xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
+
+	return prvReserve( pxStreamBuffer, xDataLengthBytes, xSpace, pxSpans );
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer )
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes,
+									StreamBufferSpans_t * const pxSpans )
 {
-BaseType_t xReturn;
-size_t xBytesToStoreMessageLength;
-const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 
+	configASSERT( pxSpans );
 	configASSERT( pxStreamBuffer );
 
-	/* This generic version of the receive function is used by both message
-	buffers, which store discrete messages, and stream buffers, which store a
-	continuous stream of bytes.  Discrete messages include an additional
-	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
-	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
-	{
-		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
-	}
-	else
-	{
-		xBytesToStoreMessageLength = 0;
-	}
+	return prvReserve( pxStreamBuffer, xDataLengthBytes, xStreamBufferSpacesAvailable( pxStreamBuffer ), pxSpans );
+}
+/*-----------------------------------------------------------*/
 
-	/* True if the available space equals zero. */
-	if( xStreamBufferSpacesAvailable( xStreamBuffer ) <= xBytesToStoreMessageLength )
+size_t xStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn;
+
+	configASSERT( pxStreamBuffer );
+
+	xReturn = prvCommit( pxStreamBuffer, xBytesWritten );
+
+	if( xReturn > ( size_t ) 0 )
 	{
-		xReturn = pdTRUE;
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 	}
 	else
 	{
-		xReturn = pdFALSE;
+		mtCOVERAGE_TEST_MARKER();
 	}
 
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xStreamBufferSendCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken )
+size_t xStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+								   size_t xBytesWritten,
+								   BaseType_t * const pxHigherPriorityTaskWoken )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-BaseType_t xReturn;
-UBaseType_t uxSavedInterruptStatus;
+size_t xReturn;
 
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	xReturn = prvCommit( pxStreamBuffer, xBytesWritten );
+
+	if( xReturn > ( size_t ) 0 )
 	{
-		if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
 		{
-			( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,
-										 ( uint32_t ) 0,
-										 eNoAction,
-										 pxHigherPriorityTaskWoken );
-			( pxStreamBuffer )->xTaskWaitingToReceive = NULL;
-			xReturn = pdTRUE;
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
 		}
 		else
 		{
-			xReturn = pdFALSE;
+			mtCOVERAGE_TEST_MARKER();
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
 
 	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken )
+size_t xStreamBufferPeekSpans( StreamBufferHandle_t xStreamBuffer,
+							   StreamBufferSpans_t * const pxSpans,
+							   TickType_t xTicksToWait )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-BaseType_t xReturn;
-UBaseType_t uxSavedInterruptStatus;
+size_t xBytesAvailable, xBytesToStoreMessageLength;
 
+	configASSERT( pxSpans );
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
-		{
-			( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,
-										 ( uint32_t ) 0,
-										 eNoAction,
-										 pxHigherPriorityTaskWoken );
-			( pxStreamBuffer )->xTaskWaitingToSend = NULL;
-			xReturn = pdTRUE;
-		}
-		else
-		{
-			xReturn = pdFALSE;
-		}
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-	return xReturn;
+	/* Waiting for data is performed exactly as in xStreamBufferReceive(), so
+	sbSEND_COMPLETED() unblocks the reader in the same way. */
+	xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+
+	return prvPeekSpans( pxStreamBuffer, xBytesAvailable, pxSpans );
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
+size_t xStreamBufferPeekSpansFromISR( StreamBufferHandle_t xStreamBuffer,
+									  StreamBufferSpans_t * const pxSpans )
 {
-size_t xNextHead, xFirstLength;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 
-	configASSERT( xCount > ( size_t ) 0 );
+	configASSERT( pxSpans );
+	configASSERT( pxStreamBuffer );
 
-	xNextHead = pxStreamBuffer->xHead;
+	return prvPeekSpans( pxStreamBuffer, prvBytesInBuffer( pxStreamBuffer ), pxSpans );
+}
+/*-----------------------------------------------------------*/
 
-	/* Calculate the number of bytes that can be added in the first write -
-	which may be less than the total number of bytes that need to be added if
-	the buffer will wrap back to the beginning. */
-	xFirstLength = configMIN( pxStreamBuffer->xLength - xNextHead, xCount );
+size_t xStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesConsumed )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
 
-	/* Write as many bytes as can be written in the first write. */
-	configASSERT( ( xNextHead + xFirstLength ) <= pxStreamBuffer->xLength );
-	( void ) memcpy( ( void* ) ( &( pxStreamBuffer->pucBuffer[ xNextHead ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	configASSERT( pxStreamBuffer );
 
-	/* If the number of bytes written was less than the number that could be
-	written in the first write... */
-	if( xCount > xFirstLength )
+	xReceivedLength = prvConsume( pxStreamBuffer, xBytesConsumed );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
 	{
-		/* ...then write the remaining bytes to the start of the buffer. */
-		configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
-		( void ) memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+		sbUNBLOCK_PRODUCERS( pxStreamBuffer );
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	xNextHead += xCount;
-	if( xNextHead >= pxStreamBuffer->xLength )
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xBytesConsumed,
+									BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvConsume( pxStreamBuffer, xBytesConsumed );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
 	{
-		xNextHead -= pxStreamBuffer->xLength;
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	pxStreamBuffer->xHead = xNextHead;
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
 
-	return xCount;
+	return xReceivedLength;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xMaxCount, size_t xBytesAvailable )
+size_t xStreamBufferSendVectored( StreamBufferHandle_t xStreamBuffer,
+								  const StreamBufferTxSegment_t * const pxSegments,
+								  UBaseType_t uxSegments,
+								  TickType_t xTicksToWait )
 {
-size_t xCount, xFirstLength, xNextTail;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn, xSpace, xDataLengthBytes = 0, xRequiredSpace;
+UBaseType_t uxSegment;
 
-	/* Use the minimum of the wanted bytes and the available bytes. */
-	xCount = configMIN( xBytesAvailable, xMaxCount );
+	configASSERT( pxSegments );
+	configASSERT( pxStreamBuffer );
 
-	if( xCount > ( size_t ) 0 )
+	/* The length of the message is only calculated once, here. */
+	for( uxSegment = 0; uxSegment < uxSegments; uxSegment++ )
 	{
-		xNextTail = pxStreamBuffer->xTail;
+		configASSERT( ( pxSegments[ uxSegment ].pvData != NULL ) || ( pxSegments[ uxSegment ].xLength == ( size_t ) 0 ) );
+		xDataLengthBytes += pxSegments[ uxSegment ].xLength;
+	}
 
-		/* Calculate the number of bytes that can be read - which may be
-		less than the number wanted if the data wraps around to the start of
-		the buffer. */
-		xFirstLength = configMIN( pxStreamBuffer->xLength - xNextTail, xCount );
+	xRequiredSpace = xDataLengthBytes;
 
-		/* Obtain the number of bytes it is possible to obtain in the first
-		read.  Asserts check bounds of read and write. */
-		configASSERT( xFirstLength <= xMaxCount );
-		configASSERT( ( xNextTail + xFirstLength ) <= pxStreamBuffer->xLength );
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			return prvSendMultiProducer( pxStreamBuffer, pxSegments, uxSegments, xDataLengthBytes, xRequiredSpace, xTicksToWait );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+
+	xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
+	xReturn = prvBytesThatFit( pxStreamBuffer, xDataLengthBytes, xSpace );
+
+	if( xReturn > ( size_t ) 0 )
+	{
+		/* The head is only moved once the whole message is in the buffer. */
+		pxStreamBuffer->xHead = prvWriteSegments( pxStreamBuffer, pxStreamBuffer->xHead, pxSegments, uxSegments, xReturn );
+
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+		traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+										 const StreamBufferTxSegment_t * const pxSegments,
+										 UBaseType_t uxSegments,
+										 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn, xDataLengthBytes = 0;
+UBaseType_t uxSegment;
+
+	configASSERT( pxSegments );
+	configASSERT( pxStreamBuffer );
+
+	for( uxSegment = 0; uxSegment < uxSegments; uxSegment++ )
+	{
+		configASSERT( ( pxSegments[ uxSegment ].pvData != NULL ) || ( pxSegments[ uxSegment ].xLength == ( size_t ) 0 ) );
+		xDataLengthBytes += pxSegments[ uxSegment ].xLength;
+	}
+
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			return prvSendMultiProducerFromISR( pxStreamBuffer, pxSegments, uxSegments, xDataLengthBytes, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+
+	xReturn = prvBytesThatFit( pxStreamBuffer, xDataLengthBytes, xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+	if( xReturn > ( size_t ) 0 )
+	{
+		pxStreamBuffer->xHead = prvWriteSegments( pxStreamBuffer, pxStreamBuffer->xHead, pxSegments, uxSegments, xReturn );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveVectored( StreamBufferHandle_t xStreamBuffer,
+									 const StreamBufferRxSegment_t * const pxSegments,
+									 UBaseType_t uxSegments,
+									 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength, xBytesAvailable, xBytesToStoreMessageLength;
+
+	configASSERT( pxSegments );
+	configASSERT( pxStreamBuffer );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+	xReceivedLength = prvReadSegments( pxStreamBuffer, pxSegments, uxSegments, xBytesAvailable );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+		sbUNBLOCK_PRODUCERS( pxStreamBuffer );
+	}
+	else
+	{
+		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveVectoredFromISR( StreamBufferHandle_t xStreamBuffer,
+											const StreamBufferRxSegment_t * const pxSegments,
+											UBaseType_t uxSegments,
+											BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxSegments );
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvReadSegments( pxStreamBuffer, pxSegments, uxSegments, prvBytesInBuffer( pxStreamBuffer ) );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxStreamBufferDrain( StreamBufferHandle_t xStreamBuffer,
+								 StreamBufferDrainCallback_t pxCallback,
+								 void *pvContext,
+								 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable, xBytesToStoreMessageLength;
+UBaseType_t uxMessages;
+
+	configASSERT( pxCallback );
+	configASSERT( pxStreamBuffer );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	/* The head is only read once, so messages written while the callbacks are
+	running are left for the next call. */
+	xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+	uxMessages = prvDrain( pxStreamBuffer, xBytesAvailable, pxCallback, pvContext );
+
+	/* A task waiting for space is notified once for the whole batch. */
+	if( uxMessages != ( UBaseType_t ) 0 )
+	{
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesAvailable );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+		sbUNBLOCK_PRODUCERS( pxStreamBuffer );
+	}
+	else
+	{
+		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxMessages;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxStreamBufferDrainFromISR( StreamBufferHandle_t xStreamBuffer,
+									    StreamBufferDrainCallback_t pxCallback,
+									    void *pvContext,
+									    BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable;
+UBaseType_t uxMessages;
+
+	configASSERT( pxCallback );
+	configASSERT( pxStreamBuffer );
+
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	uxMessages = prvDrain( pxStreamBuffer, xBytesAvailable, pxCallback, pvContext );
+
+	if( uxMessages != ( UBaseType_t ) 0 )
+	{
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		sbUNBLOCK_PRODUCERS_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xBytesAvailable );
+
+	return uxMessages;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
+{
+const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+BaseType_t xReturn;
+size_t xTail;
+
+	configASSERT( pxStreamBuffer );
+
+	/* True if no bytes are available. */
+	xTail = pxStreamBuffer->xTail;
+	if( pxStreamBuffer->xHead == xTail )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		xReturn = pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer )
+{
+BaseType_t xReturn;
+size_t xBytesToStoreMessageLength;
+const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxStreamBuffer );
+
+	/* This generic version of the receive function is used by both message
+	buffers, which store discrete messages, and stream buffers, which store a
+	continuous stream of bytes.  Discrete messages include an additional
+	sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	/* True if the available space equals zero. */
+	if( xStreamBufferSpacesAvailable( xStreamBuffer ) <= xBytesToStoreMessageLength )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		xReturn = pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferSendCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+BaseType_t xReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxStreamBuffer );
+
+	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
+		{
+			( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,
+										 ( uint32_t ) 0,
+										 eNoAction,
+										 pxHigherPriorityTaskWoken );
+			( pxStreamBuffer )->xTaskWaitingToReceive = NULL;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+BaseType_t xReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxStreamBuffer );
+
+	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
+		{
+			( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,
+										 ( uint32_t ) 0,
+										 eNoAction,
+										 pxHigherPriorityTaskWoken );
+			( pxStreamBuffer )->xTaskWaitingToSend = NULL;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
+{
+size_t xNextHead, xFirstLength;
+
+	configASSERT( xCount > ( size_t ) 0 );
+
+	xNextHead = pxStreamBuffer->xHead;
+
+	/* Calculate the number of bytes that can be added in the first write -
+	which may be less than the total number of bytes that need to be added if
+	the buffer will wrap back to the beginning. */
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xNextHead, xCount );
+
+	/* Write as many bytes as can be written in the first write. */
+	configASSERT( ( xNextHead + xFirstLength ) <= pxStreamBuffer->xLength );
+	( void ) memcpy( ( void* ) ( &( pxStreamBuffer->pucBuffer[ xNextHead ] ) ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+	/* If the number of bytes written was less than the number that could be
+	written in the first write... */
+	if( xCount > xFirstLength )
+	{
+		/* ...then write the remaining bytes to the start of the buffer. */
+		configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
+		( void ) memcpy( ( void * ) pxStreamBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xNextHead += xCount;
+	if( xNextHead >= pxStreamBuffer->xLength )
+	{
+		xNextHead -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxStreamBuffer->xHead = xNextHead;
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xMaxCount, size_t xBytesAvailable )
+{
+size_t xCount, xFirstLength, xNextTail;
+
+	/* Use the minimum of the wanted bytes and the available bytes. */
+	xCount = configMIN( xBytesAvailable, xMaxCount );
+
+	if( xCount > ( size_t ) 0 )
+	{
+		xNextTail = pxStreamBuffer->xTail;
+
+		/* Calculate the number of bytes that can be read - which may be
+		less than the number wanted if the data wraps around to the start of
+		the buffer. */
+		xFirstLength = configMIN( pxStreamBuffer->xLength - xNextTail, xCount );
+
+		/* Obtain the number of bytes it is possible to obtain in the first
+		read.  Asserts check bounds of read and write. */
+		configASSERT( xFirstLength <= xMaxCount );
+		configASSERT( ( xNextTail + xFirstLength ) <= pxStreamBuffer->xLength );
 		( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xNextTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
 
-		/* If the total number of wanted bytes is greater than the number
-		that could be read in the first read... */
-		if( xCount > xFirstLength )
+		/* If the total number of wanted bytes is greater than the number
+		that could be read in the first read... */
+		if( xCount > xFirstLength )
+		{
+			/*...then read the remaining bytes from the start of the buffer. */
+			configASSERT( xCount <= xMaxCount );
+			( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Move the tail pointer to effectively remove the data read from
+		the buffer. */
+		xNextTail += xCount;
+
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+						   size_t xStart,
+						   size_t xCount,
+						   StreamBufferSpans_t * const pxSpans )
+{
+size_t xFirstLength;
+
+	if( xStart >= pxStreamBuffer->xLength )
+	{
+		xStart -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xCount > ( size_t ) 0 )
+	{
+		/* As in prvWriteBytesToBuffer(), the first span runs to the end of the
+		storage area at most, and anything left over starts again at the
+		beginning of the storage area. */
+		xFirstLength = configMIN( pxStreamBuffer->xLength - xStart, xCount );
+		pxSpans->pucFirst = &( pxStreamBuffer->pucBuffer[ xStart ] );
+		pxSpans->xFirstLength = xFirstLength;
+
+		if( xCount > xFirstLength )
+		{
+			pxSpans->pucSecond = pxStreamBuffer->pucBuffer;
+			pxSpans->xSecondLength = xCount - xFirstLength;
+		}
+		else
+		{
+			pxSpans->pucSecond = NULL;
+			pxSpans->xSecondLength = 0;
+		}
+	}
+	else
+	{
+		pxSpans->pucFirst = NULL;
+		pxSpans->xFirstLength = 0;
+		pxSpans->pucSecond = NULL;
+		pxSpans->xSecondLength = 0;
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReserve( StreamBuffer_t * const pxStreamBuffer,
+						  size_t xDataLengthBytes,
+						  size_t xSpace,
+						  StreamBufferSpans_t * const pxSpans )
+{
+size_t xStart = pxStreamBuffer->xHead;
+
+	/* Producers of a multi-producer buffer claim space with
+	xStreamBufferSend() instead. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) == ( uint8_t ) 0 );
+
+	/* Reserving space does not change the state of the buffer - the reserved
+	bytes only become visible to the reader when xStreamBufferCommit() moves the
+	head past them - so reserving again before committing returns the same
+	space. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 )
+	{
+		/* A stream buffer reserves as many bytes as possible. */
+		xDataLengthBytes = configMIN( xDataLengthBytes, xSpace );
+	}
+	else if( xSpace >= ( xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH ) )
+	{
+		/* A message buffer reserves the whole message or nothing.  The message
+		starts after the bytes that will hold its length. */
+		xStart += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xDataLengthBytes = 0;
+	}
+
+	/* Remember how much was reserved so prvCommit() cannot publish bytes the
+	writer was never given. */
+	pxStreamBuffer->xReservedLength = xDataLengthBytes;
+
+	return prvGetSpans( pxStreamBuffer, xStart, xDataLengthBytes, pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCommit( StreamBuffer_t * const pxStreamBuffer, size_t xBytesWritten )
+{
+size_t xNextHead, xRequiredSpace = xBytesWritten;
+configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) == ( uint8_t ) 0 );
+
+	/* Cannot commit more than was reserved.  If asserts are not enabled then
+	only the reserved bytes are committed, as any bytes past them were never
+	written. */
+	configASSERT( xBytesWritten <= pxStreamBuffer->xReservedLength );
+
+	if( xBytesWritten > pxStreamBuffer->xReservedLength )
+	{
+		xBytesWritten = pxStreamBuffer->xReservedLength;
+		xRequiredSpace = xBytesWritten;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* The reservation is used up by the commit, whatever its length. */
+	pxStreamBuffer->xReservedLength = 0;
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+			/* The length goes in front of the message data that is already in
+			the buffer.  prvWriteBytesToBuffer() moves the head past it. */
+			configASSERT( xRequiredSpace <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+			xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xBytesWritten;
+			( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+		}
+		else
+		{
+			configASSERT( xRequiredSpace <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+		}
+
+		/* Make the data visible to the reader. */
+		xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xBytesWritten;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvPeekSpans( StreamBuffer_t * const pxStreamBuffer,
+							size_t xBytesAvailable,
+							StreamBufferSpans_t * const pxSpans )
+{
+size_t xOriginalTail, xStart = pxStreamBuffer->xTail;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			/* Only the next message is returned.  Read its length without
+			removing it from the buffer, as xStreamBufferNextMessageLengthBytes()
+			does. */
+			xOriginalTail = pxStreamBuffer->xTail;
+			( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xBytesAvailable );
+			pxStreamBuffer->xTail = xOriginalTail;
+
+			xStart += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+			xBytesAvailable = ( size_t ) xTempNextMessageLength;
+		}
+		else
+		{
+			xBytesAvailable = 0;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return prvGetSpans( pxStreamBuffer, xStart, xBytesAvailable, pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvConsume( StreamBuffer_t * const pxStreamBuffer, size_t xBytesConsumed )
+{
+size_t xNextTail, xBytesAvailable;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			/* The whole of the next message is removed, whatever the value of
+			xBytesConsumed.  Reading the length moves the tail past it. */
+			( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xBytesAvailable );
+			xBytesConsumed = ( size_t ) xTempNextMessageLength;
+		}
+		else
+		{
+			xBytesConsumed = 0;
+		}
+	}
+	else
+	{
+		/* Cannot consume more bytes than are in the buffer. */
+		configASSERT( xBytesConsumed <= xBytesAvailable );
+		xBytesConsumed = configMIN( xBytesConsumed, xBytesAvailable );
+	}
+
+	/* Move the tail to remove the data from the buffer. */
+	xNextTail = pxStreamBuffer->xTail + xBytesConsumed;
+
+	if( xNextTail >= pxStreamBuffer->xLength )
+	{
+		xNextTail -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxStreamBuffer->xTail = xNextTail;
+
+	return xBytesConsumed;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+							   size_t xRequiredSpace,
+							   TickType_t xTicksToWait )
+{
+size_t xSpace = 0;
+TimeOut_t xTimeOut;
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Wait until the required number of bytes are free in the
+			buffer. */
+			taskENTER_CRITICAL();
+			{
+				xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+				if( xSpace < xRequiredSpace )
+				{
+					/* Clear notification state as going to wait for space. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one writer. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xSpace == ( size_t ) 0 )
+	{
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+							  size_t xBytesToStoreMessageLength,
+							  TickType_t xTicksToWait )
+{
+size_t xBytesAvailable;
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		/* Checking if there is data and clearing the notification state must be
+		performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable <= xBytesToStoreMessageLength )
+			{
+				/* Clear notification state as going to wait for data. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable <= xBytesToStoreMessageLength )
+		{
+			/* Wait for data to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			/* Recheck the data available after blocking. */
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+
+	return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBytesThatFit( const StreamBuffer_t * const pxStreamBuffer,
+							   size_t xDataLengthBytes,
+							   size_t xSpace )
+{
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 )
+	{
+		/* A stream buffer writes as many bytes as possible. */
+		xDataLengthBytes = configMIN( xDataLengthBytes, xSpace );
+	}
+	else if( xSpace >= ( xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH ) )
+	{
+		/* A message buffer writes the whole message and its length. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else
+	{
+		/* ...or nothing. */
+		xDataLengthBytes = 0;
+	}
+
+	return xDataLengthBytes;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteSegments( const StreamBuffer_t * const pxStreamBuffer,
+								size_t xStart,
+								const StreamBufferTxSegment_t * const pxSegments,
+								UBaseType_t uxSegments,
+								size_t xDataLengthBytes )
+{
+configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+StreamBufferTxSegment_t xLengthSegment;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		/* The length of the message goes first, and can itself wrap. */
+		xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xDataLengthBytes;
+		xLengthSegment.pvData = &xMessageLength;
+		xLengthSegment.xLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xStart = prvGatherIntoBuffer( pxStreamBuffer, xStart, &xLengthSegment, 1, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return prvGatherIntoBuffer( pxStreamBuffer, xStart, pxSegments, uxSegments, xDataLengthBytes );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadSegments( StreamBuffer_t * const pxStreamBuffer,
+							   const StreamBufferRxSegment_t * const pxSegments,
+							   UBaseType_t uxSegments,
+							   size_t xBytesAvailable )
+{
+size_t xCount, xCapacity = 0, xNextTail = pxStreamBuffer->xTail;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+StreamBufferRxSegment_t xLengthSegment;
+UBaseType_t uxSegment;
+
+	for( uxSegment = 0; uxSegment < uxSegments; uxSegment++ )
+	{
+		configASSERT( ( pxSegments[ uxSegment ].pvData != NULL ) || ( pxSegments[ uxSegment ].xLength == ( size_t ) 0 ) );
+		xCapacity += pxSegments[ uxSegment ].xLength;
+	}
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			xLengthSegment.pvData = &xTempNextMessageLength;
+			xLengthSegment.xLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+			xNextTail = prvScatterFromBuffer( pxStreamBuffer, xNextTail, &xLengthSegment, 1, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+			xCount = ( size_t ) xTempNextMessageLength;
+
+			/* As in prvReadMessageFromBuffer(), a message that will not fit is
+			left in the buffer. */
+			if( xCount > xCapacity )
+			{
+				xCount = 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			xCount = 0;
+		}
+	}
+	else
+	{
+		xCount = configMIN( xCapacity, xBytesAvailable );
+	}
+
+	if( xCount > ( size_t ) 0 )
+	{
+		/* The tail is only moved once the whole message has been read. */
+		pxStreamBuffer->xTail = prvScatterFromBuffer( pxStreamBuffer, xNextTail, pxSegments, uxSegments, xCount );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGatherIntoBuffer( const StreamBuffer_t * const pxStreamBuffer,
+								   size_t xStart,
+								   const StreamBufferTxSegment_t * const pxSegments,
+								   UBaseType_t uxSegments,
+								   size_t xCount )
+{
+StreamBufferSpans_t xSpans;
+const uint8_t *pucData;
+size_t xSegmentLength;
+UBaseType_t uxSegment;
+
+	for( uxSegment = 0; ( uxSegment < uxSegments ) && ( xCount > ( size_t ) 0 ); uxSegment++ )
+	{
+		xSegmentLength = configMIN( pxSegments[ uxSegment ].xLength, xCount );
+
+		if( xSegmentLength > ( size_t ) 0 )
+		{
+			pucData = ( const uint8_t * ) pxSegments[ uxSegment ].pvData; /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+			( void ) prvGetSpans( pxStreamBuffer, xStart, xSegmentLength, &xSpans );
+			( void ) memcpy( ( void * ) xSpans.pucFirst, ( const void * ) pucData, xSpans.xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+			if( xSpans.xSecondLength > ( size_t ) 0 )
+			{
+				( void ) memcpy( ( void * ) xSpans.pucSecond, ( const void * ) &( pucData[ xSpans.xFirstLength ] ), xSpans.xSecondLength ); /*lint !e9087 memcpy() requires void *. */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xStart = ( size_t ) ( xSpans.pucFirst - pxStreamBuffer->pucBuffer ) + xSegmentLength;
+
+			if( xStart >= pxStreamBuffer->xLength )
+			{
+				xStart -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xCount -= xSegmentLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xStart;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvScatterFromBuffer( const StreamBuffer_t * const pxStreamBuffer,
+									size_t xStart,
+									const StreamBufferRxSegment_t * const pxSegments,
+									UBaseType_t uxSegments,
+									size_t xCount )
+{
+StreamBufferSpans_t xSpans;
+uint8_t *pucData;
+size_t xSegmentLength;
+UBaseType_t uxSegment;
+
+	for( uxSegment = 0; ( uxSegment < uxSegments ) && ( xCount > ( size_t ) 0 ); uxSegment++ )
+	{
+		xSegmentLength = configMIN( pxSegments[ uxSegment ].xLength, xCount );
+
+		if( xSegmentLength > ( size_t ) 0 )
 		{
-			/*...then read the remaining bytes from the start of the buffer. */
-			configASSERT( xCount <= xMaxCount );
-			( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+			pucData = ( uint8_t * ) pxSegments[ uxSegment ].pvData; /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+			( void ) prvGetSpans( pxStreamBuffer, xStart, xSegmentLength, &xSpans );
+			( void ) memcpy( ( void * ) pucData, ( const void * ) xSpans.pucFirst, xSpans.xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+			if( xSpans.xSecondLength > ( size_t ) 0 )
+			{
+				( void ) memcpy( ( void * ) &( pucData[ xSpans.xFirstLength ] ), ( const void * ) xSpans.pucSecond, xSpans.xSecondLength ); /*lint !e9087 memcpy() requires void *. */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xStart = ( size_t ) ( xSpans.pucFirst - pxStreamBuffer->pucBuffer ) + xSegmentLength;
+
+			if( xStart >= pxStreamBuffer->xLength )
+			{
+				xStart -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xCount -= xSegmentLength;
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
+	}
 
-		/* Move the tail pointer to effectively remove the data read from
-		the buffer. */
-		xNextTail += xCount;
+	return xStart;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvDrain( StreamBuffer_t * const pxStreamBuffer,
+							 size_t xBytesAvailable,
+							 StreamBufferDrainCallback_t pxCallback,
+							 void *pvContext )
+{
+size_t xNextTail = pxStreamBuffer->xTail, xMessageLength;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+StreamBufferRxSegment_t xLengthSegment;
+StreamBufferSpans_t xSpans;
+UBaseType_t uxMessages = 0;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xLengthSegment.pvData = &xTempNextMessageLength;
+		xLengthSegment.xLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+		while( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+		{
+			xNextTail = prvScatterFromBuffer( pxStreamBuffer, xNextTail, &xLengthSegment, 1, sbBYTES_TO_STORE_MESSAGE_LENGTH );
+			xMessageLength = ( size_t ) xTempNextMessageLength;
+			xBytesAvailable -= sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+			/* Messages are only ever published whole. */
+			configASSERT( xMessageLength <= xBytesAvailable );
+
+			/* The message is passed to the callback in place. */
+			xNextTail += prvGetSpans( pxStreamBuffer, xNextTail, xMessageLength, &xSpans );
+			pxCallback( &xSpans, xMessageLength, pvContext );
+
+			if( xNextTail >= pxStreamBuffer->xLength )
+			{
+				xNextTail -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xBytesAvailable -= xMessageLength;
+			uxMessages++;
+		}
+	}
+	else if( xBytesAvailable > ( size_t ) 0 )
+	{
+		/* A stream has no message boundaries, so is passed to the callback as
+		one piece of data. */
+		xNextTail += prvGetSpans( pxStreamBuffer, xNextTail, xBytesAvailable, &xSpans );
+		pxCallback( &xSpans, xBytesAvailable, pvContext );
 
 		if( xNextTail >= pxStreamBuffer->xLength )
 		{
 			xNextTail -= pxStreamBuffer->xLength;
 		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-		pxStreamBuffer->xTail = xNextTail;
+		uxMessages++;
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xCount;
+	/* Free the space used by all the messages at once. */
+	pxStreamBuffer->xTail = xNextTail;
+
+	return uxMessages;
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static size_t prvSendMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+										const StreamBufferTxSegment_t * const pxSegments,
+										UBaseType_t uxSegments,
+										size_t xDataLengthBytes,
+										size_t xRequiredSpace,
+										TickType_t xTicksToWait )
+	{
+	size_t xReturn, xStart = 0;
+	UBaseType_t uxClaim = 0;
+	BaseType_t xPublished, xClaimsWereFull;
+	TimeOut_t xTimeOut;
+
+		vTaskSetTimeOutState( &xTimeOut );
+
+		for( ;; )
+		{
+			/* Checking the space and either claiming it or joining the list of
+			producers waiting for space must be performed atomically.  A producer
+			also waits if configSTREAM_BUFFER_MAX_CONCURRENT_WRITES claims are
+			already being written. */
+			taskENTER_CRITICAL();
+			{
+				if( ( xTicksToWait == ( TickType_t ) 0 ) ||
+					( ( xStreamBufferSpacesAvailable( pxStreamBuffer ) >= xRequiredSpace ) &&
+					  ( pxStreamBuffer->uxActiveProducers < ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ) ) )
+				{
+					/* A stream buffer write that timed out still writes as many
+					bytes as there is space for, as in the single producer case. */
+					xReturn = prvClaimSpace( pxStreamBuffer, xDataLengthBytes, &xStart, &uxClaim );
+					taskEXIT_CRITICAL();
+					break;
+				}
+				else
+				{
+					traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+					vTaskPlaceOnEventList( &( pxStreamBuffer->xProducersWaitingForSpace ), xTicksToWait );
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			portYIELD_WITHIN_API();
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+			{
+				/* Make one last attempt without blocking. */
+				xTicksToWait = ( TickType_t ) 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		if( xReturn > ( size_t ) 0 )
+		{
+			/* The claimed space belongs to this producer alone, so it is written
+			without holding a critical section. */
+			( void ) prvWriteSegments( pxStreamBuffer, xStart, pxSegments, uxSegments, xReturn );
+
+			taskENTER_CRITICAL();
+			{
+				xClaimsWereFull = ( pxStreamBuffer->uxActiveProducers >= ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ) ? pdTRUE : pdFALSE;
+				xPublished = prvPublish( pxStreamBuffer, uxClaim );
+			}
+			taskEXIT_CRITICAL();
+
+			traceSTREAM_BUFFER_SEND( pxStreamBuffer, xReturn );
+
+			/* Only the producer that publishes the data notifies the reader. */
+			if( ( xPublished != pdFALSE ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
+			{
+				sbSEND_COMPLETED( pxStreamBuffer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Producers waiting because every claim was in use can now claim
+			the entries freed by publishing. */
+			if( ( xPublished != pdFALSE ) && ( xClaimsWereFull != pdFALSE ) )
+			{
+				prvUnblockProducers( pxStreamBuffer );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			traceSTREAM_BUFFER_SEND_FAILED( pxStreamBuffer );
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static size_t prvSendMultiProducerFromISR( StreamBuffer_t * const pxStreamBuffer,
+											   const StreamBufferTxSegment_t * const pxSegments,
+											   UBaseType_t uxSegments,
+											   size_t xDataLengthBytes,
+											   BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	size_t xReturn, xStart = 0;
+	BaseType_t xPublished, xClaimsWereFull;
+	UBaseType_t uxSavedInterruptStatus, uxClaim = 0;
+
+		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			xReturn = prvClaimSpace( pxStreamBuffer, xDataLengthBytes, &xStart, &uxClaim );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		if( xReturn > ( size_t ) 0 )
+		{
+			( void ) prvWriteSegments( pxStreamBuffer, xStart, pxSegments, uxSegments, xReturn );
+
+			uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				xClaimsWereFull = ( pxStreamBuffer->uxActiveProducers >= ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES ) ? pdTRUE : pdFALSE;
+				xPublished = prvPublish( pxStreamBuffer, uxClaim );
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+			if( ( xPublished != pdFALSE ) && ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) )
+			{
+				sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( ( xPublished != pdFALSE ) && ( xClaimsWereFull != pdFALSE ) )
+			{
+				prvUnblockProducersFromISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceSTREAM_BUFFER_SEND_FROM_ISR( pxStreamBuffer, xReturn );
+
+		return xReturn;
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static size_t prvClaimSpace( StreamBuffer_t * const pxStreamBuffer,
+								 size_t xDataLengthBytes,
+								 size_t * const pxStart,
+								 UBaseType_t * const puxClaim )
+	{
+	size_t xSpace, xClaimedSpace, xNextReserved;
+	UBaseType_t uxClaim;
+
+		if( pxStreamBuffer->uxActiveProducers < ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES )
+		{
+			xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+			xDataLengthBytes = prvBytesThatFit( pxStreamBuffer, xDataLengthBytes, xSpace );
+		}
+		else
+		{
+			/* There is nowhere to record another claim. */
+			xDataLengthBytes = 0;
+		}
+
+		if( xDataLengthBytes > ( size_t ) 0 )
+		{
+			/* A message buffer also claims the space for the length of the
+			message. */
+			xClaimedSpace = xDataLengthBytes;
+
+			if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+			{
+				xClaimedSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			*pxStart = pxStreamBuffer->xReserved;
+
+			xNextReserved = pxStreamBuffer->xReserved + xClaimedSpace;
+
+			if( xNextReserved >= pxStreamBuffer->xLength )
+			{
+				xNextReserved -= pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxStreamBuffer->xReserved = xNextReserved;
+
+			/* Claims are recorded in the order they are made, after the oldest
+			claim that has not yet been published. */
+			uxClaim = pxStreamBuffer->uxOldestClaim + pxStreamBuffer->uxActiveProducers;
+
+			if( uxClaim >= ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES )
+			{
+				uxClaim -= ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxStreamBuffer->xClaimEnds[ uxClaim ] = xNextReserved;
+			pxStreamBuffer->ucClaimWritten[ uxClaim ] = ( uint8_t ) pdFALSE;
+			( pxStreamBuffer->uxActiveProducers )++;
+			*puxClaim = uxClaim;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xDataLengthBytes;
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static BaseType_t prvPublish( StreamBuffer_t * const pxStreamBuffer, UBaseType_t uxClaim )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		configASSERT( pxStreamBuffer->uxActiveProducers > ( UBaseType_t ) 0 );
+		pxStreamBuffer->ucClaimWritten[ uxClaim ] = ( uint8_t ) pdTRUE;
+
+		/* Publish the written claims in the order they were made.  If a claim
+		made earlier than this one is still being written then this one stays
+		hidden, and is published by the producer of the earlier claim when it
+		finishes. */
+		while( ( pxStreamBuffer->uxActiveProducers > ( UBaseType_t ) 0 ) &&
+			   ( pxStreamBuffer->ucClaimWritten[ pxStreamBuffer->uxOldestClaim ] != ( uint8_t ) pdFALSE ) )
+		{
+			pxStreamBuffer->xHead = pxStreamBuffer->xClaimEnds[ pxStreamBuffer->uxOldestClaim ];
+			( pxStreamBuffer->uxActiveProducers )--;
+			( pxStreamBuffer->uxOldestClaim )++;
+
+			if( pxStreamBuffer->uxOldestClaim >= ( UBaseType_t ) configSTREAM_BUFFER_MAX_CONCURRENT_WRITES )
+			{
+				pxStreamBuffer->uxOldestClaim = 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdTRUE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static void prvUnblockProducers( StreamBuffer_t * const pxStreamBuffer )
+	{
+		if( listLIST_IS_EMPTY( &( pxStreamBuffer->xProducersWaitingForSpace ) ) == pdFALSE )
+		{
+			/* With the scheduler suspended the unblocked tasks are held in the
+			pending ready list, and xTaskResumeAll() performs any context switch
+			that is needed. */
+			vTaskSuspendAll();
+			{
+				taskENTER_CRITICAL();
+				{
+					while( listLIST_IS_EMPTY( &( pxStreamBuffer->xProducersWaitingForSpace ) ) == pdFALSE )
+					{
+						( void ) xTaskRemoveFromEventList( &( pxStreamBuffer->xProducersWaitingForSpace ) );
+					}
+				}
+				taskEXIT_CRITICAL();
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+
+	static void prvUnblockProducersFromISR( StreamBuffer_t * const pxStreamBuffer, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			while( listLIST_IS_EMPTY( &( pxStreamBuffer->xProducersWaitingForSpace ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxStreamBuffer->xProducersWaitingForSpace ) ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+
+#endif /* configUSE_MULTI_PRODUCER_STREAM_BUFFERS */
+/*-----------------------------------------------------------*/
+
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 {
 /* Returns the distance between xTail and xHead. */
@@ -1230,6 +2963,12 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 	pxStreamBuffer->xLength = xBufferSizeBytes;
 	pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
 	pxStreamBuffer->ucFlags = ucFlags;
+
+	#if( configUSE_MULTI_PRODUCER_STREAM_BUFFERS == 1 )
+	{
+		vListInitialise( &( pxStreamBuffer->xProducersWaitingForSpace ) );
+	}
+	#endif
 }
 
 #if ( configUSE_TRACE_FACILITY == 1 )
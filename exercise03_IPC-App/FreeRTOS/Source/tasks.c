@@ -39,6 +39,8 @@ task.h is included from an application file. */
 #include "task.h"
 #include "timers.h"
 #include "stack_macros.h"
+#include "object_pools.h"
+#include "arena.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
@@ -75,6 +77,12 @@ functions but without including stdio.h here. */
  */
 #define tskSTACK_FILL_BYTE	( 0xa5U )
 
+/*
+ * The value a whole stack word holds when every byte in it still holds
+ * tskSTACK_FILL_BYTE, so the stack profiler can check a word at a time.
+ */
+#define tskSTACK_FILL_WORD	( ( StackType_t ) ( ( ( StackType_t ) ~( StackType_t ) 0 / ( StackType_t ) 0xffU ) * ( StackType_t ) tskSTACK_FILL_BYTE ) )
+
 /* Sometimes the FreeRTOSConfig.h settings only allow a task to be created using
 dynamically allocated RAM, in which case when any task is deleted it is known
 that both the task's stack and TCB need to be freed.  Sometimes the
@@ -100,12 +108,20 @@ changed then the definition of StaticTask_t must also be updated. */
 /* If any of the following are set then task stacks are filled with a known
 value so the high water mark can be determined.  If none of the following are
 set then don't fill the stack so there is no unnecessary dependency on memset. */
-#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
+#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( configUSE_STACK_PROFILER == 1 ) )
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	1
 #else
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	0
 #endif
 
+/* The TCB and stack of a deleted task can only be kept for reuse if tasks can
+be deleted and are allocated dynamically. */
+#if( ( configTASK_RECYCLE_LENGTH > 0 ) && ( INCLUDE_vTaskDelete == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+	#define tskRECYCLE_TASKS	1
+#else
+	#define tskRECYCLE_TASKS	0
+#endif
+
 /*
  * Macros used by vListTask to indicate which state a task is in.
  */
@@ -340,6 +356,27 @@ typedef struct tskTaskControlBlock /* The old naming convention is used to preve
 		int iTaskErrno;
 	#endif
 
+	#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		UBaseType_t uxHeapAccount;	/*< Index into xHeapAccounts[] of the account the task's heap allocations are charged to. */
+	#endif
+
+	#if( configUSE_HEAP_TASK_CACHE == 1 )
+		HeapTaskCache_t xHeapCache;	/*< Small blocks freed by the task and kept by the heap for the task's later allocations. */
+	#endif
+
+	#if( configUSE_ARENAS == 1 )
+		void *pvArena;				/*< The arena attached to the task with vArenaAttachToTask(), which is deleted with the task. */
+	#endif
+
+	#if( ( configUSE_STACK_PROFILER == 1 ) || ( configTASK_RECYCLE_LENGTH > 0 ) )
+		UBaseType_t uxStackDepth;			/*< The size of the stack, in words. */
+	#endif
+
+	#if( configUSE_STACK_PROFILER == 1 )
+		UBaseType_t uxStackMinimumFree;		/*< The fewest words found still holding the fill value at the end of the stack. */
+		UBaseType_t uxStackScanPosition;	/*< How far from the end of the stack the profiler's current pass has got, in words. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -368,6 +405,12 @@ PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been r
 
 #endif
 
+#if( tskRECYCLE_TASKS == 1 )
+
+	PRIVILEGED_DATA static List_t xRecycledTasks;						/*< The TCBs of deleted tasks that are kept, along with their stacks, for xTaskCreate() to reuse.  The item value of each is the depth of the stack. */
+
+#endif
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
 	PRIVILEGED_DATA static List_t xSuspendedTaskList;					/*< Tasks that are currently suspended. */
@@ -411,6 +454,26 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t
 
 #endif
 
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+	/* The heap memory charged to a task.  The account outlives the task if the
+	task is deleted while blocks it allocated are still in use, as the blocks
+	hold the index of the account rather than the task handle. */
+	typedef struct tskHEAP_ACCOUNT
+	{
+		size_t xBytesInUse;
+		size_t xPeakBytesInUse;
+		size_t xQuotaInBytes;
+		uint32_t ulQuotaViolations;
+		TCB_t *pxOwner;			/*< The task the account belongs to, or NULL if the task has been deleted or the account is not in use. */
+		BaseType_t xInUse;
+	} HeapAccount_t;
+
+	/* Account 0 is shared, and is never given to a single task. */
+	PRIVILEGED_DATA static HeapAccount_t xHeapAccounts[ configTASK_HEAP_ACCOUNTS ];
+
+#endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -479,6 +542,37 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters );
 
 #endif
 
+/*
+ * Allocates a TCB and a stack of usStackDepth words for xTaskCreate(), and
+ * returns the TCB, or NULL if either could not be allocated.
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * prvRecycleTCB() keeps the TCB and stack of a task that is being deleted for
+ * reuse, rather than freeing them.  If configTASK_RECYCLE_LENGTH are already
+ * kept then the one kept the longest is freed to make room.  It returns pdTRUE
+ * if the TCB was kept.  prvTakeRecycledTCB() returns a kept TCB whose stack is
+ * usStackDepth words deep, or NULL if there is none.  prvFreeRecycledTCB()
+ * frees a kept TCB and its stack.
+ */
+#if( tskRECYCLE_TASKS == 1 )
+
+	static BaseType_t prvRecycleTCB( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+	static TCB_t *prvTakeRecycledTCB( configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+	static void prvFreeRecycledTCB( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#else
+
+	#define prvRecycleTCB( pxTCB )				( pdFALSE )
+	#define prvTakeRecycledTCB( usStackDepth )	( NULL )
+
+#endif
+
 /*
  * Used only by the idle task.  This checks to see if anything has been placed
  * in the list of tasks waiting to be deleted.  If so the task is cleaned up
@@ -521,12 +615,39 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  * This function determines the 'high water mark' of the task stack by
  * determining how much of the stack remains at the original preset value.
  */
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) && ( configUSE_STACK_PROFILER == 0 ) ) )
 
 	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte ) PRIVILEGED_FUNCTION;
 
 #endif
 
+#if ( configUSE_STACK_PROFILER == 1 )
+
+	/*
+	 * Returns the number of consecutive words, starting at pxStackWord and
+	 * moving away from the end of the stack, that still hold tskSTACK_FILL_WORD.
+	 * No more than uxMaxWords words are read.
+	 */
+	static UBaseType_t prvCountStackFillWords( const StackType_t *pxStackWord, UBaseType_t uxMaxWords ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Continues the stack profiler's current pass over the stack of each task
+	 * in pxList, checking at most uxWordsPerTask words of each.
+	 */
+	static void prvStackProfileList( List_t *pxList, UBaseType_t uxWordsPerTask ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( ( configUSE_STACK_PROFILER == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+
+	/*
+	 * Writes a line to pcWriteBuffer for each task in pxList giving the task's
+	 * stack use, and returns the end of the text written.
+	 */
+	static char *prvListStackUsageWithinSingleList( char *pcWriteBuffer, List_t *pxList ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Return the amount of time, in ticks, that will pass before the kernel will
  * next move a task from the Blocked state to the Running state.
@@ -577,6 +698,22 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+	/*
+	 * Gives a new task a heap account of its own if one is free, otherwise the
+	 * shared account.  Called from a critical section.
+	 */
+	static void prvAssignHeapAccount( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Detaches a task that is being deleted from its heap account, releasing the
+	 * account if nothing the task allocated is still in use.
+	 */
+	static void prvReleaseHeapAccount( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -754,6 +891,67 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 	TCB_t *pxNewTCB;
 	BaseType_t xReturn;
 
+		/* Reuse the TCB and stack of a deleted task if one with a stack of the
+		same depth was kept, which saves freeing and allocating them again. */
+		pxNewTCB = prvTakeRecycledTCB( usStackDepth );
+
+		if( pxNewTCB == NULL )
+		{
+			pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
+
+			#if( tskRECYCLE_TASKS == 1 )
+			{
+				/* None of the kept TCBs has a stack of the wanted depth.  They
+				are left for later tasks unless the allocation failed for want
+				of the memory they hold, in which case they are freed and the
+				allocation is tried again. */
+				if( ( pxNewTCB == NULL ) && ( uxTaskFlushRecycledTasks() > ( UBaseType_t ) 0U ) )
+				{
+					pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* tskRECYCLE_TASKS */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxNewTCB != NULL )
+		{
+			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+			{
+				/* Tasks can be created statically or dynamically, so note this
+				task was created dynamically in case it is later deleted. */
+				pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+			prvAddNewTaskToReadyList( pxNewTCB );
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth )
+	{
+	TCB_t *pxNewTCB;
+
 		/* If the stack grows down then allocate the stack then the TCB so the stack
 		does not grow into the TCB.  Likewise if the stack grows up then allocate
 		the TCB then the stack. */
@@ -762,19 +960,19 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 			/* Allocate space for the TCB.  Where the memory comes from depends on
 			the implementation of the port malloc function and whether or not static
 			allocation is being used. */
-			pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+			pxNewTCB = ( TCB_t * ) poolMALLOC( eTaskPool, sizeof( TCB_t ) );
 
 			if( pxNewTCB != NULL )
 			{
 				/* Allocate space for the stack used by the task being created.
 				The base of the stack memory stored in the TCB so the task can
 				be deleted later if required. */
-				pxNewTCB->pxStack = ( StackType_t * ) pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+				pxNewTCB->pxStack = ( StackType_t * ) poolMALLOC( eStackPool, ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 				if( pxNewTCB->pxStack == NULL )
 				{
 					/* Could not allocate the stack.  Delete the allocated TCB. */
-					vPortFree( pxNewTCB );
+					poolFREE( eTaskPool, pxNewTCB );
 					pxNewTCB = NULL;
 				}
 			}
@@ -784,12 +982,12 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		StackType_t *pxStack;
 
 			/* Allocate space for the stack used by the task being created. */
-			pxStack = pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+			pxStack = poolMALLOC( eStackPool, ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
 
 			if( pxStack != NULL )
 			{
 				/* Allocate space for the TCB. */
-				pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+				pxNewTCB = ( TCB_t * ) poolMALLOC( eTaskPool, sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
 
 				if( pxNewTCB != NULL )
 				{
@@ -800,7 +998,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 				{
 					/* The stack cannot be used as the TCB was not created.  Free
 					it again. */
-					vPortFree( pxStack );
+					poolFREE( eStackPool, pxStack );
 				}
 			}
 			else
@@ -810,26 +1008,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		}
 		#endif /* portSTACK_GROWTH */
 
-		if( pxNewTCB != NULL )
-		{
-			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
-			{
-				/* Tasks can be created statically or dynamically, so note this
-				task was created dynamically in case it is later deleted. */
-				pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
-			}
-			#endif /* configSUPPORT_STATIC_ALLOCATION */
-
-			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
-			prvAddNewTaskToReadyList( pxNewTCB );
-			xReturn = pdPASS;
-		}
-		else
-		{
-			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
-		}
-
-		return xReturn;
+		return pxNewTCB;
 	}
 
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
@@ -1001,6 +1180,31 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if ( configUSE_HEAP_TASK_CACHE == 1 )
+	{
+		( void ) memset( ( void * ) &( pxNewTCB->xHeapCache ), 0x00, sizeof( HeapTaskCache_t ) );
+	}
+	#endif
+
+	#if ( configUSE_ARENAS == 1 )
+	{
+		pxNewTCB->pvArena = NULL;
+	}
+	#endif
+
+	#if ( ( configUSE_STACK_PROFILER == 1 ) || ( configTASK_RECYCLE_LENGTH > 0 ) )
+	{
+		pxNewTCB->uxStackDepth = ( UBaseType_t ) ulStackDepth;
+	}
+	#endif
+
+	#if ( configUSE_STACK_PROFILER == 1 )
+	{
+		pxNewTCB->uxStackMinimumFree = ( UBaseType_t ) ulStackDepth;
+		pxNewTCB->uxStackScanPosition = ( UBaseType_t ) 0U;
+	}
+	#endif
+
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
 	{
 		/* Initialise this task's Newlib reent structure. */
@@ -1022,6 +1226,18 @@ UBaseType_t x;
 	{
 		pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged );
 	}
+	#elif( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+	{
+		#if( portSTACK_GROWTH < 0 )
+		{
+			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters );
+		}
+		#else /* portSTACK_GROWTH */
+		{
+			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters );
+		}
+		#endif /* portSTACK_GROWTH */
+	}
 	#else /* portUSING_MPU_WRAPPERS */
 	{
 		pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters );
@@ -1096,6 +1312,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			pxNewTCB->uxTCBNumber = uxTaskNumber;
 		}
 		#endif /* configUSE_TRACE_FACILITY */
+
+		#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		{
+			prvAssignHeapAccount( pxNewTCB );
+		}
+		#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+
 		traceTASK_CREATE( pxNewTCB );
 
 		prvAddTaskToReadyList( pxNewTCB );
@@ -2076,6 +2299,15 @@ void vTaskSuspendAll( void )
 	post in the FreeRTOS support forum before reporting this as a bug! -
 	http://goo.gl/wu4acr */
 	++uxSchedulerSuspended;
+
+	if( uxSchedulerSuspended == ( UBaseType_t ) 1U )
+	{
+		traceTASK_SUSPEND_ALL();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
 }
 /*----------------------------------------------------------*/
 
@@ -2162,6 +2394,8 @@ BaseType_t xAlreadyYielded = pdFALSE;
 
 		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 		{
+			traceTASK_RESUME_ALL();
+
 			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
 			{
 				/* Move any readied tasks from the pending list into the
@@ -2744,6 +2978,15 @@ BaseType_t xSwitchRequired = pdFALSE;
 			}
 		}
 
+		/* Execute the callbacks of any fast timers that expire on this tick.  A
+		task unblocked by a callback sets xYieldPending, which is checked
+		below. */
+		#if ( ( configUSE_TIMERS == 1 ) && ( configUSE_FAST_TIMERS == 1 ) )
+		{
+			vTimerProcessFastTimers( xConstTickCount );
+		}
+		#endif /* configUSE_FAST_TIMERS */
+
 		/* Tasks of equal priority to the currently running task will share
 		processing time (time slice) if preemption is on, and the application
 		writer has not explicitly turned time slicing off. */
@@ -3146,6 +3389,59 @@ TCB_t *pxUnblockedTCB;
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+{
+TCB_t *pxUnblockedTCB;
+BaseType_t xReturn;
+
+	/* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
+	called from a critical section within an ISR.  It is used by the event
+	flags implementation when an interrupt sets bits directly, which is only
+	done when no task can be accessing the event list. */
+
+	/* Store the new item value in the event list. */
+	listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+	pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	configASSERT( pxUnblockedTCB );
+	( void ) uxListRemove( pxEventListItem );
+
+	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+	{
+		( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+		prvAddTaskToReadyList( pxUnblockedTCB );
+	}
+	else
+	{
+		/* The delayed and ready lists cannot be accessed, so hold this task
+		pending until the scheduler is resumed. */
+		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+	}
+
+	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	{
+		/* The unblocked task has a priority above that of the interrupted
+		task.  Mark that a yield is pending in case the user is not using the
+		"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
+		xReturn = pdTRUE;
+		xYieldPending = pdTRUE;
+	}
+	else
+	{
+		xReturn = pdFALSE;
+	}
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+	{
+		/* See the comment in xTaskRemoveFromEventList(). */
+		prvResetNextTaskUnblockTime();
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
 	configASSERT( pxTimeOut );
@@ -3515,6 +3811,12 @@ UBaseType_t uxPriority;
 	}
 	#endif /* INCLUDE_vTaskDelete */
 
+	#if ( tskRECYCLE_TASKS == 1 )
+	{
+		vListInitialise( &xRecycledTasks );
+	}
+	#endif /* tskRECYCLE_TASKS */
+
 	#if ( INCLUDE_vTaskSuspend == 1 )
 	{
 		vListInitialise( &xSuspendedTaskList );
@@ -3535,26 +3837,60 @@ static void prvCheckTasksWaitingTermination( void )
 
 	#if ( INCLUDE_vTaskDelete == 1 )
 	{
-		TCB_t *pxTCB;
+		/* Clean up every task that is waiting, however many there are.  Other
+		tasks can also call uxTaskReclaimDeletedTasks(), in case the idle task
+		does not get to run. */
+		( void ) uxTaskReclaimDeletedTasks( ~( UBaseType_t ) 0U );
+	}
+	#endif /* INCLUDE_vTaskDelete */
+}
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelete == 1 )
+
+	UBaseType_t uxTaskReclaimDeletedTasks( UBaseType_t uxMaxTasks )
+	{
+	TCB_t *pxBatch[ configTASK_RECLAIM_BATCH_SIZE ];
+	UBaseType_t uxReclaimed = ( UBaseType_t ) 0U, uxInBatch, ux;
 
 		/* uxDeletedTasksWaitingCleanUp is used to prevent taskENTER_CRITICAL()
-		being called too often in the idle task. */
-		while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
+		being called when there is nothing to do. */
+		while( ( uxReclaimed < uxMaxTasks ) && ( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U ) )
 		{
+			uxInBatch = ( UBaseType_t ) 0U;
+
+			/* Take up to a batch of tasks from the termination list in one
+			critical section.  uxDeletedTasksWaitingCleanUp is checked again
+			as another task may have taken the tasks first. */
 			taskENTER_CRITICAL();
 			{
-				pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				--uxCurrentNumberOfTasks;
-				--uxDeletedTasksWaitingCleanUp;
+				while( ( uxInBatch < ( UBaseType_t ) configTASK_RECLAIM_BATCH_SIZE ) &&
+					   ( ( uxReclaimed + uxInBatch ) < uxMaxTasks ) &&
+					   ( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U ) )
+				{
+					pxBatch[ uxInBatch ] = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxBatch[ uxInBatch ]->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+					uxInBatch++;
+				}
 			}
 			taskEXIT_CRITICAL();
 
-			prvDeleteTCB( pxTCB );
+			/* The tasks are no longer referenced by the kernel, so their
+			memory can be freed outside of the critical section. */
+			for( ux = ( UBaseType_t ) 0U; ux < uxInBatch; ux++ )
+			{
+				prvDeleteTCB( pxBatch[ ux ] );
+			}
+
+			uxReclaimed += uxInBatch;
 		}
+
+		return uxReclaimed;
 	}
-	#endif /* INCLUDE_vTaskDelete */
-}
+
+#endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TRACE_FACILITY == 1 )
@@ -3686,7 +4022,7 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) && ( configUSE_STACK_PROFILER == 0 ) ) )
 
 	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
 	{
@@ -3703,7 +4039,7 @@ static void prvCheckTasksWaitingTermination( void )
 		return ( configSTACK_DEPTH_TYPE ) ulCount;
 	}
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) ) */
+#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) && ( configUSE_STACK_PROFILER == 0 ) ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
@@ -3726,7 +4062,17 @@ static void prvCheckTasksWaitingTermination( void )
 		}
 		#endif
 
-		uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+		#if( configUSE_STACK_PROFILER == 1 )
+		{
+			/* The size of the stack is known, so the faster word at a time
+			check can be used. */
+			uxReturn = prvCountStackFillWords( ( const StackType_t * ) pucEndOfStack, pxTCB->uxStackDepth ); /*lint !e9079 !e9087 The end of the stack is a stack word. */
+		}
+		#else
+		{
+			uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+		}
+		#endif
 
 		return uxReturn;
 	}
@@ -3734,16 +4080,264 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_uxTaskGetStackHighWaterMark */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskDelete == 1 )
+#if ( configUSE_STACK_PROFILER == 1 )
 
-	static void prvDeleteTCB( TCB_t *pxTCB )
+	static UBaseType_t prvCountStackFillWords( const StackType_t *pxStackWord, UBaseType_t uxMaxWords )
 	{
-		/* This call is required specifically for the TriCore port.  It must be
-		above the vPortFree() calls.  The call is also used by ports/demos that
-		want to allocate and clean RAM statically. */
-		portCLEAN_UP_TCB( pxTCB );
+	const StackType_t xFillWord = tskSTACK_FILL_WORD;
+	UBaseType_t uxCount = ( UBaseType_t ) 0U;
 
-		/* Free up the memory allocated by the scheduler for the task.  It is up
+		/* Check four words at a time while at least four remain.  The four
+		comparisons are combined without branches, which compilers can turn
+		into wide loads and vector compares. */
+		while( ( ( uxMaxWords - uxCount ) >= ( UBaseType_t ) 4U ) &&
+			   ( ( ( pxStackWord[ 0 ] ^ xFillWord ) |
+				   ( pxStackWord[ -portSTACK_GROWTH ] ^ xFillWord ) |
+				   ( pxStackWord[ -2 * portSTACK_GROWTH ] ^ xFillWord ) |
+				   ( pxStackWord[ -3 * portSTACK_GROWTH ] ^ xFillWord ) ) == ( StackType_t ) 0 ) )
+		{
+			pxStackWord -= 4 * portSTACK_GROWTH;
+			uxCount += ( UBaseType_t ) 4U;
+		}
+
+		/* Then find the used word within the last group, or check the
+		remaining words. */
+		while( ( uxCount < uxMaxWords ) && ( *pxStackWord == xFillWord ) )
+		{
+			pxStackWord -= portSTACK_GROWTH;
+			uxCount++;
+		}
+
+		return uxCount;
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_PROFILER == 1 )
+
+	static void prvStackProfileList( List_t *pxList, UBaseType_t uxWordsPerTask )
+	{
+	const ListItem_t *pxListItem;
+	const ListItem_t * const pxListEnd = listGET_END_MARKER( pxList );
+	TCB_t *pxTCB;
+	const StackType_t *pxStackWord;
+	UBaseType_t uxWordsToCheck, uxFillWords;
+
+		/* The list is walked without listGET_OWNER_OF_NEXT_ENTRY() so the
+		round robin position of the ready lists is not disturbed. */
+		pxListItem = listGET_HEAD_ENTRY( pxList );
+
+		while( pxListItem != pxListEnd )
+		{
+			pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			/* A word that has been used never holds the fill value again, so
+			this pass only has to check as far as the lowest point found by
+			earlier passes. */
+			uxWordsToCheck = pxTCB->uxStackMinimumFree - pxTCB->uxStackScanPosition;
+
+			if( uxWordsToCheck > uxWordsPerTask )
+			{
+				uxWordsToCheck = uxWordsPerTask;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			#if( portSTACK_GROWTH < 0 )
+			{
+				pxStackWord = pxTCB->pxStack + pxTCB->uxStackScanPosition;
+			}
+			#else
+			{
+				pxStackWord = pxTCB->pxEndOfStack - pxTCB->uxStackScanPosition;
+			}
+			#endif
+
+			uxFillWords = prvCountStackFillWords( pxStackWord, uxWordsToCheck );
+			pxTCB->uxStackScanPosition += uxFillWords;
+
+			if( uxFillWords < uxWordsToCheck )
+			{
+				/* The task has used its stack further than before.  Record
+				the new high water mark and start the next pass. */
+				pxTCB->uxStackMinimumFree = pxTCB->uxStackScanPosition;
+				pxTCB->uxStackScanPosition = ( UBaseType_t ) 0U;
+			}
+			else if( pxTCB->uxStackScanPosition == pxTCB->uxStackMinimumFree )
+			{
+				/* The pass reached the previous high water mark, which is
+				therefore unchanged.  Start the next pass. */
+				pxTCB->uxStackScanPosition = ( UBaseType_t ) 0U;
+			}
+			else
+			{
+				/* The pass continues from here next time. */
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxListItem = listGET_NEXT( pxListItem );
+		}
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_PROFILER == 1 )
+
+	void vTaskStackProfilerStep( UBaseType_t uxWordsPerTask )
+	{
+	UBaseType_t uxQueue = configMAX_PRIORITIES;
+
+		/* Tasks that are waiting to be cleaned up by the idle task are not
+		checked, as their stacks may be freed at any time. */
+		vTaskSuspendAll();
+		{
+			do
+			{
+				uxQueue--;
+				prvStackProfileList( &( pxReadyTasksLists[ uxQueue ] ), uxWordsPerTask );
+
+			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+			prvStackProfileList( ( List_t * ) pxDelayedTaskList, uxWordsPerTask );
+			prvStackProfileList( ( List_t * ) pxOverflowDelayedTaskList, uxWordsPerTask );
+
+			#if( INCLUDE_vTaskSuspend == 1 )
+			{
+				prvStackProfileList( &xSuspendedTaskList, uxWordsPerTask );
+			}
+			#endif
+		}
+		( void ) xTaskResumeAll();
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_PROFILER == 1 )
+
+	UBaseType_t uxTaskGetStackPeakUsage( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		return pxTCB->uxStackDepth - pxTCB->uxStackMinimumFree;
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_STACK_PROFILER == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+
+	static char *prvListStackUsageWithinSingleList( char *pcWriteBuffer, List_t *pxList )
+	{
+	const ListItem_t *pxListItem;
+	const ListItem_t * const pxListEnd = listGET_END_MARKER( pxList );
+	const TCB_t *pxTCB;
+
+		pxListItem = listGET_HEAD_ENTRY( pxList );
+
+		while( pxListItem != pxListEnd )
+		{
+			pxTCB = ( const TCB_t * ) listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			/* The columns are name, stack depth, peak use and fewest free
+			words, all in words. */
+			sprintf( pcWriteBuffer, "%-*s\t%u\t%u\t%u\r\n", ( int ) ( configMAX_TASK_NAME_LEN - 1 ), pxTCB->pcTaskName, ( unsigned int ) pxTCB->uxStackDepth, ( unsigned int ) ( pxTCB->uxStackDepth - pxTCB->uxStackMinimumFree ), ( unsigned int ) pxTCB->uxStackMinimumFree ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+			pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+
+			pxListItem = listGET_NEXT( pxListItem );
+		}
+
+		return pcWriteBuffer;
+	}
+
+#endif /* ( configUSE_STACK_PROFILER == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_STACK_PROFILER == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+
+	void vTaskListStackUsage( char *pcWriteBuffer )
+	{
+	UBaseType_t uxQueue = configMAX_PRIORITIES;
+
+		/*
+		 * PLEASE NOTE:
+		 *
+		 * This function is provided for convenience only, in the same way as
+		 * vTaskList().  It depends on sprintf(), and production systems should
+		 * call uxTaskGetStackPeakUsage() directly to get the raw data instead.
+		 */
+
+		/* Make sure the write buffer does not contain a string. */
+		*pcWriteBuffer = ( char ) 0x00;
+
+		vTaskSuspendAll();
+		{
+			do
+			{
+				uxQueue--;
+				pcWriteBuffer = prvListStackUsageWithinSingleList( pcWriteBuffer, &( pxReadyTasksLists[ uxQueue ] ) );
+
+			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+			pcWriteBuffer = prvListStackUsageWithinSingleList( pcWriteBuffer, ( List_t * ) pxDelayedTaskList );
+			pcWriteBuffer = prvListStackUsageWithinSingleList( pcWriteBuffer, ( List_t * ) pxOverflowDelayedTaskList );
+
+			#if( INCLUDE_vTaskSuspend == 1 )
+			{
+				pcWriteBuffer = prvListStackUsageWithinSingleList( pcWriteBuffer, &xSuspendedTaskList );
+			}
+			#endif
+		}
+		( void ) xTaskResumeAll();
+	}
+
+#endif /* ( configUSE_STACK_PROFILER == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelete == 1 )
+
+	static void prvDeleteTCB( TCB_t *pxTCB )
+	{
+		/* This call is required specifically for the TriCore port.  It must be
+		above the vPortFree() calls.  The call is also used by ports/demos that
+		want to allocate and clean RAM statically. */
+		portCLEAN_UP_TCB( pxTCB );
+
+		/* Release everything the task allocated from its arena in one go. */
+		#if( configUSE_ARENAS == 1 )
+		{
+			if( pxTCB->pvArena != NULL )
+			{
+				vArenaDelete( ( ArenaHandle_t ) pxTCB->pvArena );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_ARENAS */
+
+		/* Return the blocks held in the task's heap cache before its heap
+		account is released, so the account is not left waiting for them. */
+		#if( configUSE_HEAP_TASK_CACHE == 1 )
+		{
+			vPortFreeTaskHeapCache( &( pxTCB->xHeapCache ) );
+		}
+		#endif /* configUSE_HEAP_TASK_CACHE */
+
+		#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+		{
+			prvReleaseHeapAccount( pxTCB );
+		}
+		#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+
+		/* Free up the memory allocated by the scheduler for the task.  It is up
 		to the task to free any memory allocated at the application level. */
 		#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		{
@@ -3754,9 +4348,16 @@ static void prvCheckTasksWaitingTermination( void )
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
 		{
 			/* The task can only have been allocated dynamically - free both
-			the stack and TCB. */
-			vPortFree( pxTCB->pxStack );
-			vPortFree( pxTCB );
+			the stack and TCB, unless they are kept for reuse. */
+			if( prvRecycleTCB( pxTCB ) == pdFALSE )
+			{
+				poolFREE( eStackPool, pxTCB->pxStack );
+				poolFREE( eTaskPool, pxTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 		#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
 		{
@@ -3766,15 +4367,22 @@ static void prvCheckTasksWaitingTermination( void )
 			if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
 			{
 				/* Both the stack and TCB were allocated dynamically, so both
-				must be freed. */
-				vPortFree( pxTCB->pxStack );
-				vPortFree( pxTCB );
+				must be freed, unless they are kept for reuse. */
+				if( prvRecycleTCB( pxTCB ) == pdFALSE )
+				{
+					poolFREE( eStackPool, pxTCB->pxStack );
+					poolFREE( eTaskPool, pxTCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 			else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
 			{
 				/* Only the stack was statically allocated, so the TCB is the
 				only memory that must be freed. */
-				vPortFree( pxTCB );
+				poolFREE( eTaskPool, pxTCB );
 			}
 			else
 			{
@@ -3790,6 +4398,145 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
+#if ( tskRECYCLE_TASKS == 1 )
+
+	static BaseType_t prvRecycleTCB( TCB_t *pxTCB )
+	{
+	TCB_t *pxOldestTCB = NULL;
+
+		taskENTER_CRITICAL();
+		{
+			/* Make room by dropping the TCB that has been kept the longest, so
+			TCBs with stacks of depths that are no longer being created do not
+			stay kept for ever. */
+			if( listCURRENT_LIST_LENGTH( &xRecycledTasks ) >= ( UBaseType_t ) configTASK_RECYCLE_LENGTH )
+			{
+				pxOldestTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xRecycledTasks ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				( void ) uxListRemove( &( pxOldestTCB->xStateListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* The task is no longer in any list, so its state list item can
+			hold it in the recycled list. */
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), ( TickType_t ) pxTCB->uxStackDepth );
+			vListInsertEnd( &xRecycledTasks, &( pxTCB->xStateListItem ) );
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxOldestTCB != NULL )
+		{
+			prvFreeRecycledTCB( pxOldestTCB );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pdTRUE;
+	}
+
+#endif /* tskRECYCLE_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( tskRECYCLE_TASKS == 1 )
+
+	static TCB_t *prvTakeRecycledTCB( configSTACK_DEPTH_TYPE usStackDepth )
+	{
+	TCB_t *pxTCB = NULL;
+	const ListItem_t *pxListItem;
+
+		taskENTER_CRITICAL();
+		{
+			/* The list is not initialised until the first task is created, but
+			until then its length reads as zero. */
+			if( listCURRENT_LIST_LENGTH( &xRecycledTasks ) > ( UBaseType_t ) 0U )
+			{
+				pxListItem = listGET_HEAD_ENTRY( &xRecycledTasks );
+
+				while( ( pxTCB == NULL ) && ( pxListItem != listGET_END_MARKER( &xRecycledTasks ) ) )
+				{
+					if( listGET_LIST_ITEM_VALUE( pxListItem ) == ( TickType_t ) usStackDepth )
+					{
+						pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					}
+					else
+					{
+						pxListItem = listGET_NEXT( pxListItem );
+					}
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return pxTCB;
+	}
+
+#endif /* tskRECYCLE_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( tskRECYCLE_TASKS == 1 )
+
+	static void prvFreeRecycledTCB( TCB_t *pxTCB )
+	{
+		poolFREE( eStackPool, pxTCB->pxStack );
+		poolFREE( eTaskPool, pxTCB );
+	}
+
+#endif /* tskRECYCLE_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( tskRECYCLE_TASKS == 1 )
+
+	UBaseType_t uxTaskFlushRecycledTasks( void )
+	{
+	TCB_t *pxTCB;
+	UBaseType_t uxFreed = ( UBaseType_t ) 0U;
+
+		do
+		{
+			pxTCB = NULL;
+
+			/* Take the kept TCBs one at a time, and free each outside of the
+			critical section. */
+			taskENTER_CRITICAL();
+			{
+				if( listCURRENT_LIST_LENGTH( &xRecycledTasks ) > ( UBaseType_t ) 0U )
+				{
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xRecycledTasks ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( pxTCB != NULL )
+			{
+				prvFreeRecycledTCB( pxTCB );
+				uxFreed++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		} while( pxTCB != NULL );
+
+		return uxFreed;
+	}
+
+#endif /* tskRECYCLE_TASKS */
+/*-----------------------------------------------------------*/
+
 static void prvResetNextTaskUnblockTime( void )
 {
 TCB_t *pxTCB;
@@ -4474,6 +5221,267 @@ TickType_t uxReturn;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TASK_HEAP_ACCOUNTING == 1 )
+
+	static void prvAssignHeapAccount( TCB_t *pxNewTCB )
+	{
+	UBaseType_t uxAccount;
+
+		pxNewTCB->uxHeapAccount = 0;
+
+		for( uxAccount = 1; uxAccount < ( UBaseType_t ) configTASK_HEAP_ACCOUNTS; uxAccount++ )
+		{
+			if( xHeapAccounts[ uxAccount ].xInUse == pdFALSE )
+			{
+				xHeapAccounts[ uxAccount ].xBytesInUse = 0;
+				xHeapAccounts[ uxAccount ].xPeakBytesInUse = 0;
+				xHeapAccounts[ uxAccount ].xQuotaInBytes = 0;
+				xHeapAccounts[ uxAccount ].ulQuotaViolations = 0;
+				xHeapAccounts[ uxAccount ].pxOwner = pxNewTCB;
+				xHeapAccounts[ uxAccount ].xInUse = pdTRUE;
+				pxNewTCB->uxHeapAccount = uxAccount;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvReleaseHeapAccount( TCB_t *pxTCB )
+	{
+	HeapAccount_t *pxAccount = &( xHeapAccounts[ pxTCB->uxHeapAccount ] );
+
+		/* The heap updates the accounts with the scheduler suspended, so a
+		critical section is enough to keep it out. */
+		taskENTER_CRITICAL();
+		{
+			if( pxTCB->uxHeapAccount != ( UBaseType_t ) 0 )
+			{
+				pxAccount->pxOwner = NULL;
+
+				if( pxAccount->xBytesInUse == ( size_t ) 0 )
+				{
+					pxAccount->xInUse = pdFALSE;
+				}
+				else
+				{
+					/* vTaskHeapCredit() will release the account when the last
+					block is freed. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxTaskHeapCheckQuota( size_t xWantedSize )
+	{
+	UBaseType_t uxReturn;
+	HeapAccount_t *pxAccount;
+
+		/* Allocations made before the scheduler is started are charged to the
+		shared account, even though pxCurrentTCB may already be set. */
+		if( xSchedulerRunning == pdFALSE )
+		{
+			uxReturn = 0;
+		}
+		else
+		{
+			uxReturn = pxCurrentTCB->uxHeapAccount;
+			pxAccount = &( xHeapAccounts[ uxReturn ] );
+
+			if( pxAccount->xQuotaInBytes != ( size_t ) 0 )
+			{
+				if( ( pxAccount->xBytesInUse >= pxAccount->xQuotaInBytes ) || ( xWantedSize > ( pxAccount->xQuotaInBytes - pxAccount->xBytesInUse ) ) )
+				{
+					( pxAccount->ulQuotaViolations )++;
+					uxReturn = taskHEAP_QUOTA_EXCEEDED;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return uxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxTaskGetHeapAccount( void )
+	{
+	UBaseType_t uxReturn;
+
+		if( xSchedulerRunning == pdFALSE )
+		{
+			uxReturn = 0;
+		}
+		else
+		{
+			uxReturn = pxCurrentTCB->uxHeapAccount;
+		}
+
+		return uxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskHeapCharge( UBaseType_t uxHeapAccount, size_t xBlockSize )
+	{
+	HeapAccount_t *pxAccount;
+
+		configASSERT( uxHeapAccount < ( UBaseType_t ) configTASK_HEAP_ACCOUNTS );
+		pxAccount = &( xHeapAccounts[ uxHeapAccount ] );
+
+		pxAccount->xBytesInUse += xBlockSize;
+
+		if( pxAccount->xBytesInUse > pxAccount->xPeakBytesInUse )
+		{
+			pxAccount->xPeakBytesInUse = pxAccount->xBytesInUse;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskHeapCredit( UBaseType_t uxHeapAccount, size_t xBlockSize )
+	{
+	HeapAccount_t *pxAccount;
+
+		configASSERT( uxHeapAccount < ( UBaseType_t ) configTASK_HEAP_ACCOUNTS );
+		pxAccount = &( xHeapAccounts[ uxHeapAccount ] );
+		configASSERT( pxAccount->xBytesInUse >= xBlockSize );
+
+		pxAccount->xBytesInUse -= xBlockSize;
+
+		/* Release the account of a deleted task once the last block it
+		allocated has been freed. */
+		if( ( uxHeapAccount != ( UBaseType_t ) 0 ) && ( pxAccount->pxOwner == NULL ) && ( pxAccount->xBytesInUse == ( size_t ) 0 ) )
+		{
+			pxAccount->xInUse = pdFALSE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskGetHeapUsage( TaskHandle_t xTask, TaskHeapUsage_t *pxHeapUsage )
+	{
+	TCB_t *pxTCB;
+	HeapAccount_t *pxAccount;
+
+		configASSERT( pxHeapUsage );
+
+		vTaskSuspendAll();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxAccount = &( xHeapAccounts[ pxTCB->uxHeapAccount ] );
+
+			pxHeapUsage->xBytesInUse = pxAccount->xBytesInUse;
+			pxHeapUsage->xPeakBytesInUse = pxAccount->xPeakBytesInUse;
+			pxHeapUsage->xQuotaInBytes = pxAccount->xQuotaInBytes;
+			pxHeapUsage->ulQuotaViolations = pxAccount->ulQuotaViolations;
+			pxHeapUsage->uxHeapAccount = pxTCB->uxHeapAccount;
+		}
+		( void ) xTaskResumeAll();
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskSetHeapQuota( TaskHandle_t xTask, size_t xQuotaInBytes )
+	{
+	TCB_t *pxTCB;
+	BaseType_t xReturn;
+
+		vTaskSuspendAll();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			if( pxTCB->uxHeapAccount != ( UBaseType_t ) 0 )
+			{
+				xHeapAccounts[ pxTCB->uxHeapAccount ].xQuotaInBytes = xQuotaInBytes;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				xReturn = pdFAIL;
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_HEAP_ACCOUNTING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HEAP_TASK_CACHE == 1 )
+
+	HeapTaskCache_t *pxTaskGetHeapCache( void )
+	{
+	HeapTaskCache_t *pxReturn;
+
+		/* Blocks freed before the scheduler is started go straight back to the
+		heap, as they are not freed by a task. */
+		if( xSchedulerRunning == pdFALSE )
+		{
+			pxReturn = NULL;
+		}
+		else
+		{
+			pxReturn = &( pxCurrentTCB->xHeapCache );
+		}
+
+		return pxReturn;
+	}
+
+#endif /* configUSE_HEAP_TASK_CACHE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ARENAS == 1 )
+
+	void *pvTaskSetArenaPointer( TaskHandle_t xTask, void *pvArena )
+	{
+	TCB_t *pxTCB;
+	void *pvPreviousArena;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pvPreviousArena = pxTCB->pvArena;
+			pxTCB->pvArena = pvArena;
+		}
+		taskEXIT_CRITICAL();
+
+		return pvPreviousArena;
+	}
+	/*-----------------------------------------------------------*/
+
+	void *pvTaskGetArenaPointer( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+
+		pxTCB = prvGetTCBFromHandle( xTask );
+		return pxTCB->pvArena;
+	}
+
+#endif /* configUSE_ARENAS */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
 	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
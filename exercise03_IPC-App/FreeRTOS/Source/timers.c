@@ -37,6 +37,7 @@ task.h is included from an application file. */
 #include "task.h"
 #include "queue.h"
 #include "timers.h"
+#include "object_pools.h"
 
 #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 0 )
 	#error configUSE_TIMERS must be set to 1 to make the xTimerPendFunctionCall() function available.
@@ -64,6 +65,45 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 	#define configTIMER_SERVICE_TASK_NAME "Tmr Svc"
 #endif
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* Dimensions of the timing wheel.  Each level has tmrWHEEL_SLOTS slots, and
+	a slot on one level spans tmrWHEEL_SLOTS times as many ticks as a slot on
+	the level below, so level 0 slots span a single tick.  Four bits per level
+	divide evenly into any TickType_t width, so the top level exactly covers the
+	whole range of the tick count. */
+	#define tmrWHEEL_BITS_PER_LEVEL		( 4U )
+	#define tmrWHEEL_SLOTS				( ( UBaseType_t ) 1U << tmrWHEEL_BITS_PER_LEVEL )
+	#define tmrWHEEL_SLOT_MASK			( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+	#define tmrWHEEL_LEVELS				( ( sizeof( TickType_t ) * 8U ) / tmrWHEEL_BITS_PER_LEVEL )
+
+	/* Timers in the wheel are placed relative to xWheelTime, which never runs
+	ahead of the tick count, so comparing times relative to xWheelTime remains
+	valid when the tick count overflows. */
+	#define tmrTIME_HAS_BEEN_REACHED( xTime, xTimeNow ) ( ( ( TickType_t ) ( ( xTime ) - xWheelTime ) ) <= ( ( TickType_t ) ( ( xTimeNow ) - xWheelTime ) ) )
+
+#else
+
+	/* The active timer lists are switched when the tick count overflows, so
+	times within the current list can be compared directly. */
+	#define tmrTIME_HAS_BEEN_REACHED( xTime, xTimeNow ) ( ( xTime ) <= ( xTimeNow ) )
+
+#endif /* configUSE_TIMER_WHEEL */
+
+/* The time base used to measure how long fast timer callbacks take to execute.
+Fast timer callbacks execute from the tick interrupt, during which the tick
+count does not change, so a counter that runs faster than the tick is needed -
+either a cycle counter provided by the port or the run time stats counter. */
+#ifndef tmrGET_CALLBACK_TIMESTAMP
+	#if defined( portGET_CYCLE_COUNT )
+		#define tmrGET_CALLBACK_TIMESTAMP()		portGET_CYCLE_COUNT()
+	#elif( configGENERATE_RUN_TIME_STATS == 1 )
+		#define tmrGET_CALLBACK_TIMESTAMP()		( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+	#elif( configUSE_FAST_TIMERS == 1 )
+		#error configUSE_FAST_TIMERS requires a time base for ulTimerGetMaxCallbackTime().  Define portGET_CYCLE_COUNT() or tmrGET_CALLBACK_TIMESTAMP(), or set configGENERATE_RUN_TIME_STATS to 1.
+	#endif
+#endif /* tmrGET_CALLBACK_TIMESTAMP */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -77,6 +117,15 @@ typedef struct tmrTimerControl /* The old naming convention is used to prevent b
 		UBaseType_t			uxTimerNumber;		/*<< An ID assigned by trace tools such as FreeRTOS+Trace */
 	#endif
 
+	#if( configUSE_TIMER_SLACK == 1 )
+		TickType_t			xSlackInTicks;		/*<< How many ticks after its expiry time the timer may be processed, so it can share a wakeup of the timer service task with other timers. */
+	#endif
+
+	#if( configUSE_FAST_TIMERS == 1 )
+		uint32_t			ulMaxCallbackTime;	/*<< The longest time the callback of a fast timer has taken to execute. */
+		uint8_t				ucFastTimer;		/*<< Set to pdTRUE if commands update the timer directly and its callback executes from the tick interrupt, rather than from the timer service task. */
+	#endif
+
 	#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 		uint8_t 			ucStaticallyAllocated; /*<< Set to pdTRUE if the timer was created statically so no attempt is made to free the memory again if the timer is later deleted. */
 	#endif
@@ -130,11 +179,77 @@ time order, with the nearest expiry time at the front of the list.  Only the
 timer service task is allowed to access these lists. 
 xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
 breaks some kernel aware debuggers, and debuggers that reply on removing the
-static qualifier. */
+static qualifier.
+If configUSE_TIMER_WHEEL is 1 the active timers are held in xTimerWheel
+instead, and pxCurrentTimerList only references timers that have already been
+moved out of the wheel because they expired, but have not yet been processed.
+Those timers are still in expire time order, and the overflow list is not
+needed. */
 PRIVILEGED_DATA static List_t xActiveTimerList1;
-PRIVILEGED_DATA static List_t xActiveTimerList2;
 PRIVILEGED_DATA static List_t *pxCurrentTimerList;
-PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#if( configUSE_TIMER_WHEEL == 0 )
+	PRIVILEGED_DATA static List_t xActiveTimerList2;
+	PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#endif
+
+#if( configUSE_TIMER_WHEEL == 1 )
+	/* The hierarchical timing wheel.  A timer that expires less than
+	tmrWHEEL_SLOTS ticks after xWheelTime is held in the level 0 slot indexed by
+	the low bits of its expiry time.  A timer that expires further in the
+	future is held on the lowest level whose slots span its distance from
+	xWheelTime, in the slot indexed by the matching bits of its expiry time, and
+	is cascaded down a level when xWheelTime reaches the start of that slot.
+	The slots are unordered, so a timer is added or removed in constant time.
+	Timers still expire on exactly the same tick as with the sorted lists, but
+	timers that expire on the same tick are not necessarily processed in the
+	order in which they were started.  The wheel costs tmrWHEEL_LEVELS *
+	tmrWHEEL_SLOTS list headers of RAM - 128 when TickType_t is 32 bits. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+
+	/* Bit n of usOccupiedSlots[ x ] is set when slot n on level x holds at
+	least one timer, so empty slots can be skipped without being inspected. */
+	PRIVILEGED_DATA static uint16_t usOccupiedSlots[ tmrWHEEL_LEVELS ] = { 0U };
+
+	/* The time up to which the wheel has been processed, and the number of
+	timers held in the wheel (excluding those already moved to
+	pxCurrentTimerList). */
+	PRIVILEGED_DATA static TickType_t xWheelTime = ( TickType_t ) 0U;
+	PRIVILEGED_DATA static UBaseType_t uxTimersInWheel = ( UBaseType_t ) 0U;
+
+	#if( configUSE_TIMER_SLACK == 1 )
+		/* The earliest time by which a timer in each occupied slot must
+		expire, being its expiry time plus its slack.  Removing a timer does
+		not update the deadline of its slot, which at worst wakes the timer
+		service task early, and the deadline is set afresh once the slot has
+		emptied. */
+		PRIVILEGED_DATA static TickType_t xSlotDeadlines[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+	#endif
+#endif
+
+#if( configUSE_TIMER_SLACK == 1 )
+	/* Counts reported by vTimerGetCoalescingStats().  xTimerTaskWoke is set
+	each time the timer service task unblocks, and xLastExpiryTime is the expiry
+	time of the last timer processed, so the timers processed with different
+	expiry times in one wakeup can be counted. */
+	PRIVILEGED_DATA static uint32_t ulTimerTaskWakeups = 0UL;
+	PRIVILEGED_DATA static uint32_t ulTimerExpiryTimes = 0UL;
+	PRIVILEGED_DATA static BaseType_t xTimerTaskWoke = pdTRUE;
+	PRIVILEGED_DATA static TickType_t xLastExpiryTime = ( TickType_t ) 0U;
+#endif
+
+#if( configUSE_FAST_TIMERS == 1 )
+	/* Active fast timers, in expire time order.  As with the delayed task
+	lists, timers whose expiry time has overflowed are held in a separate list,
+	and the lists are switched when the tick count overflows.  These lists are
+	accessed from the tick interrupt, so only from within critical sections.
+	xNextFastTimerExpiry caches the expiry time of the timer at the head of
+	pxFastTimerList so most ticks do not need to look at the list. */
+	PRIVILEGED_DATA static List_t xFastTimerList1;
+	PRIVILEGED_DATA static List_t xFastTimerList2;
+	PRIVILEGED_DATA static List_t * volatile pxFastTimerList = NULL;
+	PRIVILEGED_DATA static List_t * volatile pxOverflowFastTimerList = NULL;
+	PRIVILEGED_DATA static volatile TickType_t xNextFastTimerExpiry = portMAX_DELAY;
+#endif
 
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -168,11 +283,18 @@ static void prvCheckForValidListAndQueue( void ) PRIVILEGED_FUNCTION;
 static void prvTimerTask( void *pvParameters ) PRIVILEGED_FUNCTION;
 
 /*
- * Called by the timer service task to interpret and process a command it
- * received on the timer queue.
+ * Called by the timer service task to receive the commands waiting on the
+ * timer queue, in batches of up to configTIMER_COMMAND_BATCH_SIZE, and process
+ * them.
  */
 static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Interpret and process a single command received on the timer queue.
+ * xTimeNow is the time sampled after the command was received.
+ */
+static void prvProcessCommand( const DaemonTaskMessage_t * const pxMessage, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
  * depending on if the expire time causes a timer counter overflow.
@@ -185,11 +307,92 @@ static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const Tic
  */
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
+	/*
+	 * The tick count has overflowed.  Switch the timer lists after ensuring the
+	 * current timer list does not still reference some timers.
+	 */
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+#else
+
+	/*
+	 * Add a timer to the wheel using the expiry time already stored in its list
+	 * item.  A timer that expires at xWheelTime is added straight to
+	 * pxCurrentTimerList.
+	 */
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove a timer from whichever wheel slot, or pxCurrentTimerList, it is
+	 * referenced from.
+	 */
+	static void prvRemoveTimerFromWheel( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the number of ticks from xWheelTime to the next time the wheel has
+	 * work to do - either a level 0 slot expiring, or a slot on a higher level
+	 * that must be cascaded.  Must only be called when the wheel holds a timer.
+	 */
+	static TickType_t prvTicksToNextWheelEvent( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move xWheelTime forward to xTimeNow, cascading slots as their start time
+	 * is reached and moving timers that expire on the way to the end of
+	 * pxCurrentTimerList.
+	 */
+	static void prvAdvanceWheel( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
+
+#if( configUSE_FAST_TIMERS == 1 )
+
+	/*
+	 * Apply a command to a fast timer directly, instead of posting it to the
+	 * timer service task.
+	 */
+	static BaseType_t prvFastTimerCommand( Timer_t * const pxTimer, const BaseType_t xCommandID, const TickType_t xOptionalValue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Insert a fast timer into either the current or the overflow fast timer
+	 * list, depending on if its expire time causes a tick count overflow.  Must
+	 * be called from within a critical section.
+	 */
+	static void prvInsertFastTimer( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Set xNextFastTimerExpiry from the head of pxFastTimerList.  Must be called
+	 * from within a critical section.
+	 */
+	static void prvResetNextFastTimerExpiry( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_FAST_TIMERS */
+
+#if( configUSE_TIMER_SLACK == 1 )
+
+	/*
+	 * Return the latest time until which the timer service task can sleep
+	 * without any active timer being processed later than its expiry time plus
+	 * its slack.  Must only be called when there is an active timer.
+	 */
+	static TickType_t prvGetCoalescedWakeTime( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return xTicksToExpiry plus the slack of the timer, saturating at
+	 * portMAX_DELAY.  If xTicksToExpiry is the timer's expiry time measured from
+	 * some earlier reference time, the result is the end of its slack measured
+	 * from the same reference time.
+	 */
+	static TickType_t prvTicksToDeadline( const Timer_t * const pxTimer, const TickType_t xTicksToExpiry ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_SLACK */
+
 /*
- * The tick count has overflowed.  Switch the timer lists after ensuring the
- * current timer list does not still reference some timers.
+ * Free the memory used by a timer that has been deleted, if the memory was
+ * allocated dynamically.
  */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+static void prvFreeTimer( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -286,7 +489,7 @@ BaseType_t xReturn = pdFAIL;
 	{
 	Timer_t *pxNewTimer;
 
-		pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
+		pxNewTimer = ( Timer_t * ) poolMALLOC( eTimerPool, sizeof( Timer_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
 
 		if( pxNewTimer != NULL )
 		{
@@ -377,6 +580,19 @@ static void prvInitialiseNewTimer(	const char * const pcTimerName,			/*lint !e97
 		pxNewTimer->pvTimerID = pvTimerID;
 		pxNewTimer->pxCallbackFunction = pxCallbackFunction;
 		vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
+
+		#if( configUSE_TIMER_SLACK == 1 )
+		{
+			pxNewTimer->xSlackInTicks = ( TickType_t ) 0U;
+		}
+		#endif
+
+		#if( configUSE_FAST_TIMERS == 1 )
+		{
+			pxNewTimer->ucFastTimer = ( uint8_t ) pdFALSE;
+			pxNewTimer->ulMaxCallbackTime = 0UL;
+		}
+		#endif
 		traceTIMER_CREATE( pxNewTimer );
 	}
 }
@@ -389,6 +605,23 @@ DaemonTaskMessage_t xMessage;
 
 	configASSERT( xTimer );
 
+	#if( configUSE_FAST_TIMERS == 1 )
+	{
+		if( ( ( Timer_t * ) xTimer )->ucFastTimer != ( uint8_t ) pdFALSE )
+		{
+			/* Fast timers are updated directly, not by the timer service
+			task. */
+			xReturn = prvFastTimerCommand( xTimer, xCommandID, xOptionalValue );
+			traceTIMER_COMMAND_SEND( xTimer, xCommandID, xOptionalValue, xReturn );
+			return xReturn;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_FAST_TIMERS */
+
 	/* Send a message to the timer service task to perform a particular action
 	on a particular timer definition. */
 	if( xTimerQueue != NULL )
@@ -473,6 +706,30 @@ Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTi
 	( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
 	traceTIMER_EXPIRED( pxTimer );
 
+	#if( configUSE_TIMER_SLACK == 1 )
+	{
+		/* Without slack, the first timer processed after each wakeup, and
+		every timer processed with a different expiry time from the timer
+		before it, would have needed a wakeup of its own. */
+		if( xTimerTaskWoke != pdFALSE )
+		{
+			xTimerTaskWoke = pdFALSE;
+			ulTimerTaskWakeups++;
+			ulTimerExpiryTimes++;
+		}
+		else if( xNextExpireTime != xLastExpiryTime )
+		{
+			ulTimerExpiryTimes++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xLastExpiryTime = xNextExpireTime;
+	}
+	#endif /* configUSE_TIMER_SLACK */
+
 	/* If the timer is an auto reload timer then calculate the next
 	expiry time and re-insert the timer in the list of active timers. */
 	if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
@@ -541,7 +798,7 @@ BaseType_t xListWasEmpty;
 
 static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
 {
-TickType_t xTimeNow;
+TickType_t xTimeNow, xBlockUntil = xNextExpireTime;
 BaseType_t xTimerListsWereSwitched;
 
 	vTaskSuspendAll();
@@ -555,10 +812,32 @@ BaseType_t xTimerListsWereSwitched;
 		if( xTimerListsWereSwitched == pdFALSE )
 		{
 			/* The tick count has not overflowed, has the timer expired? */
-			if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+			if( ( xListWasEmpty == pdFALSE ) && ( tmrTIME_HAS_BEEN_REACHED( xNextExpireTime, xTimeNow ) ) )
 			{
 				( void ) xTaskResumeAll();
-				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+
+				#if( configUSE_TIMER_WHEEL == 1 )
+				{
+					/* xNextExpireTime might only be the time at which a wheel
+					slot needed to be cascaded, so bring the wheel up to date
+					and process the first timer that has actually expired, if
+					any. */
+					prvAdvanceWheel( xTimeNow );
+
+					if( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+					{
+						prvProcessExpiredTimer( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList ), xTimeNow );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#else
+				{
+					prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+				}
+				#endif /* configUSE_TIMER_WHEEL */
 			}
 			else
 			{
@@ -568,14 +847,34 @@ BaseType_t xTimerListsWereSwitched;
 				received - whichever comes first.  The following line cannot
 				be reached unless xNextExpireTime > xTimeNow, except in the
 				case when the current timer list is empty. */
-				if( xListWasEmpty != pdFALSE )
+				#if( configUSE_TIMER_SLACK == 1 )
+				{
+					if( xListWasEmpty == pdFALSE )
+					{
+						/* Sleep for as long as the slack of the active timers
+						allows, so expiries whose windows overlap are handled
+						by a single wakeup. */
+						xBlockUntil = prvGetCoalescedWakeTime();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_TIMER_SLACK */
+
+				#if( configUSE_TIMER_WHEEL == 0 )
 				{
-					/* The current timer list is empty - is the overflow list
-					also empty? */
-					xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					if( xListWasEmpty != pdFALSE )
+					{
+						/* The current timer list is empty - is the overflow
+						list also empty? */
+						xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					}
 				}
+				#endif /* configUSE_TIMER_WHEEL */
 
-				vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+				vQueueWaitForMessageRestricted( xTimerQueue, ( xBlockUntil - xTimeNow ), xListWasEmpty );
 
 				if( xTaskResumeAll() == pdFALSE )
 				{
@@ -589,6 +888,12 @@ BaseType_t xTimerListsWereSwitched;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				#if( configUSE_TIMER_SLACK == 1 )
+				{
+					xTimerTaskWoke = pdTRUE;
+				}
+				#endif
 			}
 		}
 		else
@@ -599,6 +904,40 @@ BaseType_t xTimerListsWereSwitched;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+	{
+	TickType_t xNextExpireTime;
+
+		if( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+		{
+			/* A timer has already been moved out of the wheel because it
+			expired.  xWheelTime cannot be ahead of the tick count, so
+			returning it causes the timer to be processed straight away. */
+			*pxListWasEmpty = pdFALSE;
+			xNextExpireTime = xWheelTime;
+		}
+		else if( uxTimersInWheel != ( UBaseType_t ) 0U )
+		{
+			/* The task must run again when the wheel next has work to do,
+			which may be a cascade rather than a timer expiring. */
+			*pxListWasEmpty = pdFALSE;
+			xNextExpireTime = xWheelTime + prvTicksToNextWheelEvent();
+		}
+		else
+		{
+			/* The wheel does not care about the tick count overflowing, so
+			with no active timers the task can block indefinitely. */
+			*pxListWasEmpty = pdTRUE;
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
+
+		return xNextExpireTime;
+	}
+
+#else /* configUSE_TIMER_WHEEL */
+
 static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
 {
 TickType_t xNextExpireTime;
@@ -623,6 +962,8 @@ TickType_t xNextExpireTime;
 
 	return xNextExpireTime;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
 static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
@@ -632,6 +973,14 @@ PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Va
 
 	xTimeNow = xTaskGetTickCount();
 
+	#if( configUSE_TIMER_WHEEL == 1 )
+	{
+		/* The wheel is not affected by the tick count overflowing, so there
+		are no lists to switch. */
+		( void ) xLastTime;
+		*pxTimerListsWereSwitched = pdFALSE;
+	}
+	#else
 	if( xTimeNow < xLastTime )
 	{
 		prvSwitchTimerLists();
@@ -641,6 +990,7 @@ PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Va
 	{
 		*pxTimerListsWereSwitched = pdFALSE;
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	xLastTime = xTimeNow;
 
@@ -655,6 +1005,26 @@ BaseType_t xProcessTimerNow = pdFALSE;
 	listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
 	listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
+	#if( configUSE_TIMER_WHEEL == 1 )
+	{
+		/* Measured from the command time, the timer has expired if a whole
+		period has passed since the command was issued.  Otherwise its expiry
+		time is between 1 and portMAX_DELAY ticks after xTimeNow, even if the
+		tick count or the expiry time overflowed.  This gives the same result
+		as the list implementation below in every case. */
+		if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		{
+			xProcessTimerNow = pdTRUE;
+		}
+		else
+		{
+			/* Bring the wheel up to date so the timer is placed relative to
+			the current time. */
+			prvAdvanceWheel( xTimeNow );
+			prvInsertTimerInWheel( pxTimer );
+		}
+	}
+	#else /* configUSE_TIMER_WHEEL */
 	if( xNextExpiryTime <= xTimeNow )
 	{
 		/* Has the expiry time elapsed between the command to start/reset a
@@ -684,6 +1054,7 @@ BaseType_t xProcessTimerNow = pdFALSE;
 			vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
 		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xProcessTimerNow;
 }
@@ -691,151 +1062,208 @@ BaseType_t xProcessTimerNow = pdFALSE;
 
 static void	prvProcessReceivedCommands( void )
 {
-DaemonTaskMessage_t xMessage;
-Timer_t *pxTimer;
-BaseType_t xTimerListsWereSwitched, xResult;
+DaemonTaskMessage_t xMessages[ configTIMER_COMMAND_BATCH_SIZE ];
+UBaseType_t uxMessage, uxMessagesReceived;
+BaseType_t xTimerListsWereSwitched;
 TickType_t xTimeNow;
 
-	while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL ) /*lint !e603 xMessage does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
+	for( ;; )
 	{
-		#if ( INCLUDE_xTimerPendFunctionCall == 1 )
+		/* Drain up to configTIMER_COMMAND_BATCH_SIZE commands before
+		processing any of them, so a burst of commands needs only one sample
+		of the time. */
+		for( uxMessagesReceived = ( UBaseType_t ) 0U; uxMessagesReceived < ( UBaseType_t ) configTIMER_COMMAND_BATCH_SIZE; uxMessagesReceived++ )
 		{
-			/* Negative commands are pended function calls rather than timer
-			commands. */
-			if( xMessage.xMessageID < ( BaseType_t ) 0 )
+			if( xQueueReceive( xTimerQueue, &( xMessages[ uxMessagesReceived ] ), tmrNO_DELAY ) == pdFAIL ) /*lint !e603 xMessages does not have to be initialised as it is passed out, not in, and it is not used unless xQueueReceive() returns pdTRUE. */
 			{
-				const CallbackParameters_t * const pxCallback = &( xMessage.u.xCallbackParameters );
-
-				/* The timer uses the xCallbackParameters member to request a
-				callback be executed.  Check the callback is not NULL. */
-				configASSERT( pxCallback );
-
-				/* Call the function. */
-				pxCallback->pxCallbackFunction( pxCallback->pvParameter1, pxCallback->ulParameter2 );
+				break;
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
-		#endif /* INCLUDE_xTimerPendFunctionCall */
 
-		/* Commands that are positive are timer commands rather than pended
-		function calls. */
-		if( xMessage.xMessageID >= ( BaseType_t ) 0 )
+		if( uxMessagesReceived == ( UBaseType_t ) 0U )
+		{
+			break;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* In this case the xTimerListsWereSwitched parameter is not used, but
+		it must be present in the function call.  prvSampleTimeNow() must be
+		called after the messages are received from xTimerQueue so there is no
+		possibility of a higher priority task adding a message to the message
+		queue with a time that is ahead of the timer daemon task (because it
+		pre-empted the timer daemon task after the xTimeNow value was set).
+		Messages sent after this point are left for the next batch. */
+		xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+		for( uxMessage = ( UBaseType_t ) 0U; uxMessage < uxMessagesReceived; uxMessage++ )
+		{
+			prvProcessCommand( &( xMessages[ uxMessage ] ), xTimeNow );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessCommand( const DaemonTaskMessage_t * const pxMessage, const TickType_t xTimeNow )
+{
+Timer_t *pxTimer;
+BaseType_t xResult;
+
+	#if ( INCLUDE_xTimerPendFunctionCall == 1 )
+	{
+		/* Negative commands are pended function calls rather than timer
+		commands. */
+		if( pxMessage->xMessageID < ( BaseType_t ) 0 )
 		{
-			/* The messages uses the xTimerParameters member to work on a
-			software timer. */
-			pxTimer = xMessage.u.xTimerParameters.pxTimer;
+			const CallbackParameters_t * const pxCallback = &( pxMessage->u.xCallbackParameters );
 
-			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+			/* The timer uses the xCallbackParameters member to request a
+			callback be executed.  Check the callback is not NULL. */
+			configASSERT( pxCallback );
+
+			/* Call the function. */
+			pxCallback->pxCallbackFunction( pxCallback->pvParameter1, pxCallback->ulParameter2 );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* INCLUDE_xTimerPendFunctionCall */
+
+	/* Commands that are positive are timer commands rather than pended
+	function calls. */
+	if( pxMessage->xMessageID >= ( BaseType_t ) 0 )
+	{
+		/* The messages uses the xTimerParameters member to work on a
+		software timer. */
+		pxTimer = pxMessage->u.xTimerParameters.pxTimer;
+
+		if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+		{
+			/* The timer is in a list, remove it. */
+			#if( configUSE_TIMER_WHEEL == 1 )
 			{
-				/* The timer is in a list, remove it. */
-				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				prvRemoveTimerFromWheel( pxTimer );
 			}
-			else
+			#else
 			{
-				mtCOVERAGE_TEST_MARKER();
+				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
 			}
+			#endif /* configUSE_TIMER_WHEEL */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-			traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
+		traceTIMER_COMMAND_RECEIVED( pxTimer, pxMessage->xMessageID, pxMessage->u.xTimerParameters.xMessageValue );
 
-			/* In this case the xTimerListsWereSwitched parameter is not used, but
-			it must be present in the function call.  prvSampleTimeNow() must be
-			called after the message is received from xTimerQueue so there is no
-			possibility of a higher priority task adding a message to the message
-			queue with a time that is ahead of the timer daemon task (because it
-			pre-empted the timer daemon task after the xTimeNow value was set). */
-			xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+		switch( pxMessage->xMessageID )
+		{
+			case tmrCOMMAND_START :
+		    case tmrCOMMAND_START_FROM_ISR :
+		    case tmrCOMMAND_RESET :
+		    case tmrCOMMAND_RESET_FROM_ISR :
+			case tmrCOMMAND_START_DONT_TRACE :
+				/* Start or restart a timer. */
+				if( prvInsertTimerInActiveList( pxTimer,  pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, pxMessage->u.xTimerParameters.xMessageValue ) != pdFALSE )
+				{
+					/* The timer expired before it was added to the active
+					timer list.  Process it now. */
+					pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+					traceTIMER_EXPIRED( pxTimer );
 
-			switch( xMessage.xMessageID )
-			{
-				case tmrCOMMAND_START :
-			    case tmrCOMMAND_START_FROM_ISR :
-			    case tmrCOMMAND_RESET :
-			    case tmrCOMMAND_RESET_FROM_ISR :
-				case tmrCOMMAND_START_DONT_TRACE :
-					/* Start or restart a timer. */
-					if( prvInsertTimerInActiveList( pxTimer,  xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
+					if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
 					{
-						/* The timer expired before it was added to the active
-						timer list.  Process it now. */
-						pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-						traceTIMER_EXPIRED( pxTimer );
-
-						if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
-						{
-							xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY );
-							configASSERT( xResult );
-							( void ) xResult;
-						}
-						else
-						{
-							mtCOVERAGE_TEST_MARKER();
-						}
+						xResult = xTimerGenericCommand( pxTimer, tmrCOMMAND_START_DONT_TRACE, pxMessage->u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, NULL, tmrNO_DELAY );
+						configASSERT( xResult );
+						( void ) xResult;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-					break;
-
-				case tmrCOMMAND_STOP :
-				case tmrCOMMAND_STOP_FROM_ISR :
-					/* The timer has already been removed from the active list.
-					There is nothing to do here. */
-					break;
-
-				case tmrCOMMAND_CHANGE_PERIOD :
-				case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
-					pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-					configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
-
-					/* The new period does not really have a reference, and can
-					be longer or shorter than the old one.  The command time is
-					therefore set to the current time, and as the period cannot
-					be zero the next expiry time can only be in the future,
-					meaning (unlike for the xTimerStart() case above) there is
-					no fail case that needs to be handled here. */
-					( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-					break;
-
-				case tmrCOMMAND_DELETE :
-					/* The timer has already been removed from the active list,
-					just free up the memory if the memory was dynamically
-					allocated. */
-					#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
-					{
-						/* The timer can only have been allocated dynamically -
-						free it again. */
-						vPortFree( pxTimer );
-					}
-					#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
-					{
-						/* The timer could have been allocated statically or
-						dynamically, so check before attempting to free the
-						memory. */
-						if( pxTimer->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
-						{
-							vPortFree( pxTimer );
-						}
-						else
-						{
-							mtCOVERAGE_TEST_MARKER();
-						}
-					}
-					#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				break;
+
+			case tmrCOMMAND_STOP :
+			case tmrCOMMAND_STOP_FROM_ISR :
+				/* The timer has already been removed from the active list.
+				There is nothing to do here. */
+				break;
+
+			case tmrCOMMAND_CHANGE_PERIOD :
+			case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
+				pxTimer->xTimerPeriodInTicks = pxMessage->u.xTimerParameters.xMessageValue;
+				configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+				/* The new period does not really have a reference, and can
+				be longer or shorter than the old one.  The command time is
+				therefore set to the current time, and as the period cannot
+				be zero the next expiry time can only be in the future,
+				meaning (unlike for the xTimerStart() case above) there is
+				no fail case that needs to be handled here. */
+				( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+				break;
+
+			case tmrCOMMAND_DELETE :
+				/* The timer has already been removed from the active list,
+				just free up the memory if the memory was dynamically
+				allocated. */
+				prvFreeTimer( pxTimer );
+				break;
+
+			default	:
+				/* Don't expect to get here. */
+				break;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
 
-				default	:
-					/* Don't expect to get here. */
-					break;
-			}
+static void prvFreeTimer( Timer_t * const pxTimer )
+{
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+	{
+		/* The timer can only have been allocated dynamically - free it
+		again. */
+		poolFREE( eTimerPool, pxTimer );
+	}
+	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	{
+		/* The timer could have been allocated statically or dynamically, so
+		check before attempting to free the memory. */
+		if( pxTimer->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			poolFREE( eTimerPool, pxTimer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
 		}
 	}
+	#else
+	{
+		/* Nothing to free. */
+		( void ) pxTimer;
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists( void )
 {
 TickType_t xNextExpireTime, xReloadTime;
@@ -893,63 +1321,290 @@ BaseType_t xResult;
 	pxCurrentTimerList = pxOverflowTimerList;
 	pxOverflowTimerList = pxTemp;
 }
+
+#endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
-static void prvCheckForValidListAndQueue( void )
-{
-	/* Check that the list from which active timers are referenced, and the
-	queue used to communicate with the timer service, have been
-	initialised. */
-	taskENTER_CRITICAL();
-	{
-		if( xTimerQueue == NULL )
-		{
-			vListInitialise( &xActiveTimerList1 );
-			vListInitialise( &xActiveTimerList2 );
-			pxCurrentTimerList = &xActiveTimerList1;
-			pxOverflowTimerList = &xActiveTimerList2;
+#if( configUSE_TIMER_WHEEL == 1 )
 
-			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
-			{
-				/* The timer queue is allocated statically in case
-				configSUPPORT_DYNAMIC_ALLOCATION is 0. */
-				static StaticQueue_t xStaticTimerQueue; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
-				static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer )
+	{
+	const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+	const TickType_t xTicksToExpiry = xExpiryTime - xWheelTime;
+	UBaseType_t uxLevel = ( UBaseType_t ) 0U, uxSlot;
 
-				xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
-			}
-			#else
+		if( xTicksToExpiry == ( TickType_t ) 0U )
+		{
+			/* Only happens when a slot is cascaded at the tick its timer
+			expires.  Timers are moved out of the wheel in expiry order, so
+			the end of the list is the correct position. */
+			vListInsertEnd( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+		}
+		else
+		{
+			/* Find the lowest level on which a single turn of the wheel
+			reaches the expiry time. */
+			while( ( uxLevel < ( UBaseType_t ) ( tmrWHEEL_LEVELS - 1U ) ) && ( ( xTicksToExpiry >> ( ( uxLevel + 1U ) * tmrWHEEL_BITS_PER_LEVEL ) ) != ( TickType_t ) 0U ) )
 			{
-				xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, sizeof( DaemonTaskMessage_t ) );
+				uxLevel++;
 			}
-			#endif
 
-			#if ( configQUEUE_REGISTRY_SIZE > 0 )
+			uxSlot = ( UBaseType_t ) ( xExpiryTime >> ( uxLevel * tmrWHEEL_BITS_PER_LEVEL ) ) & tmrWHEEL_SLOT_MASK;
+
+			#if( configUSE_TIMER_SLACK == 1 )
 			{
-				if( xTimerQueue != NULL )
+				TickType_t xTicksToDeadline = prvTicksToDeadline( pxTimer, xTicksToExpiry );
+
+				/* Deadlines are compared relative to xWheelTime, which
+				cannot pass a deadline while its slot is occupied. */
+				if( ( ( usOccupiedSlots[ uxLevel ] & ( 1U << uxSlot ) ) == 0U ) || ( xTicksToDeadline < ( TickType_t ) ( xSlotDeadlines[ uxLevel ][ uxSlot ] - xWheelTime ) ) )
 				{
-					vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+					xSlotDeadlines[ uxLevel ][ uxSlot ] = xWheelTime + xTicksToDeadline;
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
-			#endif /* configQUEUE_REGISTRY_SIZE */
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
+			#endif /* configUSE_TIMER_SLACK */
+
+			vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+			usOccupiedSlots[ uxLevel ] |= ( uint16_t ) ( 1U << uxSlot );
+			uxTimersInWheel++;
 		}
 	}
-	taskEXIT_CRITICAL();
-}
-/*-----------------------------------------------------------*/
+	/*-----------------------------------------------------------*/
 
-BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer )
-{
-BaseType_t xTimerIsInActiveList;
-Timer_t *pxTimer = xTimer;
+	static void prvRemoveTimerFromWheel( Timer_t * const pxTimer )
+	{
+	List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+	UBaseType_t uxIndex;
+
+		( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+		if( pxList != pxCurrentTimerList )
+		{
+			uxTimersInWheel--;
+
+			if( listLIST_IS_EMPTY( pxList ) != pdFALSE )
+			{
+				/* Work out which slot the list is from its position in the
+				wheel so its occupied bit can be cleared. */
+				uxIndex = ( UBaseType_t ) ( pxList - &( xTimerWheel[ 0 ][ 0 ] ) );
+				usOccupiedSlots[ uxIndex / tmrWHEEL_SLOTS ] &= ( uint16_t ) ~( 1U << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvTicksToNextWheelEvent( void )
+	{
+	TickType_t xTicks, xNearest = portMAX_DELAY;
+	UBaseType_t uxLevel, uxShift, uxCurrentSlot, uxDistance;
+
+		configASSERT( uxTimersInWheel != ( UBaseType_t ) 0U );
+
+		for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS; uxLevel++ )
+		{
+			if( usOccupiedSlots[ uxLevel ] != ( uint16_t ) 0U )
+			{
+				uxShift = uxLevel * tmrWHEEL_BITS_PER_LEVEL;
+				uxCurrentSlot = ( UBaseType_t ) ( xWheelTime >> uxShift ) & tmrWHEEL_SLOT_MASK;
+
+				/* Find the nearest occupied slot after the current slot.  The
+				current slot itself is only reached again after a full turn -
+				a level 0 slot is emptied as soon as it becomes current, and a
+				higher level slot is cascaded as soon as it becomes current, so
+				any timer in it was added later and belongs to the next
+				turn. */
+				for( uxDistance = ( UBaseType_t ) 1U; uxDistance < tmrWHEEL_SLOTS; uxDistance++ )
+				{
+					if( ( usOccupiedSlots[ uxLevel ] & ( 1U << ( ( uxCurrentSlot + uxDistance ) & tmrWHEEL_SLOT_MASK ) ) ) != 0U )
+					{
+						break;
+					}
+				}
+
+				/* The slot is reached when xWheelTime gets to the start of
+				the span of ticks it covers.  The subtraction can wrap for the
+				top level, but the true result always fits in a TickType_t as
+				no timer is more than portMAX_DELAY ticks away. */
+				xTicks = ( ( TickType_t ) uxDistance << uxShift ) - ( xWheelTime & ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) );
+
+				if( xTicks < xNearest )
+				{
+					xNearest = xTicks;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xNearest;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvAdvanceWheel( const TickType_t xTimeNow )
+	{
+	TickType_t xTicks;
+	UBaseType_t uxLevel, uxShift;
+	List_t *pxSlot;
+	Timer_t *pxTimer;
+
+		while( xWheelTime != xTimeNow )
+		{
+			if( uxTimersInWheel == ( UBaseType_t ) 0U )
+			{
+				/* Nothing to do on the way, so jump straight to the time
+				now. */
+				xWheelTime = xTimeNow;
+				break;
+			}
+
+			/* Skip over the ticks at which the wheel has nothing to do. */
+			xTicks = prvTicksToNextWheelEvent();
+
+			if( xTicks > ( TickType_t ) ( xTimeNow - xWheelTime ) )
+			{
+				xWheelTime = xTimeNow;
+				break;
+			}
+
+			xWheelTime += xTicks;
+
+			/* Cascade the slots whose span starts at the new time, lowest
+			level first, so a timer cascaded from a higher level never lands
+			in a slot that has already been cascaded on this tick unless it
+			really belongs to that slot's next turn. */
+			for( uxLevel = ( UBaseType_t ) 1U; uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS; uxLevel++ )
+			{
+				uxShift = uxLevel * tmrWHEEL_BITS_PER_LEVEL;
+
+				if( ( xWheelTime & ( ( ( TickType_t ) 1U << uxShift ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+				{
+					break;
+				}
+
+				pxSlot = &( xTimerWheel[ uxLevel ][ ( UBaseType_t ) ( xWheelTime >> uxShift ) & tmrWHEEL_SLOT_MASK ] );
+
+				while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+				{
+					pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					prvRemoveTimerFromWheel( pxTimer );
+					prvInsertTimerInWheel( pxTimer );
+				}
+			}
+
+			/* Every timer in the level 0 slot for the new time has expired. */
+			pxSlot = &( xTimerWheel[ 0 ][ ( UBaseType_t ) xWheelTime & tmrWHEEL_SLOT_MASK ] );
+
+			while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+			{
+				pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				prvRemoveTimerFromWheel( pxTimer );
+				vListInsertEnd( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			}
+		}
+	}
+
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
+static void prvCheckForValidListAndQueue( void )
+{
+	/* Check that the list from which active timers are referenced, and the
+	queue used to communicate with the timer service, have been
+	initialised. */
+	taskENTER_CRITICAL();
+	{
+		if( xTimerQueue == NULL )
+		{
+			vListInitialise( &xActiveTimerList1 );
+			pxCurrentTimerList = &xActiveTimerList1;
+
+			#if( configUSE_FAST_TIMERS == 1 )
+			{
+				vListInitialise( &xFastTimerList1 );
+				vListInitialise( &xFastTimerList2 );
+				pxOverflowFastTimerList = &xFastTimerList2;
+				pxFastTimerList = &xFastTimerList1;
+			}
+			#endif /* configUSE_FAST_TIMERS */
+
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+				UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS; uxLevel++ )
+				{
+					for( uxSlot = ( UBaseType_t ) 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+					{
+						vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+					}
+				}
+			}
+			#else
+			{
+				vListInitialise( &xActiveTimerList2 );
+				pxOverflowTimerList = &xActiveTimerList2;
+			}
+			#endif /* configUSE_TIMER_WHEEL */
+
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				/* The timer queue is allocated statically in case
+				configSUPPORT_DYNAMIC_ALLOCATION is 0. */
+				static StaticQueue_t xStaticTimerQueue; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+				static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+
+				xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
+			}
+			#else
+			{
+				xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, sizeof( DaemonTaskMessage_t ) );
+			}
+			#endif
+
+			#if ( configQUEUE_REGISTRY_SIZE > 0 )
+			{
+				if( xTimerQueue != NULL )
+				{
+					vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configQUEUE_REGISTRY_SIZE */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer )
+{
+BaseType_t xTimerIsInActiveList;
+Timer_t *pxTimer = xTimer;
 
 	configASSERT( xTimer );
 
@@ -1078,6 +1733,411 @@ Timer_t * const pxTimer = xTimer;
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_SLACK == 1 )
+
+	void vTimerSetSlack( TimerHandle_t xTimer, TickType_t xSlackInTicks )
+	{
+	Timer_t * const pxTimer = xTimer;
+
+		configASSERT( xTimer );
+
+		taskENTER_CRITICAL();
+		{
+			pxTimer->xSlackInTicks = xSlackInTicks;
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	TickType_t xTimerGetSlack( TimerHandle_t xTimer )
+	{
+	Timer_t * const pxTimer = xTimer;
+
+		configASSERT( xTimer );
+		return pxTimer->xSlackInTicks;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTimerGetCoalescingStats( TimerCoalescingStats_t *pxStats )
+	{
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
+		{
+			pxStats->ulWakeups = ulTimerTaskWakeups;
+			pxStats->ulExpiryTimes = ulTimerExpiryTimes;
+		}
+		taskEXIT_CRITICAL();
+
+		pxStats->ulWakeupsSaved = pxStats->ulExpiryTimes - pxStats->ulWakeups;
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvTicksToDeadline( const Timer_t * const pxTimer, const TickType_t xTicksToExpiry )
+	{
+	TickType_t xTicksToDeadline;
+
+		if( pxTimer->xSlackInTicks > ( portMAX_DELAY - xTicksToExpiry ) )
+		{
+			xTicksToDeadline = portMAX_DELAY;
+		}
+		else
+		{
+			xTicksToDeadline = xTicksToExpiry + pxTimer->xSlackInTicks;
+		}
+
+		return xTicksToDeadline;
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( configUSE_TIMER_WHEEL == 1 )
+
+		static TickType_t prvGetCoalescedWakeTime( void )
+		{
+		TickType_t xTicks, xNearest = portMAX_DELAY;
+		UBaseType_t uxLevel, uxSlot;
+
+			/* No timer in a slot may be processed after the slot's
+			deadline, so the earliest deadline of all the occupied slots is the
+			latest the task can sleep until. */
+			for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) tmrWHEEL_LEVELS; uxLevel++ )
+			{
+				for( uxSlot = ( UBaseType_t ) 0U; ( usOccupiedSlots[ uxLevel ] >> uxSlot ) != 0U; uxSlot++ )
+				{
+					if( ( usOccupiedSlots[ uxLevel ] & ( 1U << uxSlot ) ) != 0U )
+					{
+						xTicks = xSlotDeadlines[ uxLevel ][ uxSlot ] - xWheelTime;
+
+						if( xTicks < xNearest )
+						{
+							xNearest = xTicks;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+
+			return xWheelTime + xNearest;
+		}
+
+	#else /* configUSE_TIMER_WHEEL */
+
+		static TickType_t prvGetCoalescedWakeTime( void )
+		{
+		TickType_t xWakeTime = portMAX_DELAY, xExpiryTime, xDeadline;
+		ListItem_t const *pxItem;
+		ListItem_t const * const pxEnd = listGET_END_MARKER( pxCurrentTimerList );
+
+			/* Timers are listed in expiry time order, so once a timer is
+			found that expires after the wake time found so far, no timer
+			after it can bring the wake time forward.  The walk is therefore
+			limited to the timers that will be processed when the task
+			wakes.  Deadlines that would overflow are limited to
+			portMAX_DELAY, after which the lists are switched anyway. */
+			for( pxItem = listGET_HEAD_ENTRY( pxCurrentTimerList ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) )
+			{
+				xExpiryTime = listGET_LIST_ITEM_VALUE( pxItem );
+
+				if( xExpiryTime > xWakeTime )
+				{
+					break;
+				}
+
+				/* Times in the current list do not overflow, so they can be
+				measured from zero. */
+				xDeadline = prvTicksToDeadline( ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ), xExpiryTime ); /*lint !e9087 !e9079 The owner of a timer list item is always a timer. */
+
+				if( xDeadline < xWakeTime )
+				{
+					xWakeTime = xDeadline;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			return xWakeTime;
+		}
+
+	#endif /* configUSE_TIMER_WHEEL */
+
+#endif /* configUSE_TIMER_SLACK */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_STATS == 1 )
+
+	void vTimerGetCommandQueueStats( QueueStats_t *pxQueueStats )
+	{
+		/* The queue is created when the timer service task is created. */
+		configASSERT( xTimerQueue );
+		vQueueGetStats( xTimerQueue, pxQueueStats );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTimerResetCommandQueueStats( void )
+	{
+		configASSERT( xTimerQueue );
+		vQueueResetStats( xTimerQueue );
+	}
+
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FAST_TIMERS == 1 )
+
+	TimerHandle_t xTimerEnableFast( TimerHandle_t xTimer )
+	{
+	Timer_t * const pxTimer = xTimer;
+
+		if( pxTimer != NULL )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Commands already sent to the timer service task would be
+				processed after the timer had become a fast timer, so the timer
+				must not have been started. */
+				configASSERT( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) != pdFALSE );
+				pxTimer->ucFastTimer = ( uint8_t ) pdTRUE;
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xTimer;
+	}
+	/*-----------------------------------------------------------*/
+
+	uint32_t ulTimerGetMaxCallbackTime( TimerHandle_t xTimer )
+	{
+	Timer_t * const pxTimer = xTimer;
+
+		configASSERT( xTimer );
+		return pxTimer->ulMaxCallbackTime;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvFastTimerCommand( Timer_t * const pxTimer, const BaseType_t xCommandID, const TickType_t xOptionalValue )
+	{
+	UBaseType_t uxSavedInterruptStatus = 0U;
+	TickType_t xTimeNow;
+
+		if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+		{
+			taskENTER_CRITICAL();
+		}
+		else
+		{
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		}
+
+		{
+			/* The tick interrupt cannot change the tick count or the fast
+			timer lists while in the critical section. */
+			xTimeNow = xTaskGetTickCountFromISR();
+
+			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+			{
+				/* The timer is in a list, remove it. */
+				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			switch( xCommandID )
+			{
+				case tmrCOMMAND_START :
+				case tmrCOMMAND_START_FROM_ISR :
+				case tmrCOMMAND_RESET :
+				case tmrCOMMAND_RESET_FROM_ISR :
+				case tmrCOMMAND_START_DONT_TRACE :
+					/* xOptionalValue is the tick count when the command was
+					issued.  If a tick has occurred since, a whole period may
+					already have passed, in which case the callback is executed
+					on the next tick, as it cannot be executed from here. */
+					if( ( ( TickType_t ) ( xTimeNow - xOptionalValue ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+					{
+						prvInsertFastTimer( pxTimer, xTimeNow + ( TickType_t ) 1U, xTimeNow );
+					}
+					else
+					{
+						prvInsertFastTimer( pxTimer, xOptionalValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+					}
+					break;
+
+				case tmrCOMMAND_STOP :
+				case tmrCOMMAND_STOP_FROM_ISR :
+					/* The timer has already been removed from the active list.
+					There is nothing to do here. */
+					break;
+
+				case tmrCOMMAND_CHANGE_PERIOD :
+				case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR :
+					pxTimer->xTimerPeriodInTicks = xOptionalValue;
+					configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+					prvInsertFastTimer( pxTimer, xTimeNow + pxTimer->xTimerPeriodInTicks, xTimeNow );
+					break;
+
+				default :
+					/* tmrCOMMAND_DELETE.  The timer has already been removed
+					from the active list, and is freed below. */
+					break;
+			}
+
+			/* The timer may have been added or removed at the head of the
+			list. */
+			prvResetNextFastTimerExpiry();
+		}
+
+		if( xCommandID < tmrFIRST_FROM_ISR_COMMAND )
+		{
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+
+		if( xCommandID == tmrCOMMAND_DELETE )
+		{
+			prvFreeTimer( pxTimer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvInsertFastTimer( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow )
+	{
+		listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+		listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+		/* The expiry time is always in the future, so if it is below the time
+		now it has overflowed. */
+		if( xNextExpiryTime < xTimeNow )
+		{
+			vListInsert( pxOverflowFastTimerList, &( pxTimer->xTimerListItem ) );
+		}
+		else
+		{
+			vListInsert( pxFastTimerList, &( pxTimer->xTimerListItem ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetNextFastTimerExpiry( void )
+	{
+		if( listLIST_IS_EMPTY( pxFastTimerList ) != pdFALSE )
+		{
+			xNextFastTimerExpiry = portMAX_DELAY;
+		}
+		else
+		{
+			xNextFastTimerExpiry = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxFastTimerList );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTimerProcessFastTimers( const TickType_t xTickCount )
+	{
+	Timer_t *pxTimer;
+	List_t *pxTemp;
+	TickType_t xExpiryTime;
+	uint32_t ulStartTime, ulCallbackTime;
+
+		/* The lists do not exist until the first timer is created. */
+		if( pxFastTimerList != NULL )
+		{
+			if( xTickCount == ( TickType_t ) 0U )
+			{
+				/* The tick count has overflowed.  Every timer in the current
+				list expired on or before the previous tick, so the list must
+				be empty. */
+				configASSERT( listLIST_IS_EMPTY( pxFastTimerList ) );
+				pxTemp = pxFastTimerList;
+				pxFastTimerList = pxOverflowFastTimerList;
+				pxOverflowFastTimerList = pxTemp;
+				prvResetNextFastTimerExpiry();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Timers are in expiry time order, so once a timer is found that
+			has not expired there is no need to look any further. */
+			while( xTickCount >= xNextFastTimerExpiry )
+			{
+				if( listLIST_IS_EMPTY( pxFastTimerList ) != pdFALSE )
+				{
+					xNextFastTimerExpiry = portMAX_DELAY;
+					break;
+				}
+
+				pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxFastTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+
+				if( xTickCount < xExpiryTime )
+				{
+					xNextFastTimerExpiry = xExpiryTime;
+					break;
+				}
+
+				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+				traceTIMER_EXPIRED( pxTimer );
+
+				/* Reload relative to the expiry time, not the time now, so
+				an auto reload timer does not drift. */
+				if( pxTimer->uxAutoReload == ( UBaseType_t ) pdTRUE )
+				{
+					prvInsertFastTimer( pxTimer, xExpiryTime + pxTimer->xTimerPeriodInTicks, xTickCount );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The callback may itself start or stop fast timers, so the
+				head of the list is read again on each iteration. */
+				ulStartTime = tmrGET_CALLBACK_TIMESTAMP();
+				pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+				ulCallbackTime = tmrGET_CALLBACK_TIMESTAMP() - ulStartTime;
+
+				if( ulCallbackTime > pxTimer->ulMaxCallbackTime )
+				{
+					pxTimer->ulMaxCallbackTime = ulCallbackTime;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_FAST_TIMERS */
+/*-----------------------------------------------------------*/
+
 /* This entire source file will be skipped if the application is not configured
 to include software timer functionality.  If you want to include software timer
 functionality then ensure configUSE_TIMERS is set to 1 in FreeRTOSConfig.h. */
@@ -0,0 +1,471 @@
+/*
+ * Topic bus - publish/subscribe fan-out built on top of the FreeRTOS kernel.
+ * See topic_bus.h for a description of the behaviour.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "topic_bus.h"
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build topic_bus.c
+#endif
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to build topic_bus.c
+#endif
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* The time base used to measure how long items stay in a topic.  The run time
+stats counter gives a finer resolution than the tick count, but is only
+configured when run time stats are being gathered. */
+#ifndef topicGET_TIMESTAMP
+	#if( configGENERATE_RUN_TIME_STATS == 1 )
+		#define topicGET_TIMESTAMP()			( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+		#define topicGET_TIMESTAMP_FROM_ISR()	( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+	#else
+		#define topicGET_TIMESTAMP()			( ( uint32_t ) xTaskGetTickCount() )
+		#define topicGET_TIMESTAMP_FROM_ISR()	( ( uint32_t ) xTaskGetTickCountFromISR() )
+	#endif
+#endif /* topicGET_TIMESTAMP */
+
+/* The slot of the ring that holds the item with sequence number ulSequence.
+The ring length is a power of two, so the mapping stays continuous when the
+free running sequence numbers wrap. */
+#define topicSLOT( pxTopic, ulSequence )	( ( UBaseType_t ) ( ( ulSequence ) & ( ( uint32_t ) ( pxTopic )->uxLength - 1UL ) ) )
+
+/* Evaluates to pdTRUE if uxLength is a power of two. */
+#define topicIS_POWER_OF_TWO( uxLength )	( ( ( uxLength ) & ( ( uxLength ) - ( UBaseType_t ) 1 ) ) == ( UBaseType_t ) 0 )
+
+/*-----------------------------------------------------------*/
+
+/* State held for each subscription to a topic. */
+typedef struct TopicSubscriberDefinition
+{
+	struct TopicDefinition *pxTopic;					/* The topic subscribed to. */
+	struct TopicSubscriberDefinition *pxNext;			/* The next subscriber to the same topic, or NULL. */
+	volatile TaskHandle_t xTaskWaitingToReceive;		/* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
+	uint32_t ulReadSequence;							/* Sequence number of the next item this subscriber will read. */
+	uint32_t ulDelivered;
+	uint32_t ulOverruns;
+	uint32_t ulMaxLatency;
+	uint32_t ulTotalLatency;
+} TopicSubscriber_t;
+
+/* State held for each topic.  The publish timestamps and the ring of items
+follow the structure in the same allocation. */
+typedef struct TopicDefinition
+{
+	UBaseType_t uxLength;						/* The number of items the ring can hold. */
+	UBaseType_t uxItemSize;						/* The size of each item in bytes. */
+	volatile uint32_t ulWriteSequence;			/* Sequence number the next published item will be given.  Also the number of items published. */
+	uint32_t *pulTimestamps;					/* The time at which the item in each slot of the ring was published. */
+	uint8_t *pucItems;							/* The ring of items. */
+	TopicSubscriber_t *pxSubscribers;			/* Singly linked list of the subscribers to the topic. */
+	UBaseType_t uxSubscribers;
+	uint32_t ulDelivered;						/* Totals across all subscribers, including past subscribers. */
+	uint32_t ulOverruns;
+	uint32_t ulMaxLatency;
+	uint32_t ulTotalLatency;
+} Topic_t;
+
+/*
+ * Copies an item into the next slot of the ring.  Must be called from a
+ * critical section.
+ */
+static void prvWriteItemToTopic( Topic_t * const pxTopic, const void *pvItem, uint32_t ulTimestamp ) PRIVILEGED_FUNCTION;
+
+/*
+ * If the subscriber has an unread item then copies it to pvBuffer, updates the
+ * counters and returns pdPASS, otherwise returns pdFAIL.  Must be called from a
+ * critical section.
+ */
+static BaseType_t prvReadItemFromTopic( TopicSubscriber_t * const pxSubscriber, void *pvBuffer, uint32_t ulTimestamp ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+TopicHandle_t xTopicCreate( UBaseType_t uxTopicLength, UBaseType_t uxItemSize )
+{
+Topic_t *pxTopic;
+uint8_t *pucAllocatedMemory = NULL;
+
+	configASSERT( uxTopicLength > ( UBaseType_t ) 0 );
+	configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+	/* The sequence numbers are free running, so the distance between the
+	publisher and a subscriber can only be determined if the ring is shorter
+	than half the sequence number range. */
+	configASSERT( uxTopicLength < ( UBaseType_t ) 0x7fffffffUL );
+
+	/* Sequence numbers are mapped to slots by masking, which only gives the
+	same slot either side of the sequence numbers wrapping if the length of the
+	ring is a power of two. */
+	configASSERT( topicIS_POWER_OF_TWO( uxTopicLength ) );
+
+	if( topicIS_POWER_OF_TWO( uxTopicLength ) != pdFALSE )
+	{
+		/* The Topic_t structure, the timestamps and the ring of items are
+		allocated in a single call to pvPortMalloc(). */
+		pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( sizeof( Topic_t ) + ( uxTopicLength * sizeof( uint32_t ) ) + ( uxTopicLength * uxItemSize ) ); /*lint !e9079 malloc() only returns void*. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pucAllocatedMemory != NULL )
+	{
+		pxTopic = ( Topic_t * ) pucAllocatedMemory; /*lint !e9087 Safe cast as allocated memory is aligned. */
+		( void ) memset( ( void * ) pxTopic, 0x00, sizeof( Topic_t ) );
+
+		pxTopic->uxLength = uxTopicLength;
+		pxTopic->uxItemSize = uxItemSize;
+		pxTopic->pulTimestamps = ( uint32_t * ) ( pucAllocatedMemory + sizeof( Topic_t ) ); /*lint !e9087 !e9016 Safe as the structure size keeps the array aligned. */
+		pxTopic->pucItems = pucAllocatedMemory + sizeof( Topic_t ) + ( uxTopicLength * sizeof( uint32_t ) ); /*lint !e9016 Pointer arithmetic allowed on char types. */
+	}
+	else
+	{
+		pxTopic = NULL;
+	}
+
+	return pxTopic;
+}
+/*-----------------------------------------------------------*/
+
+void vTopicDelete( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = xTopic;
+
+	configASSERT( pxTopic );
+	configASSERT( pxTopic->pxSubscribers == NULL );
+
+	vPortFree( ( void * ) pxTopic );
+}
+/*-----------------------------------------------------------*/
+
+TopicSubscriberHandle_t xTopicSubscribe( TopicHandle_t xTopic )
+{
+Topic_t * const pxTopic = xTopic;
+TopicSubscriber_t *pxSubscriber;
+
+	configASSERT( pxTopic );
+
+	pxSubscriber = ( TopicSubscriber_t * ) pvPortMalloc( sizeof( TopicSubscriber_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+	if( pxSubscriber != NULL )
+	{
+		( void ) memset( ( void * ) pxSubscriber, 0x00, sizeof( TopicSubscriber_t ) );
+		pxSubscriber->pxTopic = pxTopic;
+
+		taskENTER_CRITICAL();
+		{
+			/* Only items published from now on are delivered. */
+			pxSubscriber->ulReadSequence = pxTopic->ulWriteSequence;
+			pxSubscriber->pxNext = pxTopic->pxSubscribers;
+			pxTopic->pxSubscribers = pxSubscriber;
+			( pxTopic->uxSubscribers )++;
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxSubscriber;
+}
+/*-----------------------------------------------------------*/
+
+void vTopicUnsubscribe( TopicSubscriberHandle_t xSubscriber )
+{
+TopicSubscriber_t * const pxSubscriber = xSubscriber;
+Topic_t *pxTopic;
+TopicSubscriber_t **ppxLink;
+
+	configASSERT( pxSubscriber );
+	configASSERT( pxSubscriber->xTaskWaitingToReceive == NULL );
+
+	pxTopic = pxSubscriber->pxTopic;
+
+	/* The publisher walks the subscriber list with the scheduler suspended,
+	so the list is modified with the scheduler suspended too. */
+	vTaskSuspendAll();
+	{
+		taskENTER_CRITICAL();
+		{
+			for( ppxLink = &( pxTopic->pxSubscribers ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNext ) )
+			{
+				if( *ppxLink == pxSubscriber )
+				{
+					*ppxLink = pxSubscriber->pxNext;
+					( pxTopic->uxSubscribers )--;
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	( void ) xTaskResumeAll();
+
+	vPortFree( ( void * ) pxSubscriber );
+}
+/*-----------------------------------------------------------*/
+
+void vTopicPublish( TopicHandle_t xTopic, const void *pvItem )
+{
+Topic_t * const pxTopic = xTopic;
+TopicSubscriber_t *pxSubscriber;
+TaskHandle_t xTaskToNotify;
+
+	configASSERT( pxTopic );
+	configASSERT( pvItem );
+
+	vTaskSuspendAll();
+	{
+		taskENTER_CRITICAL();
+		{
+			prvWriteItemToTopic( pxTopic, pvItem, topicGET_TIMESTAMP() );
+		}
+		taskEXIT_CRITICAL();
+
+		/* The item was only written once, but every subscriber that is
+		blocked waiting for data has to be woken. */
+		for( pxSubscriber = pxTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+		{
+			/* vTopicPublishFromISR() can wake the subscriber and clear the
+			handle at any time, so take the handle in a critical section. */
+			taskENTER_CRITICAL();
+			{
+				xTaskToNotify = pxSubscriber->xTaskWaitingToReceive;
+				pxSubscriber->xTaskWaitingToReceive = NULL;
+			}
+			taskEXIT_CRITICAL();
+
+			if( xTaskToNotify != NULL )
+			{
+				( void ) xTaskNotify( xTaskToNotify, ( uint32_t ) 0, eNoAction );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vTopicPublishFromISR( TopicHandle_t xTopic, const void *pvItem, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+Topic_t * const pxTopic = xTopic;
+TopicSubscriber_t *pxSubscriber;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxTopic );
+	configASSERT( pvItem );
+
+	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		prvWriteItemToTopic( pxTopic, pvItem, topicGET_TIMESTAMP_FROM_ISR() );
+
+		for( pxSubscriber = pxTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+		{
+			if( pxSubscriber->xTaskWaitingToReceive != NULL )
+			{
+				( void ) xTaskNotifyFromISR( pxSubscriber->xTaskWaitingToReceive, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+				pxSubscriber->xTaskWaitingToReceive = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicReceive( TopicSubscriberHandle_t xSubscriber, void *pvBuffer, TickType_t xTicksToWait )
+{
+TopicSubscriber_t * const pxSubscriber = xSubscriber;
+BaseType_t xReturn;
+
+	configASSERT( pxSubscriber );
+	configASSERT( pvBuffer );
+
+	/* Checking for data and, if there is none, clearing the notification
+	state must be performed atomically so a publish that happens before the
+	task blocks is not missed. */
+	taskENTER_CRITICAL();
+	{
+		xReturn = prvReadItemFromTopic( pxSubscriber, pvBuffer, topicGET_TIMESTAMP() );
+
+		if( ( xReturn == pdFAIL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+		{
+			( void ) xTaskNotifyStateClear( NULL );
+
+			/* Only one task should read through a subscription. */
+			configASSERT( pxSubscriber->xTaskWaitingToReceive == NULL );
+			pxSubscriber->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( ( xReturn == pdFAIL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		/* Wait for an item to be published. */
+		( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+		pxSubscriber->xTaskWaitingToReceive = NULL;
+
+		/* Recheck for data after blocking. */
+		taskENTER_CRITICAL();
+		{
+			xReturn = prvReadItemFromTopic( pxSubscriber, pvBuffer, topicGET_TIMESTAMP() );
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTopicGetInfo( TopicHandle_t xTopic, TopicStatus_t *pxTopicStatus )
+{
+Topic_t * const pxTopic = xTopic;
+
+	configASSERT( pxTopic );
+	configASSERT( pxTopicStatus );
+
+	taskENTER_CRITICAL();
+	{
+		pxTopicStatus->ulPublished = pxTopic->ulWriteSequence;
+		pxTopicStatus->ulDelivered = pxTopic->ulDelivered;
+		pxTopicStatus->ulOverruns = pxTopic->ulOverruns;
+		pxTopicStatus->ulMaxLatency = pxTopic->ulMaxLatency;
+		pxTopicStatus->ulTotalLatency = pxTopic->ulTotalLatency;
+		pxTopicStatus->uxSubscribers = pxTopic->uxSubscribers;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTopicGetSubscriberInfo( TopicSubscriberHandle_t xSubscriber, TopicStatus_t *pxTopicStatus )
+{
+TopicSubscriber_t * const pxSubscriber = xSubscriber;
+
+	configASSERT( pxSubscriber );
+	configASSERT( pxTopicStatus );
+
+	taskENTER_CRITICAL();
+	{
+		pxTopicStatus->ulPublished = 0;
+		pxTopicStatus->ulDelivered = pxSubscriber->ulDelivered;
+		pxTopicStatus->ulOverruns = pxSubscriber->ulOverruns;
+		pxTopicStatus->ulMaxLatency = pxSubscriber->ulMaxLatency;
+		pxTopicStatus->ulTotalLatency = pxSubscriber->ulTotalLatency;
+		pxTopicStatus->uxSubscribers = 0;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteItemToTopic( Topic_t * const pxTopic, const void *pvItem, uint32_t ulTimestamp )
+{
+UBaseType_t uxSlot;
+
+	uxSlot = topicSLOT( pxTopic, pxTopic->ulWriteSequence );
+
+	( void ) memcpy( ( void * ) &( pxTopic->pucItems[ uxSlot * pxTopic->uxItemSize ] ), pvItem, ( size_t ) pxTopic->uxItemSize ); /*lint !e9087 memcpy() requires void *. */
+	pxTopic->pulTimestamps[ uxSlot ] = ulTimestamp;
+
+	/* The sequence number is only advanced once the slot is complete. */
+	( pxTopic->ulWriteSequence )++;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadItemFromTopic( TopicSubscriber_t * const pxSubscriber, void *pvBuffer, uint32_t ulTimestamp )
+{
+Topic_t * const pxTopic = pxSubscriber->pxTopic;
+uint32_t ulUnread, ulLatency, ulMissed;
+UBaseType_t uxSlot;
+BaseType_t xReturn;
+
+	ulUnread = pxTopic->ulWriteSequence - pxSubscriber->ulReadSequence;
+
+	if( ulUnread > ( uint32_t ) pxTopic->uxLength )
+	{
+		/* The ring wrapped past this subscriber's cursor.  Skip forward to
+		the oldest item still in the ring and record what was lost. */
+		ulMissed = ulUnread - ( uint32_t ) pxTopic->uxLength;
+		pxSubscriber->ulOverruns += ulMissed;
+		pxTopic->ulOverruns += ulMissed;
+		pxSubscriber->ulReadSequence += ulMissed;
+		ulUnread = ( uint32_t ) pxTopic->uxLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( ulUnread > ( uint32_t ) 0 )
+	{
+		uxSlot = topicSLOT( pxTopic, pxSubscriber->ulReadSequence );
+		( void ) memcpy( pvBuffer, ( const void * ) &( pxTopic->pucItems[ uxSlot * pxTopic->uxItemSize ] ), ( size_t ) pxTopic->uxItemSize ); /*lint !e9087 memcpy() requires void *. */
+		( pxSubscriber->ulReadSequence )++;
+
+		ulLatency = ulTimestamp - pxTopic->pulTimestamps[ uxSlot ];
+
+		( pxSubscriber->ulDelivered )++;
+		pxSubscriber->ulTotalLatency += ulLatency;
+		if( ulLatency > pxSubscriber->ulMaxLatency )
+		{
+			pxSubscriber->ulMaxLatency = ulLatency;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		( pxTopic->ulDelivered )++;
+		pxTopic->ulTotalLatency += ulLatency;
+		if( ulLatency > pxTopic->ulMaxLatency )
+		{
+			pxTopic->ulMaxLatency = ulLatency;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}